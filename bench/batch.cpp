@@ -0,0 +1,91 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// `calculate` with a `clmul_engine`, one message at a time, against
+// `calculate_batch`, over 4096 messages of random lengths up to 4 KB.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "indi/crc-simd.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto messages = std::size_t{4096u};
+
+auto run(std::size_t min_length, std::size_t max_length) -> void
+{
+	auto engine = std::mt19937{24680u};
+	auto dist = std::uniform_int_distribution<std::size_t>{min_length,
+		max_length};
+	
+	auto lengths = std::vector<std::size_t>(messages);
+	auto offsets = std::vector<std::size_t>(messages);
+	auto size = std::size_t{0};
+	for (auto n = std::size_t{0}; n < messages; ++n)
+	{
+		lengths[n] = dist(engine);
+		offsets[n] = size;
+		size += lengths[n];
+	}
+	
+	auto const data = random_bytes(size);
+	auto frames = std::vector<std::vector<unsigned char>>{};
+	for (auto n = std::size_t{0}; n < messages; ++n)
+		frames.emplace_back(data.begin() + offsets[n],
+			data.begin() + offsets[n] + lengths[n]);
+	
+	auto const crc32c = clmul_engine<32>{polynomials::crc32c};
+	auto crcs = std::vector<std::uint_fast32_t>(messages);
+	
+	report("single", size, median_ns([&]
+	{
+		for (auto n = std::size_t{0}; n < messages; ++n)
+			crcs[n] = calculate<32>(frames[n], crc32c);
+		keep(crcs);
+	}, 9u));
+	
+	report("batch", size, median_ns([&]
+	{
+		calculate_batch<32>(frames, crcs.begin(), crc32c);
+		keep(crcs);
+	}, 9u));
+}
+
+} // anonymous namespace
+
+auto batch() -> void
+{
+	std::size_t const ranges[][2] = {{64u, 256u}, {64u, 1024u},
+		{64u, 4096u}, {1024u, 4095u}};
+	for (auto const& range : ranges)
+	{
+		std::printf("  CRC-32C, %zu to %zu B:\n", range[0], range[1]);
+		run(range[0], range[1]);
+	}
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
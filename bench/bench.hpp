@@ -0,0 +1,118 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INDI_INC_CRC_BENCH_BENCH_
+#define INDI_INC_CRC_BENCH_BENCH_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+//! Fills a buffer with pseudo-random bytes (the same ones every run).
+inline auto random_bytes(std::size_t size)
+{
+	auto engine = std::mt19937{12345u};
+	auto dist = std::uniform_int_distribution<unsigned>{0u, 255u};
+	auto data = std::vector<unsigned char>(size);
+	for (auto& b : data)
+		b = static_cast<unsigned char>(dist(engine));
+	return data;
+}
+
+//! Stops the compiler from optimising away a result.
+template <typename T>
+inline auto keep(T const& value) noexcept -> void
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+//! Pushes everything else out of the caches by walking through a buffer
+//! much larger than the last level cache.
+inline auto evict_caches() -> void
+{
+	static auto buffer = std::vector<unsigned char>(std::size_t{64u} << 20);
+	
+	for (auto n = std::size_t{0}; n < buffer.size(); n += 64u)
+		++buffer[n];
+	keep(buffer[0]);
+}
+
+//! Times a function, running it `runs` times, optionally evicting the
+//! caches before each run.
+//! 
+//! \returns The median time of a single run, in nanoseconds.
+template <typename F>
+auto median_ns(F f, std::size_t runs, bool cold = false) -> double
+{
+	using clock = std::chrono::steady_clock;
+	
+	auto times = std::vector<double>{};
+	times.reserve(runs);
+	
+	for (auto n = std::size_t{0}; n < runs; ++n)
+	{
+		if (cold)
+			evict_caches();
+		
+		auto const start = clock::now();
+		f();
+		auto const stop = clock::now();
+		
+		times.push_back(std::chrono::duration<double, std::nano>(
+			stop - start).count());
+	}
+	
+	std::nth_element(times.begin(), times.begin() + runs / 2, times.end());
+	return times[runs / 2];
+}
+
+//! Prints a line of results.
+inline auto report(char const* name, std::size_t size, double ns) -> void
+{
+	std::printf("  %-10s %9zu B %12.1f ns %10.1f MB/s\n", name, size, ns,
+		static_cast<double>(size) * 1000.0 / ns);
+}
+
+// Benchmarks, each in its own source file.
+auto batch() -> void;
+auto bitslice() -> void;
+auto braid() -> void;
+auto chorba() -> void;
+auto copy() -> void;
+auto execution() -> void;
+auto fixed() -> void;
+auto hash() -> void;
+auto kernels() -> void;
+auto multi() -> void;
+auto nibble() -> void;
+auto slot() -> void;
+auto stripe() -> void;
+auto wide() -> void;
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
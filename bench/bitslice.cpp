@@ -0,0 +1,88 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// 256-element lookup table, one message at a time, against the
+// bitsliced engine, over 4096 short messages of the same length.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-bitslice.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto messages = std::size_t{4096u};
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+auto run_all(std::vector<unsigned char> const& data) -> void
+{
+	using T = crc_type_t<Bits>;
+	
+	auto const table = generate_table<Bits>(Polynomial);
+	auto const bitsliced = bitsliced_engine<Bits, Polynomial>{};
+	auto crcs = std::vector<T>(messages);
+	
+	for (auto const length : {std::size_t{8u}, std::size_t{16u},
+		std::size_t{64u}})
+	{
+		auto frames = std::vector<unsigned char const*>(messages);
+		for (auto n = std::size_t{0}; n < messages; ++n)
+			frames[n] = data.data() + n * length;
+		
+		auto const size = messages * length;
+		
+		report("table", size, median_ns([&]
+		{
+			for (auto n = std::size_t{0}; n < messages; ++n)
+				crcs[n] = calculate_raw<Bits>(T{0u}, frames[n],
+					frames[n] + length, table);
+			keep(crcs);
+		}, 9u));
+		
+		report("bitsliced", size, median_ns([&]
+		{
+			bitsliced.update(T{0u}, frames.data(), messages, length,
+				crcs.data());
+			keep(crcs);
+		}, 9u));
+	}
+}
+
+} // anonymous namespace
+
+auto bitslice() -> void
+{
+	auto const data = random_bytes(messages * 64u);
+	
+	std::printf("  CRC-8:\n");
+	run_all<8, 0x07u>(data);
+	std::printf("  CRC-16/MODBUS:\n");
+	run_all<16, polynomials::crc16_ibm>(data);
+	std::printf("  CRC-32:\n");
+	run_all<32, polynomials::crc32>(data);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,86 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// 256-element lookup table against braided tables, with different
+// numbers of braids, with the data in cache.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-braid.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+template <std::size_t Bits, typename Table>
+auto run(char const* name, Table const& table,
+	std::vector<unsigned char> const& data, std::size_t size) -> void
+{
+	auto const runs = std::max<std::size_t>(1u,
+		(std::size_t{1u} << 20) / size);
+	auto const ns = median_ns([&]
+	{
+		for (auto n = std::size_t{0}; n < runs; ++n)
+			keep(calculate_raw<Bits>(crc_type_t<Bits>{0u}, data.data(),
+				data.data() + size, table));
+	}, 9u) / static_cast<double>(runs);
+	
+	report(name, size, ns);
+}
+
+template <std::size_t Bits, typename T>
+auto run_all(T polynomial, std::vector<unsigned char> const& data)
+	-> void
+{
+	auto const table = generate_table<Bits>(polynomial);
+	auto const braids3 = braided_engine<Bits, T, 3>{polynomial};
+	auto const braids5 = braided_engine<Bits, T, 5>{polynomial};
+	auto const braids8 = braided_engine<Bits, T, 8>{polynomial};
+	
+	for (auto const size : {std::size_t{256u}, std::size_t{4u} << 10,
+		std::size_t{64u} << 10})
+	{
+		run<Bits>("table", table, data, size);
+		run<Bits>("3 braids", braids3, data, size);
+		run<Bits>("5 braids", braids5, data, size);
+		run<Bits>("8 braids", braids8, data, size);
+	}
+}
+
+} // anonymous namespace
+
+auto braid() -> void
+{
+	auto const data = random_bytes(std::size_t{64u} << 10);
+	
+	std::printf("  CRC-32:\n");
+	run_all<32>(polynomials::crc32, data);
+	std::printf("  CRC-64:\n");
+	run_all<64>(polynomials::crc64_ecma, data);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
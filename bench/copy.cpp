@@ -0,0 +1,83 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// `std::memcpy` alone, `std::memcpy` followed by `calculate` over the
+// copy, and `copy_and_calculate`, for CRC-32C and CRC-32 with a
+// `clmul_engine`, from a buffer in the cache and from one in memory.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-copy.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+template <typename Engine>
+auto run(Engine const& engine, std::size_t size, bool cold) -> void
+{
+	auto const src = random_bytes(size);
+	auto dst = std::vector<unsigned char>(size);
+	auto const runs = cold ? 9u : 99u;
+	
+	report("memcpy", size, median_ns([&]
+	{
+		std::memcpy(dst.data(), src.data(), size);
+		keep(dst);
+	}, runs, cold));
+	
+	report("memcpy + calculate", size, median_ns([&]
+	{
+		std::memcpy(dst.data(), src.data(), size);
+		keep(calculate<32>(dst.data(), dst.data() + size, engine));
+	}, runs, cold));
+	
+	report("copy_and_calculate", size, median_ns([&]
+	{
+		keep(copy_and_calculate<32>(dst.data(), src.data(), size,
+			engine));
+	}, runs, cold));
+}
+
+} // anonymous namespace
+
+auto copy() -> void
+{
+	auto const crc32c = clmul_engine<32>{polynomials::crc32c};
+	auto const crc32 = clmul_engine<32>{polynomials::crc32};
+	
+	std::printf("  CRC-32C, 64 KB, warm:\n");
+	run(crc32c, std::size_t{64u} << 10, false);
+	std::printf("  CRC-32C, 64 MB, cold:\n");
+	run(crc32c, std::size_t{64u} << 20, true);
+	std::printf("  CRC-32, 64 KB, warm:\n");
+	run(crc32, std::size_t{64u} << 10, false);
+	std::printf("  CRC-32, 64 MB, cold:\n");
+	run(crc32, std::size_t{64u} << 20, true);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
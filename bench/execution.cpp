@@ -0,0 +1,88 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// `calculate` of 256 MB (CRC-32C) under each standard execution
+// policy, against `calculate` without one, with a lookup table and with
+// a `clmul_engine`. The makefile only builds this with C++17 when the
+// compiler has <execution>; otherwise the benchmark just says so.
+
+#include <cstddef>
+#include <cstdio>
+
+#if __cplusplus >= 201703L
+#include <execution>
+
+#include "indi/crc.hpp"
+#include "indi/crc-execution.hpp"
+#include "indi/crc-simd.hpp"
+#endif
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+#if __cplusplus >= 201703L
+
+auto execution() -> void
+{
+	constexpr auto size = std::size_t{256u} << 20;
+	auto const data = random_bytes(size);
+	auto const engine = clmul_engine<32>{polynomials::crc32c};
+	auto const table = generate_table<32>(polynomials::crc32c);
+	
+	report("table", size, median_ns([&]
+	{
+		keep(calculate<32>(data, table));
+	}, 5u));
+	
+	report("clmul_engine", size, median_ns([&]
+	{
+		keep(calculate<32>(data, engine));
+	}, 5u));
+	
+	report("seq", size, median_ns([&]
+	{
+		keep(calculate<32>(std::execution::seq, data,
+			polynomials::crc32c));
+	}, 5u));
+	
+	report("par", size, median_ns([&]
+	{
+		keep(calculate<32>(std::execution::par, data,
+			polynomials::crc32c));
+	}, 5u));
+	
+	report("par_unseq", size, median_ns([&]
+	{
+		keep(calculate<32>(std::execution::par_unseq, data,
+			polynomials::crc32c));
+	}, 5u));
+}
+
+#else
+
+auto execution() -> void
+{
+	std::printf("  (needs C++17 and <execution>)\n");
+}
+
+#endif
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
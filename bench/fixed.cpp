@@ -0,0 +1,116 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Latency of `calculate` with a lookup table and with a `clmul_engine`,
+// against `calculate_fixed`, for short keys, in reference cycles (time
+// stamp counter ticks) per call. Each key depends on the CRC of the one
+// before, so the calls can't overlap.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <x86intrin.h>
+
+#include "indi/crc.hpp"
+#include "indi/crc-fixed.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto calls = std::size_t{1u} << 16;
+
+// Runs `f` on a key `calls` times, feeding each CRC back into the key.
+template <typename F>
+auto cycles_per_call(unsigned char* key, F f) -> double
+{
+	auto times = std::vector<double>{};
+	
+	for (auto run = 0; run < 9; ++run)
+	{
+		auto const start = __rdtsc();
+		for (auto n = std::size_t{0}; n < calls; ++n)
+			key[0] = static_cast<unsigned char>(f(key));
+		auto const stop = __rdtsc();
+		
+		times.push_back(static_cast<double>(stop - start) /
+			static_cast<double>(calls));
+	}
+	
+	std::nth_element(times.begin(), times.begin() + 4, times.end());
+	return times[4];
+}
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+auto run(unsigned char* key) -> void
+{
+	auto const table = generate_table<Bits>(Polynomial);
+	auto const engine = clmul_engine<Bits>{Polynomial};
+	
+	auto const t = cycles_per_call(key, [&table](unsigned char const* p)
+	{
+		return calculate<Bits>(p, p + N, table);
+	});
+	auto const e = cycles_per_call(key, [&engine](unsigned char const* p)
+	{
+		return calculate<Bits>(p, p + N, engine);
+	});
+	auto const f = cycles_per_call(key, [](unsigned char const* p)
+	{
+		return calculate_fixed<Bits, Polynomial, N>(p);
+	});
+	
+	std::printf("  %3zu B %12.1f %12.1f %12.1f\n", N, t, e, f);
+}
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial,
+	std::size_t... N>
+auto run_all(std::index_sequence<N...>) -> void
+{
+	auto key = random_bytes(64u);
+	
+	std::printf("  %5s %12s %12s %12s  (cycles per call)\n", "", "table",
+		"clmul", "fixed");
+	using expand = int[];
+	(void)expand{0, (run<Bits, Polynomial, N>(key.data()), 0)...};
+}
+
+} // anonymous namespace
+
+auto fixed() -> void
+{
+	auto const sizes = std::index_sequence<8u, 16u, 32u, 64u>{};
+	
+	std::printf("  CRC-32C:\n");
+	run_all<32, polynomials::crc32c>(sizes);
+	std::printf("  CRC-32:\n");
+	run_all<32, polynomials::crc32>(sizes);
+	std::printf("  CRC-64/ECMA:\n");
+	run_all<64, polynomials::crc64_ecma>(sizes);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,180 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// `hash` against `std::hash`: throughput for string and integer keys,
+// and how evenly they spread keys over buckets.
+//
+// Spread is measured by the chi-squared statistic over 4096 buckets,
+// divided by the number of buckets, so that a random function scores
+// about 1 and anything much higher clusters; buckets are picked by the
+// low 12 bits of the hash (as tables with power-of-two sizes do) and by
+// the hash modulo 4093 (as libstdc++ does). Avalanche is the largest
+// bias, over every pair of input and output bit, away from a flip of
+// the input bit flipping the output bit half the time.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "indi/crc-hash.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto keys = std::size_t{4096u};
+constexpr auto buckets = std::size_t{4096u};
+
+template <typename Hash, typename Key>
+auto throughput(char const* name, Hash const& hash,
+	std::vector<Key> const& input, std::size_t size) -> void
+{
+	report(name, size * input.size(), median_ns([&]
+	{
+		auto sum = std::size_t{0};
+		for (auto const& key : input)
+			sum += hash(key);
+		keep(sum);
+	}, 9u));
+}
+
+// Chi-squared over the buckets, divided by the number of buckets.
+template <typename Index>
+auto spread(std::vector<std::uint64_t> const& hashes, Index index)
+{
+	auto counts = std::vector<double>(buckets);
+	for (auto const h : hashes)
+		++counts[index(h)];
+	
+	auto const expected = static_cast<double>(hashes.size()) /
+		static_cast<double>(buckets);
+	auto chi2 = 0.0;
+	for (auto const c : counts)
+		chi2 += (c - expected) * (c - expected) / expected;
+	return chi2 / static_cast<double>(buckets);
+}
+
+template <typename Hash, typename Key>
+auto distribution(char const* name, Hash const& hash,
+	std::vector<Key> const& input) -> void
+{
+	auto hashes = std::vector<std::uint64_t>{};
+	for (auto const& key : input)
+		hashes.push_back(hash(key));
+	
+	std::printf("  %-10s %12.2f %12.2f\n", name,
+		spread(hashes, [](std::uint64_t h) { return h % buckets; }),
+		spread(hashes, [](std::uint64_t h) { return h % 4093u; }));
+}
+
+template <typename Hash>
+auto avalanche(char const* name, Hash const& hash) -> void
+{
+	constexpr auto samples = 2000u;
+	auto random = std::mt19937_64{4242u};
+	
+	auto flips = std::vector<unsigned>(64u * 64u);
+	for (auto sample = 0u; sample < samples; ++sample)
+	{
+		auto const key = std::uint64_t{random()};
+		auto const h = std::uint64_t{hash(key)};
+		for (auto in = 0u; in < 64u; ++in)
+		{
+			auto const d = h ^ std::uint64_t{hash(key ^ (std::uint64_t{1} <<
+				in))};
+			for (auto out = 0u; out < 64u; ++out)
+				flips[in * 64u + out] += (d >> out) & 1u;
+		}
+	}
+	
+	auto worst = 0.0;
+	for (auto const f : flips)
+		worst = std::fmax(worst, std::fabs(static_cast<double>(f) /
+			samples - 0.5));
+	
+	std::printf("  %-10s %12.3f\n", name, worst);
+}
+
+} // anonymous namespace
+
+auto hash() -> void
+{
+	auto const std_string = std::hash<std::string>{};
+	auto const crc_string = indi::crc::hash<std::string>{};
+	auto const std_integer = std::hash<std::uint64_t>{};
+	auto const crc_integer = indi::crc::hash<std::uint64_t>{};
+	
+	std::printf("  Throughput, %zu keys:\n", keys);
+	auto integers = std::vector<std::uint64_t>{};
+	for (auto n = std::size_t{0}; n < keys; ++n)
+		integers.push_back(n * 0x9E3779B97F4A7C15u);
+	throughput("std", std_integer, integers, 8u);
+	throughput("crc", crc_integer, integers, 8u);
+	
+	auto const data = random_bytes(keys * 256u);
+	for (auto const size : {std::size_t{16u}, std::size_t{32u},
+		std::size_t{64u}, std::size_t{256u}})
+	{
+		auto strings = std::vector<std::string>{};
+		for (auto n = std::size_t{0}; n < keys; ++n)
+			strings.emplace_back(data.begin() + n * size,
+				data.begin() + (n + 1u) * size);
+		
+		throughput("std", std_string, strings, size);
+		throughput("crc", crc_string, strings, size);
+	}
+	
+	std::printf("  Spread (about 1 is good), %zu buckets: %12s %12s\n",
+		buckets, "low bits", "mod 4093");
+	
+	auto const count = 16u * buckets;
+	auto sequential = std::vector<std::uint64_t>{};
+	auto strided = std::vector<std::uint64_t>{};
+	auto names = std::vector<std::string>{};
+	for (auto n = std::uint64_t{0}; n < count; ++n)
+	{
+		sequential.push_back(n);
+		strided.push_back(n << 12);
+		names.push_back("user:" + std::to_string(n));
+	}
+	
+	std::printf("  Sequential integers:\n");
+	distribution("std", std_integer, sequential);
+	distribution("crc", crc_integer, sequential);
+	std::printf("  Integers 4096 apart:\n");
+	distribution("std", std_integer, strided);
+	distribution("crc", crc_integer, strided);
+	std::printf("  \"user:N\" strings:\n");
+	distribution("std", std_string, names);
+	distribution("crc", crc_string, names);
+	
+	std::printf("  Avalanche, worst bias (0 is good), 64-bit keys:\n");
+	avalanche("std", std_integer);
+	avalanche("crc", crc_integer);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
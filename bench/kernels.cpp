@@ -0,0 +1,86 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// The kernels of `clmul_engine`, over a range of input sizes, with the
+// data in cache.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc-simd.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+struct named_kernel
+{
+	char const* name;
+	clmul_kernel kernel;
+};
+
+constexpr named_kernel all_kernels[] = {
+	{"table", clmul_kernel::table},
+	{"pshufb", clmul_kernel::pshufb},
+	{"vpshufb", clmul_kernel::vpshufb},
+	{"pclmul", clmul_kernel::pclmul},
+	{"vpclmul", clmul_kernel::vpclmul}
+};
+
+} // anonymous namespace
+
+auto kernels() -> void
+{
+	auto const data = random_bytes(std::size_t{256u} << 10);
+	
+	for (auto const& k : all_kernels)
+	{
+		auto const engine = clmul_engine<32>{polynomials::crc32, k.kernel,
+			256u};
+		
+		// Unsupported kernels fall back to slower ones.
+		if (engine.kernel() != k.kernel)
+			continue;
+		
+		for (auto const size : {std::size_t{1u} << 10, std::size_t{2u} << 10,
+			std::size_t{4u} << 10, std::size_t{8u} << 10,
+			std::size_t{16u} << 10, std::size_t{64u} << 10,
+			std::size_t{256u} << 10})
+		{
+			auto const runs = std::max<std::size_t>(1u,
+				(std::size_t{4u} << 20) / size);
+			auto const ns = median_ns([&]
+			{
+				for (auto n = std::size_t{0}; n < runs; ++n)
+					keep(engine.update(0xFFFFFFFFu, data.data(),
+						data.data() + size));
+			}, 9u) / static_cast<double>(runs);
+			
+			report(k.name, size, ns);
+		}
+	}
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
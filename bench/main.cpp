@@ -0,0 +1,85 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// crc-bench: micro-benchmarks for the CRC engines.
+
+#include <cstdio>
+#include <cstring>
+
+#include "bench.hpp"
+
+namespace {
+
+struct benchmark
+{
+	char const* name;
+	void (*run)();
+};
+
+constexpr benchmark benchmarks[] = {
+	{"batch", indi::crc::bench::batch},
+	{"bitslice", indi::crc::bench::bitslice},
+	{"braid", indi::crc::bench::braid},
+	{"chorba", indi::crc::bench::chorba},
+	{"copy", indi::crc::bench::copy},
+	{"execution", indi::crc::bench::execution},
+	{"fixed", indi::crc::bench::fixed},
+	{"hash", indi::crc::bench::hash},
+	{"kernels", indi::crc::bench::kernels},
+	{"multi", indi::crc::bench::multi},
+	{"nibble", indi::crc::bench::nibble},
+	{"slot", indi::crc::bench::slot},
+	{"stripe", indi::crc::bench::stripe},
+	{"wide", indi::crc::bench::wide}
+};
+
+} // anonymous namespace
+
+//! Runs the benchmarks named on the command line, or all of them.
+auto main(int argc, char* argv[]) -> int
+{
+	auto status = 0;
+	
+	for (auto const& b : benchmarks)
+	{
+		auto selected = argc < 2;
+		for (auto n = 1; n < argc; ++n)
+			selected = selected || std::strcmp(argv[n], b.name) == 0;
+		
+		if (!selected)
+			continue;
+		
+		std::printf("%s:\n", b.name);
+		b.run();
+	}
+	
+	for (auto n = 1; n < argc; ++n)
+	{
+		auto known = false;
+		for (auto const& b : benchmarks)
+			known = known || std::strcmp(argv[n], b.name) == 0;
+		
+		if (!known)
+		{
+			std::fprintf(stderr, "crc-bench: unknown benchmark '%s'\n",
+				argv[n]);
+			status = 2;
+		}
+	}
+	
+	return status;
+}
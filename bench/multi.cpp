@@ -0,0 +1,64 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// CRC-32, CRC-32C, and CRC-64/ECMA of the same data, calculated one
+// after the other against all three at once with `calculate_multi`,
+// for data in cache and data too large for it.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+auto multi() -> void
+{
+	auto const data = random_bytes(std::size_t{256u} << 20);
+	
+	auto const crc32 = clmul_engine<32>{polynomials::crc32};
+	auto const crc32c = clmul_engine<32>{polynomials::crc32c};
+	auto const crc64 = clmul_engine<64>{polynomials::crc64_ecma};
+	
+	for (auto const size : {std::size_t{256u} << 10, data.size()})
+	{
+		auto const first = data.data();
+		auto const last = first + size;
+		auto const runs = size < (std::size_t{1u} << 20) ? 101u : 5u;
+		
+		report("separate", 3u * size, median_ns([&]
+		{
+			keep(calculate<32>(first, last, crc32));
+			keep(calculate<32>(first, last, crc32c));
+			keep(calculate<64>(first, last, crc64));
+		}, runs));
+		
+		report("multi", 3u * size, median_ns([&]
+		{
+			keep(calculate_multi(first, last, crc32, crc32c, crc64));
+		}, runs));
+	}
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
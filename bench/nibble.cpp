@@ -0,0 +1,85 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// 256-element lookup table against 16-element nibble table, with the
+// caches warm (the same message over and over) and cold (the caches
+// flushed before every message, as for a CRC done now and then in
+// between other work).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-nibble.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+template <typename Table>
+auto run(char const* name, Table const& table,
+	std::vector<unsigned char> const& data, std::size_t size) -> void
+{
+	auto const first = data.data();
+	auto const last = first + size;
+	auto const once = [&]
+	{
+		keep(calculate_raw<32>(std::uint_fast32_t{0xFFFFFFFFu}, first,
+			last, table));
+	};
+	
+	// Enough warm runs to make each measurement about 1 MiB of data.
+	auto const runs = std::max<std::size_t>(1u, (std::size_t{1u} << 20) /
+		size);
+	auto const warm = median_ns([&]
+	{
+		for (auto n = std::size_t{0}; n < runs; ++n)
+			once();
+	}, 15u) / static_cast<double>(runs);
+	auto const cold = median_ns(once, 15u, true);
+	
+	std::printf("  %-8s", name);
+	report("warm", size, warm);
+	std::printf("  %-8s", "");
+	report("cold", size, cold);
+}
+
+} // anonymous namespace
+
+auto nibble() -> void
+{
+	auto const data = random_bytes(std::size_t{64u} << 10);
+	auto const table = generate_table<32>(polynomials::crc32);
+	auto const engine = nibble_engine<32>{polynomials::crc32};
+	
+	for (auto const size : {std::size_t{64u}, std::size_t{1u} << 10,
+		std::size_t{64u} << 10})
+	{
+		run("table", table, data, size);
+		run("nibble", engine, data, size);
+	}
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
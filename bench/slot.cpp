@@ -0,0 +1,92 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Redis cluster key slots, one key at a time with `key_slot`, against a
+// pipeline at a time with `key_slots`, over 4096 keys of typical shapes.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "indi/crc-slot.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto keys = std::size_t{4096u};
+
+auto run(std::vector<std::string> const& input) -> void
+{
+	auto pointers = std::vector<char const*>{};
+	auto lengths = std::vector<std::size_t>{};
+	auto size = std::size_t{0};
+	for (auto const& key : input)
+	{
+		pointers.push_back(key.data());
+		lengths.push_back(key.size());
+		size += key.size();
+	}
+	
+	auto slots = std::vector<std::uint_fast16_t>(input.size());
+	
+	report("single", size, median_ns([&]
+	{
+		for (auto n = std::size_t{0}; n < input.size(); ++n)
+			slots[n] = key_slot(pointers[n], lengths[n]);
+		keep(slots);
+	}, 9u));
+	
+	report("batch", size, median_ns([&]
+	{
+		key_slots(pointers.data(), lengths.data(), input.size(),
+			slots.data());
+		keep(slots);
+	}, 9u));
+}
+
+} // anonymous namespace
+
+auto slot() -> void
+{
+	auto sessions = std::vector<std::string>{};
+	auto tagged = std::vector<std::string>{};
+	auto documents = std::vector<std::string>{};
+	for (auto n = std::size_t{0}; n < keys; ++n)
+	{
+		auto const id = std::to_string(n * 2654435761u % 100000000u);
+		sessions.push_back("session:" + id);
+		tagged.push_back("{user:" + id + "}:followers");
+		documents.push_back("tenant:" + std::to_string(n % 97) +
+			":document:" + id + ":revision:" + std::to_string(n % 11));
+	}
+	
+	std::printf("  \"session:N\":\n");
+	run(sessions);
+	std::printf("  \"{user:N}:followers\":\n");
+	run(tagged);
+	std::printf("  \"tenant:N:document:N:revision:N\":\n");
+	run(documents);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,86 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The XOR parity and CRC-32Cs of a stripe of four 64 KB data blocks
+// (in the cache) and of four 16 MB ones (in memory), in separate passes
+// (with the same kernels) against `calculate_stripe`, with a
+// `clmul_engine`.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+#include "indi/crc-stripe.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+constexpr auto count = std::size_t{4u};
+
+auto run(std::size_t size, bool cold) -> void
+{
+	auto const engine = clmul_engine<32>{polynomials::crc32c};
+	auto const data = random_bytes(count * size);
+	unsigned char const* blocks[count] = {};
+	for (auto block = std::size_t{0}; block < count; ++block)
+		blocks[block] = data.data() + block * size;
+	
+	auto parity = std::vector<unsigned char>(size);
+	std::uint_fast32_t crcs[count + 1u] = {};
+	auto const runs = cold ? 9u : 99u;
+	
+	report("separate", count * size, median_ns([&]
+	{
+		for (auto block = std::size_t{0}; block < count; ++block)
+			crcs[block] = calculate<32>(blocks[block],
+				blocks[block] + size, engine);
+		detail_::stripe_xor(parity.data(), blocks, count, 0u, size);
+		crcs[count] = calculate<32>(parity.data(), parity.data() + size,
+			engine);
+		keep(crcs);
+		keep(parity);
+	}, runs, cold));
+	
+	report("calculate_stripe", count * size, median_ns([&]
+	{
+		calculate_stripe<32>(blocks, count, size, parity.data(), crcs,
+			polynomials::crc32c, engine);
+		keep(crcs);
+		keep(parity);
+	}, runs, cold));
+}
+
+} // anonymous namespace
+
+auto stripe() -> void
+{
+	std::printf("  4 x 64 KB, warm:\n");
+	run(std::size_t{64u} << 10, false);
+	std::printf("  4 x 16 MB, cold:\n");
+	run(std::size_t{16u} << 20, true);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,82 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// 256-element lookup table against the 65536-element wide table, with
+// the data in cache.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-wide.hpp"
+
+#include "bench.hpp"
+
+namespace indi {
+namespace crc {
+namespace bench {
+
+namespace {
+
+template <std::size_t Bits, typename Table>
+auto run(char const* name, Table const& table,
+	std::vector<unsigned char> const& data, std::size_t size) -> void
+{
+	auto const runs = std::max<std::size_t>(1u,
+		(std::size_t{1u} << 20) / size);
+	auto const ns = median_ns([&]
+	{
+		for (auto n = std::size_t{0}; n < runs; ++n)
+			keep(calculate_raw<Bits>(crc_type_t<Bits>{0u}, data.data(),
+				data.data() + size, table));
+	}, 9u) / static_cast<double>(runs);
+	
+	report(name, size, ns);
+}
+
+template <std::size_t Bits, typename T>
+auto run_all(T polynomial, std::vector<unsigned char> const& data)
+	-> void
+{
+	auto const table = generate_table<Bits>(polynomial);
+	auto const wide = wide_engine<Bits, T>{polynomial};
+	
+	for (auto const size : {std::size_t{64u}, std::size_t{256u},
+		std::size_t{4u} << 10, std::size_t{64u} << 10})
+	{
+		run<Bits>("table", table, data, size);
+		run<Bits>("wide", wide, data, size);
+	}
+}
+
+} // anonymous namespace
+
+auto wide() -> void
+{
+	auto const data = random_bytes(std::size_t{64u} << 10);
+	
+	std::printf("  CRC-8:\n");
+	run_all<8>(std::uint_fast8_t{0x07u}, data);
+	std::printf("  CRC-16/MODBUS:\n");
+	run_all<16>(polynomials::crc16_ibm, data);
+}
+
+} // namespace bench
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,220 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_ACCUMULATOR_
+#define INDI_INC_CRC_ACCUMULATOR_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+
+// Calculating the CRC of an object from chunks that arrive out of
+// order, from any number of threads.
+//
+// The raw CRC of each chunk is calculated on its own, starting from 0,
+// by the thread that adds it. Raw CRCs combine as
+//
+//     raw(A B) = raw(A) * x^(8 |B|) + raw(B)  (mod P)
+//
+// so the raw CRC of the object is the XOR of the raw CRCs of its
+// chunks, each shifted past the rest of the object after it (which is
+// `combine` with that many zero bytes, whose raw CRC is 0). Each chunk
+// is folded in as soon as it is added, so adding one costs the same
+// whatever order the chunks come in, and however many are missing.
+//
+// Nothing is locked: the XOR, and the count of bytes added, are atomic,
+// and the thread whose chunk brings the count to the size of the
+// object works out its CRC. So that a chunk delivered twice (a retried
+// part) is only counted once, the offset of each chunk is claimed
+// first in an open-addressed table, with a compare-and-swap; a chunk
+// whose offset is already there is dropped.
+
+namespace indi {
+namespace crc {
+
+//! Calculates the CRC of an object from chunks added in any order, from
+//! any threads.
+//! 
+//! The chunks must cover the object when they are all added, and must
+//! not overlap, except that the same chunk can be added again (it is
+//! ignored).
+//! 
+//! \tparam Bits    The CRC bit-size.
+//! \tparam Engine  The CRC engine type (reflected).
+template <std::size_t Bits, typename Engine>
+class crc_accumulator
+{
+	static_assert(detail_::is_crc_engine<Engine>::value,
+		"Engine must be a CRC engine");
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+public:
+	using crc_type = typename Engine::crc_type;
+	
+	//! Sets up for an object.
+	//! 
+	//! \param size  The size of the object, in bytes.
+	//! \param chunks  The most chunks that will be added.
+	//! \param polynomial  The encoded polynomial value.
+	//! \param engine  The CRC engine (for `polynomial`).
+	crc_accumulator(std::uintmax_t size, std::size_t chunks,
+		crc_type polynomial, Engine const& engine) :
+		size_(size),
+		polynomial_(polynomial),
+		engine_(engine),
+		chunks_(chunks),
+		mask_(slot_count(chunks) - 1u),
+		offsets_(new std::atomic<std::uintmax_t>[mask_ + 1u])
+	{
+		for (auto n = std::size_t{0}; n <= mask_; ++n)
+			offsets_[n].store(empty, std::memory_order_relaxed);
+		
+		if (size_ == 0u)
+			finish(crc_type{0});
+	}
+	
+	crc_accumulator(crc_accumulator const&) = delete;
+	auto operator=(crc_accumulator const&) -> crc_accumulator& = delete;
+	
+	//! Adds a chunk of the object.
+	//! 
+	//! This can be called from any number of threads at once.
+	//! 
+	//! \param offset  Where the chunk starts in the object.
+	//! \param data  The bytes of the chunk.
+	//! \param length  The length of the chunk, in bytes.
+	//! 
+	//! \returns `true` if this chunk completed the object (and `false`
+	//!     if a chunk at `offset` was added already).
+	//! 
+	//! \throws std::out_of_range if the chunk is not inside the object.
+	//! \throws std::length_error if there are too many chunks.
+	auto add(std::uintmax_t offset, void const* data, std::size_t length)
+		-> bool
+	{
+		if (offset > size_ || length > size_ - offset)
+			throw std::out_of_range{"chunk is outside the object"};
+		if (length == 0u)
+			return false;
+		
+		if (!claim(offset))
+			return false;
+		if (next_.fetch_add(1u, std::memory_order_relaxed) >= chunks_)
+			throw std::length_error{"too many chunks"};
+		
+		auto const first = static_cast<unsigned char const*>(data);
+		auto const crc = calculate_raw<Bits>(crc_type{0}, first,
+			first + length, engine_);
+		raw_.fetch_xor(combine<Bits>(crc, crc_type{0},
+			size_ - offset - length, polynomial_),
+			std::memory_order_relaxed);
+		
+		// Every other chunk's CRC is in once the count reaches the size.
+		auto const added = added_.fetch_add(length,
+			std::memory_order_acq_rel) + length;
+		if (added != size_)
+			return false;
+		
+		finish(raw_.load(std::memory_order_relaxed));
+		return true;
+	}
+	
+	//! \returns `true` once every byte of the object has been added.
+	auto done() const noexcept -> bool
+	{
+		return done_.load(std::memory_order_acquire);
+	}
+	
+	//! Gets the CRC of the object, as `calculate` gives.
+	//! 
+	//! \requires `done()` must be `true`.
+	auto crc() const noexcept -> crc_type
+	{
+		return crc_;
+	}
+	
+	auto size() const noexcept { return size_; }
+	
+private:
+	// Offsets are never this large, so it marks an unused slot.
+	static constexpr auto empty = std::numeric_limits<std::uintmax_t>::max();
+	
+	// The slots are kept at most half full.
+	static auto slot_count(std::size_t chunks) noexcept
+	{
+		auto count = std::size_t{2u};
+		while (count < 2u * chunks)
+			count *= 2u;
+		return count;
+	}
+	
+	// Claims the slot for a chunk's offset, by linear probing.
+	// Returns `false` if it was claimed already.
+	auto claim(std::uintmax_t offset) -> bool
+	{
+		auto n = static_cast<std::size_t>(
+			(static_cast<std::uint64_t>(offset) *
+				0x9E3779B97F4A7C15uLL) >> 32) & mask_;
+		for (auto probes = std::size_t{0}; probes <= mask_; ++probes)
+		{
+			auto key = offsets_[n].load(std::memory_order_relaxed);
+			if (key == empty && offsets_[n].compare_exchange_strong(key,
+					offset, std::memory_order_relaxed))
+				return true;
+			if (key == offset)
+				return false;
+			n = (n + 1u) & mask_;
+		}
+		
+		throw std::length_error{"too many chunks"};
+	}
+	
+	// The raw CRCs start from 0, so the object's CRC is that of all bits
+	// set over the object, combined with the raw CRC.
+	auto finish(crc_type raw) noexcept -> void
+	{
+		constexpr auto ones = detail_::ones<Bits, crc_type>();
+		crc_ = crc_type(ones ^ combine<Bits>(ones, raw, size_,
+			polynomial_));
+		done_.store(true, std::memory_order_release);
+	}
+	
+	std::uintmax_t size_;
+	crc_type polynomial_;
+	Engine engine_;
+	std::size_t chunks_;
+	std::size_t mask_;
+	std::unique_ptr<std::atomic<std::uintmax_t>[]> offsets_;
+	std::atomic<std::size_t> next_{0u};
+	std::atomic<crc_type> raw_{0u};
+	std::atomic<std::uintmax_t> added_{0u};
+	std::atomic<bool> done_{false};
+	crc_type crc_{};
+};
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
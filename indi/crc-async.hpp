@@ -0,0 +1,324 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_ASYNC_
+#define INDI_INC_CRC_ASYNC_
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+#include "indi/crc.hpp"
+
+// Calculating CRCs in coroutines, a slice at a time.
+//
+// Unlike the rest of the library, this file needs C++20, for
+// coroutines and `std::stop_token`.
+//
+// `async_calculate` is a coroutine that calculates the CRC of a buffer
+// a slice of at most `budget` bytes at a time, and suspends between
+// slices, so an event loop can calculate the CRC of a large buffer
+// between handling other events, without any one step taking longer
+// than one slice does. It can be driven by hand, with `resume`, or
+// awaited from another coroutine, with a `yield` that reschedules it
+// on the event loop.
+
+namespace indi {
+namespace crc {
+
+//! Options for `async_calculate`.
+struct async_options
+{
+	//! The most bytes to calculate the CRC of in each step (0 for no
+	//! limit).
+	std::size_t budget = std::size_t{1u} << 20;
+	//! Stops the calculation, before the next step, once requested.
+	std::stop_token stop = {};
+};
+
+//! A CRC calculation in progress (see `async_calculate`).
+//! 
+//! The calculation starts suspended, and calculates a slice of the
+//! buffer each time it is resumed. The result is the CRC, or nothing
+//! if the calculation was stopped.
+//! 
+//! \tparam T  The CRC type.
+template <typename T>
+class crc_task
+{
+public:
+	struct promise_type;
+	using handle_type = std::coroutine_handle<promise_type>;
+	
+	struct promise_type
+	{
+		std::optional<T> result;
+		std::size_t processed = 0u;
+		std::size_t size = 0u;
+		std::coroutine_handle<> continuation;
+		
+		auto get_return_object() noexcept
+			{ return crc_task{handle_type::from_promise(*this)}; }
+		auto initial_suspend() noexcept { return std::suspend_always{}; }
+		
+		// Goes back to the coroutine awaiting the task, if there is one.
+		auto final_suspend() noexcept
+		{
+			struct awaiter
+			{
+				auto await_ready() noexcept { return false; }
+				auto await_suspend(handle_type h) noexcept ->
+					std::coroutine_handle<>
+				{
+					auto const next = h.promise().continuation;
+					return next ? next : std::noop_coroutine();
+				}
+				auto await_resume() noexcept -> void {}
+			};
+			return awaiter{};
+		}
+		
+		auto return_value(std::optional<T> crc) noexcept -> void
+			{ result = crc; }
+		auto unhandled_exception() noexcept -> void { std::terminate(); }
+	};
+	
+	crc_task(crc_task&& other) noexcept :
+		handle_(std::exchange(other.handle_, nullptr))
+	{}
+	
+	auto operator=(crc_task&& other) noexcept -> crc_task&
+	{
+		if (this != &other)
+		{
+			if (handle_)
+				handle_.destroy();
+			handle_ = std::exchange(other.handle_, nullptr);
+		}
+		return *this;
+	}
+	
+	~crc_task()
+	{
+		if (handle_)
+			handle_.destroy();
+	}
+	
+	//! Calculates the next slice.
+	//! 
+	//! \returns `true` if there is more to do.
+	auto resume() -> bool
+	{
+		if (!done())
+			handle_.resume();
+		return !done();
+	}
+	
+	//! \returns `true` once the calculation has finished or stopped.
+	auto done() const noexcept -> bool
+		{ return !handle_ || handle_.done(); }
+	
+	//! \returns The number of bytes done so far.
+	auto processed() const noexcept -> std::size_t
+		{ return handle_.promise().processed; }
+	
+	//! \returns The number of bytes in all.
+	auto size() const noexcept -> std::size_t
+		{ return handle_.promise().size; }
+	
+	//! \returns The CRC, once done, or nothing if the calculation was
+	//!          stopped (or is not done yet).
+	auto result() const noexcept -> std::optional<T>
+		{ return handle_.promise().result; }
+	
+	//! Runs the calculation from a coroutine, which carries on with the
+	//! result once it is done.
+	auto operator co_await() noexcept
+	{
+		struct awaiter
+		{
+			handle_type handle;
+			
+			auto await_ready() noexcept { return handle.done(); }
+			auto await_suspend(std::coroutine_handle<> awaiting) noexcept
+			{
+				handle.promise().continuation = awaiting;
+				return handle;
+			}
+			auto await_resume() noexcept { return handle.promise().result; }
+		};
+		return awaiter{handle_};
+	}
+	
+private:
+	explicit crc_task(handle_type handle) noexcept :
+		handle_(handle)
+	{}
+	
+	handle_type handle_;
+};
+
+namespace detail_ {
+
+// Suspends back to whoever resumed the calculation.
+struct async_suspend
+{
+	auto operator()() const noexcept { return std::suspend_always{}; }
+};
+
+// Gets the promise of the coroutine awaiting it, without suspending.
+template <typename Promise>
+struct async_promise
+{
+	Promise* promise = nullptr;
+	
+	auto await_ready() noexcept { return false; }
+	auto await_suspend(std::coroutine_handle<Promise> h) noexcept
+	{
+		promise = &h.promise();
+		return false;
+	}
+	auto await_resume() noexcept -> Promise& { return *promise; }
+};
+
+template <typename T, typename Engine, typename Yield>
+auto async_update(T init, T xorout, unsigned char const* first,
+	std::size_t size, Engine const& engine, async_options options,
+	Yield yield) -> crc_task<T>
+{
+	auto& promise = co_await async_promise<
+		typename crc_task<T>::promise_type>{};
+	promise.size = size;
+	
+	auto const budget = options.budget != 0u ? options.budget : size;
+	auto crc = init;
+	for (;;)
+	{
+		if (options.stop.stop_requested())
+			co_return std::nullopt;
+		
+		auto const left = size - promise.processed;
+		auto const slice = left < budget ? left : budget;
+		auto const next = first + promise.processed;
+		crc = T(engine.update(crc, next, next + slice));
+		promise.processed += slice;
+		
+		if (promise.processed == size)
+			co_return T(crc ^ xorout);
+		co_await yield();
+	}
+}
+
+} // namespace detail_
+
+//! Calculates a raw CRC a slice at a time, in a coroutine.
+//! 
+//! This gives the same CRC as `calculate_raw`. The buffer and the engine
+//! must outlive the task.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param init  The initial value.
+//! \param data  The buffer.
+//! \param size  The size of the buffer, in bytes.
+//! \param engine  The CRC engine (reflected).
+//! \param options  The most bytes per step, and what stops the
+//!     calculation.
+//! \param yield  Called between steps, it returns what to `co_await`:
+//!     by default, suspending back to whoever resumed the task. To
+//!     `co_await` the task from a coroutine, it has to schedule the
+//!     calculation to carry on later (on an event loop, say).
+//! 
+//! \returns The task, not started yet.
+template <std::size_t Bits, typename T, typename Engine,
+	typename Yield = detail_::async_suspend>
+auto async_calculate_raw(T init, void const* data, std::size_t size,
+		Engine const& engine, async_options options = {},
+		Yield yield = {}) ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value, crc_task<T>>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+	return detail_::async_update(init, T{0},
+		static_cast<unsigned char const*>(data), size, engine,
+		std::move(options), std::move(yield));
+}
+
+//! Calculates a CRC a slice at a time, in a coroutine.
+//! 
+//! This gives the same CRC as `calculate` (see `async_calculate_raw`).
+//! For example, a step at a time between other work:
+//! 
+//!     auto task = indi::crc::async_calculate<32>(data, size, engine,
+//!         {.budget = 256u << 10, .stop = token});
+//!     while (task.resume())
+//!         handle_requests();
+//!     if (auto const crc = task.result())
+//!         use(*crc);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param data  The buffer.
+//! \param size  The size of the buffer, in bytes.
+//! \param engine  The CRC engine (reflected).
+//! \param options  The most bytes per step, and what stops the
+//!     calculation.
+//! \param yield  Called between steps, it returns what to `co_await`.
+//! 
+//! \returns The task, not started yet.
+template <std::size_t Bits, typename Engine,
+	typename Yield = detail_::async_suspend>
+auto async_calculate(void const* data, std::size_t size,
+		Engine const& engine, async_options options = {},
+		Yield yield = {}) ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value,
+		crc_task<typename Engine::crc_type>>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+	using T = typename Engine::crc_type;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return detail_::async_update(ones, ones,
+		static_cast<unsigned char const*>(data), size, engine,
+		std::move(options), std::move(yield));
+}
+
+template <std::size_t Bits, typename Range, typename Engine,
+	typename Yield = detail_::async_suspend>
+auto async_calculate(Range const& range, Engine const& engine,
+		async_options options = {}, Yield yield = {}) ->
+	std::enable_if_t<detail_::is_contiguous_byte_range<Range>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		crc_task<typename Engine::crc_type>>
+{
+	return async_calculate<Bits>(range.data(), range.size(), engine,
+		std::move(options), std::move(yield));
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,359 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INDI_INC_CRC_BITSLICE_
+#define INDI_INC_CRC_BITSLICE_
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+
+// Bitsliced CRC calculation.
+//
+// A CRC step is linear: each bit of the CRC after a byte is the sum
+// (XOR) of some of the bits of the CRC before it and of the byte. With
+// the polynomial known at compile time, those sums are fixed, and can
+// be written out as XORs. Bitslicing does that for many messages at
+// once: bit `n` of every message's CRC is kept in one word (a "plane"),
+// with one message per bit, and so is every bit of their input bytes,
+// so each XOR works on all the messages together.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Swaps the top `J` bits of each word `k` with the bottom `J` bits of
+// word `k + J`, for each `k` with bit `J` clear. (The swaps are
+// expanded from templates, since -O2 won't unroll the loop over them.)
+template <unsigned J, typename Plane, std::size_t... Pair>
+auto transpose_round(Plane (&words)[64], std::uint64_t mask,
+	std::index_sequence<Pair...>) noexcept -> void
+{
+	using expand = int[];
+	(void)expand{0, ([&words, mask](std::size_t k)
+	{
+		auto const t = ((words[k] >> J) ^ words[k + J]) & mask;
+		words[k] ^= t << J;
+		words[k + J] ^= t;
+	}(Pair / J * 2u * J + Pair % J), 0)...};
+}
+
+// Transposes a 64 x 64 bit matrix, so that bit `m` of word `n` becomes
+// bit `n` of word `m`. With vectors of 64-bit words, that's done for
+// each element separately.
+template <typename Plane>
+auto transpose(Plane (&words)[64]) noexcept -> void
+{
+	constexpr auto pairs = std::make_index_sequence<32u>{};
+	transpose_round<32u>(words, 0x00000000FFFFFFFFu, pairs);
+	transpose_round<16u>(words, 0x0000FFFF0000FFFFu, pairs);
+	transpose_round<8u>(words, 0x00FF00FF00FF00FFu, pairs);
+	transpose_round<4u>(words, 0x0F0F0F0F0F0F0F0Fu, pairs);
+	transpose_round<2u>(words, 0x3333333333333333u, pairs);
+	transpose_round<1u>(words, 0x5555555555555555u, pairs);
+}
+
+#if INDI_CRC_HAVE_PCLMUL
+
+// Four 64-bit planes side by side, for 256 messages at once with AVX2.
+typedef std::uint64_t wide_plane __attribute__((vector_size(32)));
+
+// Everything the AVX2 code calls has to be inlined into it to be
+// compiled for AVX2 too.
+#define INDI_CRC_TARGET_BITSLICE __attribute__((target("avx2"), flatten))
+
+#endif
+
+} // namespace detail_
+
+//! A CRC engine that calculates the CRCs of many messages of the same
+//! length at once, by bitslicing.
+//! 
+//! Every bit of the CRC after a byte is the XOR of some of the bits of
+//! the CRC and of the byte before. Which ones depends only on the
+//! polynomial, so with the polynomial as a template argument, the
+//! compiler turns each step into a fixed network of XORs. The engine
+//! keeps each bit of the CRCs of 64 messages in one 64-bit word, and
+//! transposes their input into words the same way (8 bytes of every
+//! message at a time), so each XOR works on 64 messages. With GCC or
+//! Clang on x86 CPUs with AVX2, it works on 256 messages at a time, in
+//! 256-bit words.
+//! 
+//! That suits large numbers of short messages of the same length, like
+//! fieldbus or telemetry frames: there's no setup per message, and no
+//! table. The transposes cost the same whatever the CRC, but the XOR
+//! network grows with the number of bits set in the polynomial.
+//! 
+//! Use the `bitsliced_engine` (reflected) and `normal_bitsliced_engine`
+//! (non-reflected) aliases:
+//! 
+//!     auto const engine = indi::crc::bitsliced_engine<16,
+//!         indi::crc::polynomials::crc16_ibm>{};
+//!     engine.update(0xFFFFu, frames, count, length, crcs);
+//! 
+//! \tparam Bits  The CRC bit-size (at most 32).
+//! \tparam T  The CRC type.
+//! \tparam Polynomial  The encoded polynomial value.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+template <std::size_t Bits, typename T, T Polynomial, bool Reflected>
+class basic_bitsliced_engine
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0u && Bits <= 32u,
+		"bitslicing supports 1 to 32-bit CRCs");
+
+public:
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto polynomial = Polynomial;
+	static constexpr auto reflected = Reflected;
+	
+	//! Calculates the raw CRCs of messages of the same length.
+	//! 
+	//! The messages are worked on in groups of 64 (or 256, with AVX2).
+	//! Any number of messages can be given, but the last group costs as
+	//! much as a full one.
+	//! 
+	//! \param crc  The raw CRC of the sequence preceding every message
+	//!     (or the initial value).
+	//! \param messages  Pointers to the first byte of each message.
+	//! \param count  The number of messages.
+	//! \param length  The length of every message, in bytes.
+	//! \param crcs  Where to write the raw CRC of each message.
+	auto update(T crc, unsigned char const* const* messages,
+		std::size_t count, std::size_t length, T* crcs) const noexcept
+		-> void
+	{
+		auto first = std::size_t{0};
+		
+#if INDI_CRC_HAVE_PCLMUL
+		// A wide group costs about as much as a narrow one.
+		if (detail_::cpu().avx2)
+		{
+			for (; first + 64u < count; first += 256u)
+				update_wide(crc, messages + first, count - first, length,
+					crcs + first);
+		}
+#endif
+		
+		for (; first < count; first += 64u)
+			update_group<std::uint64_t>(crc, messages + first,
+				count - first, length, crcs + first);
+	}
+
+private:
+	// The CRC is worked on as a shift register, bit by bit, with
+	// register bit 0 at the end the bits are shifted out of. That's CRC
+	// bit `n` for reflected CRCs, and CRC bit `Bits - 1 - n` for
+	// non-reflected ones, which makes the taps the bits of the reversed
+	// polynomial either way.
+	static constexpr auto taps = polynomials::reversed<Bits>(Polynomial);
+	
+	static constexpr auto register_bit(std::size_t n) noexcept
+	{
+		return Reflected ? n : Bits - 1u - n;
+	}
+	
+	// The taps other than the top one (where the feedback bit just
+	// replaces the bit shifted out), counted and listed.
+	static constexpr auto tap_count() noexcept
+	{
+		auto count = std::size_t{0};
+		for (auto n = std::size_t{0}; n + 1u < Bits; ++n)
+			count += (taps >> n) & 1u;
+		return count;
+	}
+	
+	static constexpr auto tap(std::size_t index) noexcept
+	{
+		auto n = std::size_t{0};
+		for (; n + 1u < Bits; ++n)
+			if (((taps >> n) & 1u) && index-- == 0u)
+				break;
+		return n;
+	}
+	
+	// Shifts every message's next input bit through the register, which
+	// starts at `window[0]`; afterwards it starts at `window[1]`.
+	// (The taps are expanded from templates, since -O2 won't unroll
+	// the loop over them.)
+	template <typename Plane, std::size_t... Tap>
+	static auto shift(Plane* window, Plane const& bits,
+		std::index_sequence<Tap...>) noexcept
+	{
+		auto const feedback = window[0] ^ bits;
+		window[Bits] = ((taps >> (Bits - 1u)) & 1u) ? feedback : Plane{};
+		
+		using expand = int[];
+		(void)expand{0, (window[1u + tap(Tap)] ^= feedback, 0)...};
+	}
+	
+	// Reads up to 8 bytes little-endian, so byte `n` is in bits `8 * n`
+	// up.
+	// (Compilers turn the full 8 bytes into a single load.)
+	static auto load(unsigned char const* p, std::size_t size) noexcept
+	{
+		if (size == 8u)
+		{
+			return std::uint64_t{p[0]} |
+				(std::uint64_t{p[1]} << 8) |
+				(std::uint64_t{p[2]} << 16) |
+				(std::uint64_t{p[3]} << 24) |
+				(std::uint64_t{p[4]} << 32) |
+				(std::uint64_t{p[5]} << 40) |
+				(std::uint64_t{p[6]} << 48) |
+				(std::uint64_t{p[7]} << 56);
+		}
+		
+		auto w = std::uint64_t{0u};
+		for (auto n = std::size_t{0}; n < size; ++n)
+			w |= std::uint64_t{p[n]} << (8u * n);
+		return w;
+	}
+	
+	// Loads the next bytes of message `m` (and of messages `m + 64`,
+	// `m + 128`, and `m + 192` into a wide plane).
+	static auto load(unsigned char const* const* group, std::size_t m,
+		std::size_t offset, std::size_t size, std::uint64_t& plane)
+		noexcept
+	{
+		plane = load(group[m] + offset, size);
+	}
+	
+#if INDI_CRC_HAVE_PCLMUL
+	static auto load(unsigned char const* const* group, std::size_t m,
+		std::size_t offset, std::size_t size, detail_::wide_plane& plane)
+		noexcept
+	{
+		plane = detail_::wide_plane{
+			load(group[m] + offset, size),
+			load(group[m + 64u] + offset, size),
+			load(group[m + 128u] + offset, size),
+			load(group[m + 192u] + offset, size)};
+	}
+	
+	static auto store(detail_::wide_plane const& plane, std::size_t n)
+		noexcept
+	{
+		return plane[n];
+	}
+#endif
+	
+	static auto store(std::uint64_t plane, std::size_t) noexcept
+	{
+		return plane;
+	}
+	
+	// Shifts `count` bits of every message's input through the
+	// register, and moves the register back to the start of the window.
+	template <typename Plane>
+	static auto shift_all(Plane* window, Plane const (&words)[64],
+		std::size_t count) noexcept
+	{
+		// After the transpose, word `8 * p + k` holds bit `k` of byte
+		// `p` of every message; non-reflected CRCs take the bits of a
+		// byte from the top down.
+		constexpr auto order = Reflected ? 0u : 7u;
+		
+		for (auto n = std::size_t{0}; n < count; ++n)
+			shift(window + n, words[n ^ order],
+				std::make_index_sequence<tap_count()>{});
+		
+		for (auto n = std::size_t{0}; n < Bits; ++n)
+			window[n] = window[count + n];
+	}
+	
+	// Works out the CRCs of up to a group's worth of messages. Short
+	// groups are filled up with the first message.
+	template <typename Plane>
+	static auto update_group(T init, unsigned char const* const* messages,
+		std::size_t count, std::size_t length, T* crcs) noexcept -> void
+	{
+		constexpr auto lanes = sizeof(Plane) * CHAR_BIT;
+		
+		unsigned char const* group[lanes];
+		for (auto m = std::size_t{0}; m < lanes; ++m)
+			group[m] = messages[m < count ? m : 0u];
+		
+		// The register slides along the window as bits are shifted in.
+		Plane window[Bits + 64u];
+		for (auto n = std::size_t{0}; n < Bits; ++n)
+			window[n] = ((init >> register_bit(n)) & 1u) ? ~Plane{} :
+				Plane{};
+		
+		Plane words[64];
+		for (auto offset = std::size_t{0}; offset < length; offset += 8u)
+		{
+			auto const size = length - offset < 8u ? length - offset : 8u;
+			for (auto m = std::size_t{0}; m < 64u; ++m)
+				load(group, m, offset, size, words[m]);
+			detail_::transpose(words);
+			shift_all(window, words, 8u * size);
+		}
+		
+		for (auto n = std::size_t{0}; n < 64u; ++n)
+			words[n] = Plane{};
+		for (auto n = std::size_t{0}; n < Bits; ++n)
+			words[register_bit(n)] = window[n];
+		detail_::transpose(words);
+		
+		for (auto m = std::size_t{0}; m < lanes && m < count; ++m)
+			crcs[m] = T(store(words[m % 64u], m / 64u));
+	}
+	
+#if INDI_CRC_HAVE_PCLMUL
+	INDI_CRC_TARGET_BITSLICE
+	static auto update_wide(T init, unsigned char const* const* messages,
+		std::size_t count, std::size_t length, T* crcs) noexcept -> void
+	{
+		update_group<detail_::wide_plane>(init, messages, count, length,
+			crcs);
+	}
+#endif
+};
+
+//! A reflected CRC engine that calculates the CRCs of 64 messages at
+//! once.
+//! 
+//! \see basic_bitsliced_engine
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+using bitsliced_engine = basic_bitsliced_engine<Bits, crc_type_t<Bits>,
+	Polynomial, true>;
+
+//! A non-reflected (MSB-first) CRC engine that calculates the CRCs of
+//! 64 messages at once.
+//! 
+//! \see basic_bitsliced_engine
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+using normal_bitsliced_engine = basic_bitsliced_engine<Bits,
+	crc_type_t<Bits>, Polynomial, false>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
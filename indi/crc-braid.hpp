@@ -0,0 +1,401 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_BRAID_
+#define INDI_INC_CRC_BRAID_
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+
+// Braided CRC calculation, as described by Kadatch and Jenkins, and as
+// used by zlib.
+//
+// A table-driven CRC is limited by the latency of its lookups: each one
+// needs the result of the one before. Braiding splits the input into
+// `Braids` interleaved streams of 64-bit words, whose CRCs don't depend
+// on each other, so the CPU can work on all of them at once. Each
+// stream's CRC is carried past the words of the other streams by the
+// tables, and the streams are brought back together at the end.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Generates the braid tables for a reflected CRC. Entry `n` of table
+// `k` is the CRC of byte value `n` at byte `k` of a little-endian word,
+// carried through the rest of the word and the words of the other
+// braids.
+template <std::size_t Bits, std::size_t Braids, typename Entry,
+	typename T>
+constexpr auto braid_tables(T polynomial, std::true_type /* reflected */)
+	noexcept
+{
+	auto const table = generate_table<Bits>(polynomial);
+	auto tables = std::array<std::array<Entry, 256>, 8>{};
+	
+	for (auto k = std::size_t{0}; k < 8u; ++k)
+	{
+		for (auto bit = std::size_t{0}; bit < 8u; ++bit)
+		{
+			auto crc = std::uint64_t{1u} << (8u * k + bit);
+			for (auto step = std::size_t{0}; step < 8u * Braids; ++step)
+				crc = (crc >> 8) ^ table[crc & 0xFFu];
+			tables[k][std::size_t{1u} << bit] = Entry(crc);
+		}
+		
+		// CRCs are linear, so the other entries are sums of those.
+		for (auto n = std::size_t{1}; n < 256u; ++n)
+			tables[k][n] = Entry(tables[k][n & (n - 1u)] ^
+				tables[k][n & (~n + 1u)]);
+	}
+	
+	return tables;
+}
+
+// Generates the braid tables for a non-reflected CRC, with words read
+// big-endian. The CRC is worked out at the top of a 64-bit value, so
+// the CRC only needs shifting when a table entry is used.
+template <std::size_t Bits, std::size_t Braids, typename Entry,
+	typename T>
+constexpr auto braid_tables(T polynomial, std::false_type /* reflected */)
+	noexcept
+{
+	constexpr auto shift = unsigned(64u - Bits);
+	
+	auto const table = generate_normal_table<Bits>(polynomial);
+	auto tables = std::array<std::array<Entry, 256>, 8>{};
+	
+	for (auto k = std::size_t{0}; k < 8u; ++k)
+	{
+		for (auto bit = std::size_t{0}; bit < 8u; ++bit)
+		{
+			auto crc = std::uint64_t{1u} << (56u - 8u * k + bit);
+			for (auto step = std::size_t{0}; step < 8u * Braids; ++step)
+				crc = (crc << 8) ^
+					(std::uint64_t(table[crc >> 56]) << shift);
+			tables[k][std::size_t{1u} << bit] = Entry(crc >> shift);
+		}
+		
+		for (auto n = std::size_t{1}; n < 256u; ++n)
+			tables[k][n] = Entry(tables[k][n & (n - 1u)] ^
+				tables[k][n & (~n + 1u)]);
+	}
+	
+	return tables;
+}
+
+template <typename Entry, typename T>
+constexpr auto narrow_table(std::array<T, 256> const& table) noexcept
+{
+	auto result = std::array<Entry, 256>{};
+	for (auto n = std::size_t{0}; n < 256u; ++n)
+		result[n] = Entry(table[n]);
+	return result;
+}
+
+} // namespace detail_
+
+//! Generates the tables for braided CRC calculations.
+//! 
+//! Entry `n` of table `k` is the raw CRC of the byte value `n` at byte
+//! `k` of a 64-bit little-endian word, followed by the rest of the
+//! word, and by `Braids - 1` words of zeros. See `braided_engine`.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Braids  The number of interleaved words.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns An std::array of 8 std::array<T, 256> tables.
+template <std::size_t Bits, std::size_t Braids = 5, typename T>
+constexpr auto generate_braid_tables(T polynomial) noexcept
+{
+	static_assert(Braids > 0u, "there must be at least one braid");
+	
+	return detail_::braid_tables<Bits, Braids, T>(polynomial,
+		std::true_type{});
+}
+
+//! Generates the tables for braided non-reflected (MSB-first) CRC
+//! calculations.
+//! 
+//! Like `generate_braid_tables`, only for non-reflected CRCs, with
+//! words read big-endian (so byte `k` of a word is still byte `k` in
+//! memory).
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Braids  The number of interleaved words.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns An std::array of 8 std::array<T, 256> tables.
+template <std::size_t Bits, std::size_t Braids = 5, typename T>
+constexpr auto generate_normal_braid_tables(T polynomial) noexcept
+{
+	static_assert(Braids > 0u, "there must be at least one braid");
+	
+	return detail_::braid_tables<Bits, Braids, T>(polynomial,
+		std::false_type{});
+}
+
+//! A CRC engine that braids table lookups.
+//! 
+//! This calculates CRCs of any width up to 64 bits, for any polynomial,
+//! in portable C++. The input is read as 64-bit words, and `Braids`
+//! consecutive words at a time are each carried forward by eight
+//! lookups, independently of each other. The independent lookups keep
+//! the CPU busy where a plain table-driven CRC waits for each lookup
+//! in turn; with the default of 5 braids, it's several times faster
+//! than a 256-element table. The tables take 9 KB for a 32-bit CRC
+//! (18 KB for 64 bits), and can be generated at compile time (from
+//! C++17).
+//! 
+//! `clmul_engine` uses this engine when the CPU (or the compiler)
+//! doesn't support carry-less multiplication.
+//! 
+//! Use the `braided_engine` (reflected) and `normal_braided_engine`
+//! (non-reflected) aliases. Like a lookup table, a reflected engine
+//! can be passed to `calculate` and `calculate_raw`, and a
+//! non-reflected one to `calculate_normal_raw`:
+//! 
+//!     auto const engine = indi::crc::braided_engine<32>{
+//!         indi::crc::polynomials::crc32};
+//!     auto const crc = indi::crc::calculate<32>(data, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+//! \tparam Braids  The number of interleaved words.
+template <std::size_t Bits, typename T, bool Reflected,
+	std::size_t Braids = 5>
+class basic_braided_engine
+{
+	static_assert(Bits > 0u && Bits <= 64u,
+		"braiding supports 1 to 64-bit CRCs");
+	static_assert(Braids > 0u, "there must be at least one braid");
+
+public:
+	using crc_engine_tag = void;
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto reflected = Reflected;
+	
+	//! The table entries are the smallest type that holds a CRC.
+	using entry_type = detail_::crc_least_t<Bits>;
+	using table_type = std::array<entry_type, 256>;
+	using braid_tables_type = std::array<table_type, 8>;
+	
+	//! Creates an engine.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	constexpr explicit basic_braided_engine(T polynomial) noexcept :
+		braid_tables_(detail_::braid_tables<Bits, Braids, entry_type>(
+			polynomial, is_reflected{})),
+		table_(detail_::narrow_table<entry_type>(Reflected ?
+			generate_table<Bits>(polynomial) :
+			generate_normal_table<Bits>(polynomial)))
+	{}
+	
+	//! Calculates the raw CRC of a sequence of bytes.
+	//! 
+	//! \param crc  The raw CRC of the preceding sequence (or the
+	//!     initial value).
+	//! \param first  The start of the sequence.
+	//! \param last  The end of the sequence.
+	//! 
+	//! \returns The raw CRC.
+	constexpr auto update(T crc, unsigned char const* first,
+		unsigned char const* last) const noexcept -> T
+	{
+		constexpr auto block = 8u * Braids;
+		
+		// Non-reflected CRCs are worked out at the top of a 64-bit
+		// value, so the words can be added to them as they are.
+		auto x = Reflected ? std::uint64_t(crc) :
+			std::uint64_t(std::uint64_t(crc) << shift);
+		
+		auto length = static_cast<std::size_t>(last - first);
+		if (length >= block)
+		{
+			auto const blocks = length / block;
+			
+			// The first braid carries on from `crc`; the others start
+			// from 0.
+			std::uint64_t braids[Braids] = {};
+			braids[0] = x;
+			
+			for (auto n = std::size_t{1}; n < blocks; ++n)
+			{
+				for (auto b = std::size_t{0}; b < Braids; ++b)
+					braids[b] = braid(braids[b] ^ load(first + 8u * b,
+						is_reflected{}), is_reflected{});
+				first += block;
+			}
+			
+			// Every braid is now carried up to its word in the last
+			// block, where they're brought back together.
+			x = 0u;
+			for (auto b = std::size_t{0}; b < Braids; ++b)
+				x = word(x ^ braids[b] ^ load(first + 8u * b,
+					is_reflected{}), is_reflected{});
+			first += block;
+		}
+		
+		for (; first != last; ++first)
+			x = next(x, *first, is_reflected{});
+		
+		return Reflected ? T(x) : T(x >> shift);
+	}
+	
+	//! Gets the braid tables.
+	constexpr auto braid_tables() const noexcept
+		-> braid_tables_type const&
+	{
+		return braid_tables_;
+	}
+	
+	//! Gets the lookup table, used for short inputs and tails.
+	constexpr auto table() const noexcept -> table_type const&
+	{
+		return table_;
+	}
+
+private:
+	using is_reflected = std::integral_constant<bool, Reflected>;
+	
+	static constexpr auto shift = Reflected ? 0u : unsigned(64u - Bits);
+	
+	// Reads a word, so that byte 0 is the first to be added to the CRC.
+	// Compilers turn these into single loads (with a byte swap where
+	// needed).
+	static constexpr auto load(unsigned char const* p,
+		std::true_type /* reflected */) noexcept
+	{
+		return std::uint64_t{p[0]} |
+			(std::uint64_t{p[1]} << 8) |
+			(std::uint64_t{p[2]} << 16) |
+			(std::uint64_t{p[3]} << 24) |
+			(std::uint64_t{p[4]} << 32) |
+			(std::uint64_t{p[5]} << 40) |
+			(std::uint64_t{p[6]} << 48) |
+			(std::uint64_t{p[7]} << 56);
+	}
+	
+	static constexpr auto load(unsigned char const* p,
+		std::false_type /* reflected */) noexcept
+	{
+		return (std::uint64_t{p[0]} << 56) |
+			(std::uint64_t{p[1]} << 48) |
+			(std::uint64_t{p[2]} << 40) |
+			(std::uint64_t{p[3]} << 32) |
+			(std::uint64_t{p[4]} << 24) |
+			(std::uint64_t{p[5]} << 16) |
+			(std::uint64_t{p[6]} << 8) |
+			std::uint64_t{p[7]};
+	}
+	
+	// Carries a word (with a braid's CRC added) past the words of the
+	// other braids.
+	constexpr auto braid(std::uint64_t w, std::true_type /* reflected */)
+		const noexcept
+	{
+		return std::uint64_t(
+			braid_tables_[0][w & 0xFFu] ^
+			braid_tables_[1][(w >> 8) & 0xFFu] ^
+			braid_tables_[2][(w >> 16) & 0xFFu] ^
+			braid_tables_[3][(w >> 24) & 0xFFu] ^
+			braid_tables_[4][(w >> 32) & 0xFFu] ^
+			braid_tables_[5][(w >> 40) & 0xFFu] ^
+			braid_tables_[6][(w >> 48) & 0xFFu] ^
+			braid_tables_[7][w >> 56]);
+	}
+	
+	constexpr auto braid(std::uint64_t w, std::false_type /* reflected */)
+		const noexcept
+	{
+		return std::uint64_t(std::uint64_t(
+			braid_tables_[0][w >> 56] ^
+			braid_tables_[1][(w >> 48) & 0xFFu] ^
+			braid_tables_[2][(w >> 40) & 0xFFu] ^
+			braid_tables_[3][(w >> 32) & 0xFFu] ^
+			braid_tables_[4][(w >> 24) & 0xFFu] ^
+			braid_tables_[5][(w >> 16) & 0xFFu] ^
+			braid_tables_[6][(w >> 8) & 0xFFu] ^
+			braid_tables_[7][w & 0xFFu]) << shift);
+	}
+	
+	// Carries a word (with the CRC added) past itself, a byte at a time.
+	template <typename Reflection>
+	constexpr auto word(std::uint64_t w, Reflection reflection)
+		const noexcept
+	{
+		for (auto n = 0u; n < 8u; ++n)
+			w = next(w, 0u, reflection);
+		return w;
+	}
+	
+	constexpr auto next(std::uint64_t x, unsigned char b,
+		std::true_type /* reflected */) const noexcept
+	{
+		return (x >> 8) ^ table_[(x ^ b) & 0xFFu];
+	}
+	
+	constexpr auto next(std::uint64_t x, unsigned char b,
+		std::false_type /* reflected */) const noexcept
+	{
+		return (x << 8) ^
+			(std::uint64_t(table_[(x >> 56) ^ b]) << shift);
+	}
+	
+	alignas(64) braid_tables_type braid_tables_;
+	table_type table_;
+};
+
+//! A reflected CRC engine that braids table lookups.
+//! 
+//! \see basic_braided_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>,
+	std::size_t Braids = 5>
+using braided_engine = basic_braided_engine<Bits, T, true, Braids>;
+
+//! A non-reflected (MSB-first) CRC engine that braids table lookups.
+//! 
+//! \see basic_braided_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>,
+	std::size_t Braids = 5>
+using normal_braided_engine = basic_braided_engine<Bits, T, false, Braids>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
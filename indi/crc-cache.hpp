@@ -0,0 +1,493 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_CACHE_
+#define INDI_INC_CRC_CACHE_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(__linux__)
+#include <sys/xattr.h>
+#endif
+
+#include "indi/crc-file.hpp"
+
+// Checksum cache.
+//
+// Like `indi/crc-file.hpp`, this is written against the POSIX file API.
+// Extended attributes are only used on Linux; elsewhere, only the
+// sidecar database is.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Prefix of the extended attribute names. The model name is appended.
+constexpr auto cache_xattr_prefix = "user.indi.crc.";
+
+// First line of the sidecar database.
+constexpr auto cache_database_header = "indi-crc-cache 1";
+
+// How far past the current time the status change time deadline of an
+// extended attribute is set (see `checksum_cache`).
+constexpr auto cache_xattr_ctime_slack_ns = std::int_least64_t{10000000};
+
+inline auto nanoseconds(struct ::timespec const& t) noexcept
+{
+	return static_cast<std::int_least64_t>(t.tv_sec) * 1000000000 +
+		t.tv_nsec;
+}
+
+} // namespace detail_
+
+//! A cached checksum, along with the file state it is valid for.
+struct cache_record
+{
+	std::uintmax_t crc = 0;
+	std::uint_least64_t size = 0;
+	std::int_least64_t mtime_ns = 0;
+	std::int_least64_t ctime_ns = 0;
+	
+	//! Makes a record of a file's current state.
+	static auto from_stat(struct ::stat const& st, std::uintmax_t crc)
+		noexcept -> cache_record
+	{
+		auto r = cache_record{};
+		r.crc = crc;
+		r.size = static_cast<std::uint_least64_t>(st.st_size);
+		r.mtime_ns = detail_::nanoseconds(st.st_mtim);
+		r.ctime_ns = detail_::nanoseconds(st.st_ctim);
+		return r;
+	}
+	
+	//! Checks whether the record is for the file state in `st`.
+	auto matches(struct ::stat const& st) const noexcept -> bool
+	{
+		return size == static_cast<std::uint_least64_t>(st.st_size) &&
+			mtime_ns == detail_::nanoseconds(st.st_mtim) &&
+			ctime_ns == detail_::nanoseconds(st.st_ctim);
+	}
+	
+	//! Checks whether the record is for the file state in `st`, taking
+	//! `ctime_ns` as the latest status change time allowed rather than
+	//! the exact one.
+	auto matches_until(struct ::stat const& st) const noexcept -> bool
+	{
+		return size == static_cast<std::uint_least64_t>(st.st_size) &&
+			mtime_ns == detail_::nanoseconds(st.st_mtim) &&
+			detail_::nanoseconds(st.st_ctim) <= ctime_ns;
+	}
+};
+
+//! Cache of file checksums.
+//! 
+//! Checksums are stored in an extended attribute of the file itself,
+//! named `user.indi.crc.` followed by the model name, holding the CRC,
+//! the file size, and the modification and status change times in
+//! nanoseconds. A cached checksum is only trusted while the file's
+//! size and modification time are unchanged, so any write to the file
+//! invalidates it.
+//! 
+//! Where extended attributes are not available (the filesystem doesn't
+//! support them, or the file is read-only to us), an optional sidecar
+//! database is used instead, keyed by device and inode number. It is
+//! loaded when the cache is created, and written back by `save`.
+//! The status change time is checked too, so the cache isn't fooled by
+//! a write that was hidden by setting the modification time back.
+//! Database entries require it to match exactly. Setting an extended
+//! attribute updates the status change time itself, to a time that
+//! can't be known beforehand, so extended attributes hold a deadline
+//! instead, a few milliseconds after the attribute is set (and checked
+//! to have been met); any later status change invalidates them.
+//! 
+//! Cache errors are never fatal: a checksum that can't be stored is
+//! simply calculated again next time.
+//! 
+//! All the member functions are thread-safe.
+class checksum_cache
+{
+public:
+	//! Creates a cache.
+	//! 
+	//! \param database  The sidecar database path, or empty for none.
+	//!     If the file exists, it is loaded.
+	//! \param use_xattrs  Whether to use extended attributes. If false,
+	//!     only the database is used.
+	//! 
+	//! \throws std::system_error if the database exists but could not
+	//!     be read.
+	explicit checksum_cache(std::string database = {},
+			bool use_xattrs = true) :
+		database_path_(std::move(database)),
+		use_xattrs_(use_xattrs)
+	{
+		if (!database_path_.empty())
+			load();
+	}
+	
+	//! Saves the database, ignoring any errors.
+	~checksum_cache()
+	{
+		try
+		{
+			save();
+		}
+		catch (...)
+		{}
+	}
+	
+	checksum_cache(checksum_cache const&) = delete;
+	auto operator=(checksum_cache const&) -> checksum_cache& = delete;
+	
+	//! Looks up a file's checksum.
+	//! 
+	//! \param path  The path of the file.
+	//! \param st  The file's current status, from `stat`.
+	//! \param model  The name of the CRC model.
+	//! \param crc  Set to the cached CRC, if there is one.
+	//! 
+	//! \returns True if a valid checksum was found.
+	auto find(std::string const& path, struct ::stat const& st,
+		std::string const& model, std::uintmax_t& crc) -> bool
+	{
+		auto r = cache_record{};
+		
+		if (!(read_xattr(path, model, r) && r.matches_until(st)) &&
+				!(read_database(st, model, r) && r.matches(st)))
+			return false;
+		
+		crc = r.crc;
+		return true;
+	}
+	
+	//! Stores a file's checksum.
+	//! 
+	//! Nothing is stored if the file has changed since `st` was taken,
+	//! which would mean it changed while the checksum was being
+	//! calculated.
+	//! 
+	//! \param path  The path of the file.
+	//! \param st  The file's status from before it was read.
+	//! \param model  The name of the CRC model.
+	//! \param crc  The CRC.
+	//! 
+	//! \returns True if the checksum was stored.
+	auto store(std::string const& path, struct ::stat const& st,
+		std::string const& model, std::uintmax_t crc) -> bool
+	{
+		struct ::stat now;
+		if (::stat(path.c_str(), &now) != 0 || !same_file(st, now) ||
+				!cache_record::from_stat(st, crc).matches(now))
+			return false;
+		
+		return write_xattr(path, model, now, crc) ||
+			write_database(now, model, crc);
+	}
+	
+	//! Writes the database back, if it has changed.
+	//! 
+	//! The new database is written next to the old one, then renamed
+	//! over it, so a crash never leaves a half-written database.
+	//! 
+	//! \throws std::system_error if the database could not be written.
+	auto save() -> void
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		
+		if (database_path_.empty() || !dirty_)
+			return;
+		
+		auto const temp = database_path_ + ".tmp";
+		auto const f = std::fopen(temp.c_str(), "w");
+		if (!f)
+			detail_::throw_errno(temp);
+		
+		std::fprintf(f, "%s\n", detail_::cache_database_header);
+		for (auto const& entry : database_)
+		{
+			auto const& r = entry.second;
+			std::fprintf(f, "%llu %llu %s %llx %llu %lld %lld\n",
+				static_cast<unsigned long long>(std::get<0>(entry.first)),
+				static_cast<unsigned long long>(std::get<1>(entry.first)),
+				std::get<2>(entry.first).c_str(),
+				static_cast<unsigned long long>(r.crc),
+				static_cast<unsigned long long>(r.size),
+				static_cast<long long>(r.mtime_ns),
+				static_cast<long long>(r.ctime_ns));
+		}
+		
+		auto const failed = std::ferror(f) != 0;
+		if (std::fclose(f) != 0 || failed ||
+				std::rename(temp.c_str(), database_path_.c_str()) != 0)
+		{
+			auto const e = errno;
+			std::remove(temp.c_str());
+			throw std::system_error{e, std::generic_category(),
+				database_path_};
+		}
+		
+		dirty_ = false;
+	}
+
+private:
+	using key = std::tuple<std::uint_least64_t, std::uint_least64_t,
+		std::string>;
+	
+	static auto make_key(struct ::stat const& st, std::string const& model)
+		-> key
+	{
+		return key{static_cast<std::uint_least64_t>(st.st_dev),
+			static_cast<std::uint_least64_t>(st.st_ino), model};
+	}
+	
+	static auto same_file(struct ::stat const& a, struct ::stat const& b)
+		noexcept -> bool
+	{
+		return a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+	}
+	
+	static auto parse(char const* text, cache_record& r) -> bool
+	{
+		auto crc = 0uLL;
+		auto size = 0uLL;
+		auto mtime = 0LL;
+		auto ctime = 0LL;
+		if (std::sscanf(text, "%llx %llu %lld %lld", &crc, &size, &mtime,
+				&ctime) != 4)
+			return false;
+		
+		r.crc = crc;
+		r.size = size;
+		r.mtime_ns = mtime;
+		r.ctime_ns = ctime;
+		return true;
+	}
+	
+	auto read_xattr(std::string const& path, std::string const& model,
+		cache_record& r) -> bool
+	{
+#if defined(__linux__)
+		if (!use_xattrs_)
+			return false;
+		
+		auto const name = detail_::cache_xattr_prefix + model;
+		
+		char buffer[128];
+		auto const length = ::getxattr(path.c_str(), name.c_str(), buffer,
+			sizeof(buffer) - 1u);
+		if (length < 0)
+			return false;
+		
+		buffer[length] = '\0';
+		return parse(buffer, r);
+#else
+		static_cast<void>(path);
+		static_cast<void>(model);
+		static_cast<void>(r);
+		return false;
+#endif
+	}
+	
+	auto write_xattr(std::string const& path, std::string const& model,
+		struct ::stat const& st, std::uintmax_t crc) -> bool
+	{
+#if defined(__linux__)
+		if (!use_xattrs_)
+			return false;
+		
+		auto const name = detail_::cache_xattr_prefix + model;
+		auto r = cache_record::from_stat(st, crc);
+		
+		// Setting the attribute updates the status change time, so
+		// record a deadline for it instead.
+		struct ::timespec now;
+		if (::clock_gettime(CLOCK_REALTIME, &now) != 0)
+			return false;
+		r.ctime_ns = std::max(r.ctime_ns, detail_::nanoseconds(now)) +
+			detail_::cache_xattr_ctime_slack_ns;
+		
+		char buffer[128];
+		auto const length = std::snprintf(buffer, sizeof(buffer),
+			"%llx %llu %lld %lld",
+			static_cast<unsigned long long>(r.crc),
+			static_cast<unsigned long long>(r.size),
+			static_cast<long long>(r.mtime_ns),
+			static_cast<long long>(r.ctime_ns));
+		
+		if (::setxattr(path.c_str(), name.c_str(), buffer,
+				static_cast<std::size_t>(length), 0) != 0)
+			return false;
+		
+		// If the deadline was missed (or the file changed meanwhile), the
+		// record would never match, so don't leave it behind.
+		struct ::stat after;
+		if (::stat(path.c_str(), &after) != 0 || !same_file(st, after) ||
+				!r.matches_until(after))
+		{
+			::removexattr(path.c_str(), name.c_str());
+			return false;
+		}
+		
+		return true;
+#else
+		static_cast<void>(path);
+		static_cast<void>(model);
+		static_cast<void>(st);
+		static_cast<void>(crc);
+		return false;
+#endif
+	}
+	
+	auto read_database(struct ::stat const& st, std::string const& model,
+		cache_record& r) -> bool
+	{
+		if (database_path_.empty())
+			return false;
+		
+		std::lock_guard<std::mutex> lock{mutex_};
+		
+		auto const it = database_.find(make_key(st, model));
+		if (it == database_.end())
+			return false;
+		
+		r = it->second;
+		return true;
+	}
+	
+	auto write_database(struct ::stat const& st, std::string const& model,
+		std::uintmax_t crc) -> bool
+	{
+		if (database_path_.empty())
+			return false;
+		
+		std::lock_guard<std::mutex> lock{mutex_};
+		
+		database_[make_key(st, model)] = cache_record::from_stat(st, crc);
+		dirty_ = true;
+		return true;
+	}
+	
+	auto load() -> void
+	{
+		auto const f = std::fopen(database_path_.c_str(), "r");
+		if (!f)
+		{
+			if (errno == ENOENT)
+				return;
+			detail_::throw_errno(database_path_);
+		}
+		
+		char line[512];
+		
+		// A database in any other format is ignored, and overwritten on
+		// the next save.
+		if (std::fgets(line, sizeof(line), f) &&
+				std::string{line} ==
+					std::string{detail_::cache_database_header} + "\n")
+		{
+			while (std::fgets(line, sizeof(line), f))
+			{
+				auto dev = 0uLL;
+				auto ino = 0uLL;
+				char model[64];
+				auto offset = 0;
+				
+				auto r = cache_record{};
+				if (std::sscanf(line, "%llu %llu %63s %n", &dev, &ino, model,
+						&offset) == 3 && parse(line + offset, r))
+					database_[key{dev, ino, model}] = r;
+			}
+		}
+		
+		std::fclose(f);
+	}
+	
+	std::string const database_path_;
+	bool const use_xattrs_;
+	
+	std::mutex mutex_;
+	std::map<key, cache_record> database_;
+	bool dirty_ = false;
+};
+
+//! Calculates the CRC of a file, using a checksum cache.
+//! 
+//! If `cache` holds a valid checksum for the file, it is returned
+//! without the file being opened; otherwise the CRC is calculated and
+//! stored in the cache.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Table  The lookup table type.
+//! \tparam T  The CRC type.
+//! 
+//! \param path  The path of the file.
+//! \param table  The lookup table.
+//! \param cache  The cache.
+//! \param model  A name identifying the CRC model (polynomial and
+//!     width), used as the cache key.
+//! \param bytes_read  If not null, set to the size of the file.
+//! 
+//! \throws std::system_error if the file could not be opened or read.
+//! 
+//! \returns The computed CRC.
+template <std::size_t Bits, typename Table, typename T = crc_type_t<Bits>>
+auto calculate_file(std::string const& path, Table const& table,
+		checksum_cache& cache, std::string const& model,
+		std::uint_least64_t* bytes_read = nullptr) -> T
+{
+	struct ::stat st;
+	if (::stat(path.c_str(), &st) != 0)
+		detail_::throw_errno(path);
+	
+	auto cached = std::uintmax_t{};
+	if (S_ISREG(st.st_mode) && cache.find(path, st, model, cached))
+	{
+		if (bytes_read)
+			*bytes_read = static_cast<std::uint_least64_t>(st.st_size);
+		return static_cast<T>(cached);
+	}
+	
+	auto size = std::uint_least64_t{0};
+	auto const crc = calculate_file<Bits, Table, T>(path, table, &size);
+	if (bytes_read)
+		*bytes_read = size;
+	
+	if (S_ISREG(st.st_mode) &&
+			size == static_cast<std::uint_least64_t>(st.st_size))
+		cache.store(path, st, model, crc);
+	
+	return crc;
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,345 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_CHORBA_
+#define INDI_INC_CRC_CHORBA_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-braid.hpp"
+
+// Chorba CRC calculation, after Sam Russell's 2024 algorithm.
+//
+// If `Q` is a multiple of the CRC polynomial `P`, a message has the same
+// CRC as its remainder modulo `Q`. When `Q` is sparse, that remainder is
+// cheap to work out: with `Q = x^D + x^a + ... + 1`, every bit at `x^e`
+// with `e >= D` can be swapped for the bits at `x^(e - D + a)`, ...,
+// `x^(e - D)`, which are all further on in the message. If every term of
+// `Q` is a power of `x^64`, each 64-bit word of the message is simply
+// added to the words a fixed number of words further on, which takes no
+// tables and no multiplication. What's left at the end is only `D` bits
+// long, and gets an ordinary CRC calculation.
+
+namespace indi {
+namespace crc {
+
+//! A sparse multiple of a CRC polynomial, in powers of `y = x^64`.
+//! 
+//! The multiple is `y^degree + y^terms[0] + ... + y^terms[3] + 1`,
+//! leaving out the terms that are 0. See `chorba_engine`.
+struct chorba_multiple
+{
+	//! The degree of the multiple, in 64-bit words.
+	std::size_t degree;
+	
+	//! The powers of `y` between `degree` and 0, or 0 for none.
+	std::array<std::size_t, 4> terms;
+};
+
+//! Sparse multiples of common polynomials, for `chorba_engine`.
+//! 
+//! These are the multiples of least degree with up to six terms.
+namespace chorba_multiples {
+
+constexpr auto crc32_ansi = chorba_multiple{203u, {{186u, 123u, 85u, 79u}}};
+constexpr auto crc32_ieee = chorba_multiple{203u, {{186u, 123u, 85u, 79u}}};
+constexpr auto crc32c     = chorba_multiple{209u, {{144u, 54u, 39u, 14u}}};
+constexpr auto crc32k     = chorba_multiple{184u, {{135u, 118u, 99u, 80u}}};
+constexpr auto crc32q     = chorba_multiple{192u, {{132u, 94u, 13u, 9u}}};
+
+constexpr auto crc32 = crc32_ieee;
+
+} // namespace chorba_multiples
+
+//! Checks that a polynomial divides a `chorba_multiple`.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! \param multiple  The multiple to check.
+//! 
+//! \returns True if `multiple` is a multiple of the polynomial, with its
+//!          terms below its degree.
+template <std::size_t Bits, typename T>
+constexpr auto is_chorba_multiple(T polynomial,
+	chorba_multiple const& multiple) noexcept
+{
+	// Index loops, as std::array's begin() isn't constexpr in C++14.
+	auto const& terms = multiple.terms;
+	
+	if (multiple.degree == 0u)
+		return false;
+	for (auto n = std::size_t{0}; n < terms.size(); ++n)
+		if (terms[n] >= multiple.degree)
+			return false;
+	
+	auto sum = T(x_pow_mod<Bits>(0u, polynomial) ^
+		x_pow_mod<Bits>(64u * std::uintmax_t{multiple.degree},
+			polynomial));
+	for (auto n = std::size_t{0}; n < terms.size(); ++n)
+		if (terms[n] != 0u)
+			sum ^= x_pow_mod<Bits>(64u * std::uintmax_t{terms[n]},
+				polynomial);
+	
+	return sum == 0u;
+}
+
+//! A CRC engine that reduces the input by a sparse multiple of the
+//! polynomial (the Chorba algorithm).
+//! 
+//! Each 64-bit word of the input is added to one to five later words,
+//! as given by a `chorba_multiple` of the polynomial, until only
+//! `degree` words are left; those, and anything after the last whole
+//! word, go through a braided engine. That takes nothing but loads and
+//! XORs, so it runs at several times the speed of the braided engine,
+//! in portable C++, and without any tables beyond the braided engine's.
+//! 
+//! Short inputs gain nothing, since the last `degree` words are always
+//! left to the braided engine, so inputs of under `4 * degree` words go
+//! straight to it.
+//! 
+//! Use the `chorba_engine` (reflected) and `normal_chorba_engine`
+//! (non-reflected) aliases. Like a lookup table, a reflected engine can
+//! be passed to `calculate` and `calculate_raw`, and a non-reflected
+//! one to `calculate_normal_raw`:
+//! 
+//!     auto const engine = indi::crc::chorba_engine<32>{
+//!         indi::crc::polynomials::crc32,
+//!         indi::crc::chorba_multiples::crc32};
+//!     auto const crc = indi::crc::calculate<32>(data, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+template <std::size_t Bits, typename T, bool Reflected>
+class basic_chorba_engine
+{
+	static_assert(Bits > 0u && Bits <= 64u,
+		"Chorba supports 1 to 64-bit CRCs");
+
+public:
+	using crc_engine_tag = void;
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto reflected = Reflected;
+	
+	//! The engine used for the last words, and for short inputs.
+	using fallback_type = basic_braided_engine<Bits, T, Reflected>;
+	
+	//! The greatest degree of multiple the engine can use.
+	static constexpr auto max_degree = std::size_t{1023u};
+	
+	//! Creates an engine.
+	//! 
+	//! \requires `multiple` must be a multiple of the polynomial (see
+	//!           `is_chorba_multiple`), of degree at most `max_degree`.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	//! \param multiple  A sparse multiple of the polynomial.
+	constexpr basic_chorba_engine(T polynomial,
+		chorba_multiple const& multiple) noexcept :
+		fallback_(polynomial),
+		multiple_(multiple)
+	{}
+	
+	//! Calculates the raw CRC of a sequence of bytes.
+	//! 
+	//! \param crc  The raw CRC of the preceding sequence (or the
+	//!     initial value).
+	//! \param first  The start of the sequence.
+	//! \param last  The end of the sequence.
+	//! 
+	//! \returns The raw CRC.
+	auto update(T crc, unsigned char const* first,
+		unsigned char const* last) const noexcept -> T
+	{
+		auto const words = static_cast<std::size_t>(last - first) / 8u;
+		if (words < 4u * multiple_.degree)
+			return fallback_.update(crc, first, last);
+		
+		auto terms = std::size_t{0};
+		for (auto n = std::size_t{0}; n < multiple_.terms.size(); ++n)
+			terms += (multiple_.terms[n] != 0u);
+		
+		switch (terms)
+		{
+		case 0: crc = reduce<1>(crc, first, words); break;
+		case 1: crc = reduce<2>(crc, first, words); break;
+		case 2: crc = reduce<3>(crc, first, words); break;
+		case 3: crc = reduce<4>(crc, first, words); break;
+		default: crc = reduce<5>(crc, first, words); break;
+		}
+		
+		return fallback_.update(crc, first + 8u * words, last);
+	}
+	
+	//! Gets the multiple of the polynomial.
+	constexpr auto multiple() const noexcept -> chorba_multiple const&
+	{
+		return multiple_;
+	}
+	
+	//! Gets the engine used for the last words, and for short inputs.
+	constexpr auto fallback() const noexcept -> fallback_type const&
+	{
+		return fallback_;
+	}
+
+private:
+	// Word-sized loads and stores. The words are only ever added to
+	// each other, so their byte order doesn't matter.
+	static auto load(unsigned char const* p) noexcept
+	{
+		auto w = std::uint64_t{};
+		std::memcpy(&w, p, sizeof(w));
+		return w;
+	}
+	
+	static auto store(unsigned char* p, std::uint64_t w) noexcept
+	{
+		std::memcpy(p, &w, sizeof(w));
+	}
+	
+	// Gets the CRC as it lines up with the first 8 bytes of the input.
+	static auto leading_word(T crc, std::true_type /* reflected */)
+		noexcept
+	{
+		unsigned char bytes[8];
+		for (auto n = 0u; n < 8u; ++n)
+			bytes[n] = static_cast<unsigned char>(
+				std::uint64_t(crc) >> (8u * n));
+		return load(bytes);
+	}
+	
+	static auto leading_word(T crc, std::false_type /* reflected */)
+		noexcept
+	{
+		auto const x = std::uint64_t(std::uint64_t(crc) << (64u - Bits));
+		unsigned char bytes[8];
+		for (auto n = 0u; n < 8u; ++n)
+			bytes[n] = static_cast<unsigned char>(x >> (56u - 8u * n));
+		return load(bytes);
+	}
+	
+	// Adds up the words that the word at `p` picks up. (A loop over the
+	// lags isn't unrolled at -O2.)
+	template <std::size_t... L>
+	static auto gather(std::uint64_t const* p, std::size_t const* lags,
+		std::index_sequence<L...>) noexcept
+	{
+		auto w = std::uint64_t{0u};
+		using expand = int[];
+		(void)expand{(w ^= *(p - lags[L]), 0)...};
+		return w;
+	}
+	
+	// Reduces `words` words modulo the multiple, which has `Lags`
+	// nonzero terms besides the leading one, then calculates the CRC of
+	// what's left.
+	template <std::size_t Lags>
+	auto reduce(T crc, unsigned char const* first, std::size_t words)
+		const noexcept -> T
+	{
+		constexpr auto block = max_degree + 1u;
+		auto const degree = multiple_.degree;
+		
+		// Word `n` is added to word `n + lag` for every lag. Rather than
+		// adding the words forward, each word picks up the words it
+		// gets from the `degree` words before it, which are kept in
+		// front of the block being worked on.
+		std::size_t lags[Lags];
+		lags[0] = degree;
+		for (auto t = std::size_t{0}, l = std::size_t{1}; l < Lags; ++t)
+			if (multiple_.terms[t] != 0u)
+				lags[l++] = degree - multiple_.terms[t];
+		
+		std::uint64_t history[max_degree + block];
+		std::memset(history, 0, degree * sizeof(history[0]));
+		auto const words_ = history + degree;
+		
+		// The CRC so far is added to the first word, so the rest can
+		// start from 0. Only the first word picks up the word `degree`
+		// words before it.
+		history[0] = leading_word(crc, is_reflected{});
+		
+		auto const reduced = words - degree;
+		for (auto n = std::size_t{0}; n < reduced; )
+		{
+			auto const count = std::min(block, reduced - n);
+			for (auto i = std::size_t{0}; i < count; ++i, ++n)
+				words_[i] = load(first + 8u * n) ^
+					gather(words_ + i, lags, std::make_index_sequence<Lags>{});
+			std::memmove(history, history + count,
+				degree * sizeof(history[0]));
+		}
+		
+		// The last words are left in place, and clear their places as
+		// they go, so they're not added to each other.
+		alignas(8) unsigned char buffer[256];
+		crc = T(0u);
+		for (auto i = std::size_t{0}; i < degree; )
+		{
+			auto p = buffer;
+			for (; i < degree && p != buffer + sizeof(buffer); ++i, p += 8)
+			{
+				store(p, load(first + 8u * (reduced + i)) ^
+					gather(words_ + i, lags,
+						std::make_index_sequence<Lags>{}));
+				words_[i] = 0u;
+			}
+			crc = fallback_.update(crc, buffer, p);
+		}
+		
+		return crc;
+	}
+	
+	using is_reflected = std::integral_constant<bool, Reflected>;
+	
+	fallback_type fallback_;
+	chorba_multiple multiple_;
+};
+
+//! A reflected CRC engine that reduces the input by a sparse multiple
+//! of the polynomial.
+//! 
+//! \see basic_chorba_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using chorba_engine = basic_chorba_engine<Bits, T, true>;
+
+//! A non-reflected (MSB-first) CRC engine that reduces the input by a
+//! sparse multiple of the polynomial.
+//! 
+//! \see basic_chorba_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using normal_chorba_engine = basic_chorba_engine<Bits, T, false>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
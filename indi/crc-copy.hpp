@@ -0,0 +1,214 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_COPY_
+#define INDI_INC_CRC_COPY_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+
+// Copying and checksumming in one pass.
+//
+// Copying a buffer and then calculating the CRC of the copy reads every
+// byte twice, and once the buffer is larger than the caches, both
+// passes go all the way to memory. Doing both a block at a time, with
+// blocks small enough to stay in the L1 cache, means each byte comes
+// from memory once: the engine reads the block in, and the copy reads
+// it from the cache.
+//
+// Large copies are also written with non-temporal (streaming) stores,
+// which go straight to memory instead of first reading each cache line
+// of the destination in, and don't push the rest of the working set out
+// of the caches.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// From this size on, copies use non-temporal stores: a destination this
+// large would push most other things out of the caches anyway.
+constexpr auto copy_stream_threshold = std::size_t{1u} << 20;
+
+#if INDI_CRC_HAVE_PCLMUL
+
+#define INDI_CRC_HAVE_COPY_STREAM 1
+
+// Copies with non-temporal stores, 64 bytes at a time. `dst` must be
+// aligned to 16 bytes, and `size` a multiple of 64.
+__attribute__((target("sse2")))
+inline auto copy_stream(unsigned char* dst, unsigned char const* src,
+	std::size_t size) noexcept -> void
+{
+	for (; size != 0u; size -= 64u, dst += 64, src += 64)
+	{
+		auto const s = reinterpret_cast<__m128i const*>(src);
+		auto const d = reinterpret_cast<__m128i*>(dst);
+		auto const x0 = _mm_loadu_si128(s);
+		auto const x1 = _mm_loadu_si128(s + 1);
+		auto const x2 = _mm_loadu_si128(s + 2);
+		auto const x3 = _mm_loadu_si128(s + 3);
+		_mm_stream_si128(d, x0);
+		_mm_stream_si128(d + 1, x1);
+		_mm_stream_si128(d + 2, x2);
+		_mm_stream_si128(d + 3, x3);
+	}
+}
+
+// Makes the non-temporal stores visible to other threads, as ordinary
+// stores would be.
+__attribute__((target("sse2")))
+inline auto copy_stream_fence() noexcept -> void
+{
+	_mm_sfence();
+}
+
+#else
+
+#define INDI_CRC_HAVE_COPY_STREAM 0
+
+#endif
+
+template <typename T, typename Engine>
+auto copy_update(T crc, unsigned char* dst, unsigned char const* src,
+	std::size_t size, Engine const& engine) noexcept
+{
+	while (size != 0u)
+	{
+		auto const block = size < cache_block ? size : cache_block;
+		crc = T(engine.update(crc, src, src + block));
+		std::memcpy(dst, src, block);
+		dst += block;
+		src += block;
+		size -= block;
+	}
+	
+	return crc;
+}
+
+#if INDI_CRC_HAVE_COPY_STREAM
+
+// As `copy_update`, but with non-temporal stores. The first few bytes
+// are copied as usual, up to where `dst` is aligned to a cache line.
+template <typename T, typename Engine>
+auto copy_update_stream(T crc, unsigned char* dst,
+	unsigned char const* src, std::size_t size, Engine const& engine)
+	noexcept
+{
+	auto const head = static_cast<std::size_t>(
+		-reinterpret_cast<std::uintptr_t>(dst) & 63u);
+	crc = copy_update(crc, dst, src, head, engine);
+	dst += head;
+	src += head;
+	size -= head;
+	
+	while (size >= 64u)
+	{
+		auto block = size < cache_block ? size : cache_block;
+		block &= ~std::size_t{63u};
+		crc = T(engine.update(crc, src, src + block));
+		copy_stream(dst, src, block);
+		dst += block;
+		src += block;
+		size -= block;
+	}
+	
+	copy_stream_fence();
+	return copy_update(crc, dst, src, size, engine);
+}
+
+#endif
+
+} // namespace detail_
+
+//! Copies a buffer and calculates the raw CRC of its bytes, in one
+//! pass.
+//! 
+//! This gives the same CRC as `calculate_raw` over the copy, but the
+//! buffer is copied and checksummed a block at a time, so each byte is
+//! read from memory once, and copies of 1 MB or more use non-temporal
+//! stores (on x86). The buffers must not overlap.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param init  The raw CRC of the preceding sequence (or the initial
+//!     value).
+//! \param dst  Where to copy to.
+//! \param src  Where to copy from.
+//! \param size  The number of bytes.
+//! \param engine  The CRC engine (reflected).
+//! 
+//! \returns The raw CRC.
+template <std::size_t Bits, typename T, typename Engine>
+auto copy_and_calculate_raw(T init, void* dst, void const* src,
+		std::size_t size, Engine const& engine) noexcept ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value, T>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+	auto const d = static_cast<unsigned char*>(dst);
+	auto const s = static_cast<unsigned char const*>(src);
+	
+#if INDI_CRC_HAVE_COPY_STREAM
+	if (size >= detail_::copy_stream_threshold)
+		return detail_::copy_update_stream(init, d, s, size, engine);
+#endif
+	
+	return detail_::copy_update(init, d, s, size, engine);
+}
+
+//! Copies a buffer and calculates the CRC of its bytes, in one pass.
+//! 
+//! This is the same as `std::memcpy` followed by `calculate` over the
+//! copy (see `copy_and_calculate_raw`). For example:
+//! 
+//!     auto const engine = indi::crc::clmul_engine<32>{
+//!         indi::crc::polynomials::crc32c};
+//!     auto const crc = indi::crc::copy_and_calculate<32>(arena, packet,
+//!         size, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param dst  Where to copy to.
+//! \param src  Where to copy from.
+//! \param size  The number of bytes.
+//! \param engine  The CRC engine (reflected).
+//! 
+//! \returns The CRC.
+template <std::size_t Bits, typename Engine>
+auto copy_and_calculate(void* dst, void const* src, std::size_t size,
+		Engine const& engine) noexcept ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value,
+		typename Engine::crc_type>
+{
+	using T = typename Engine::crc_type;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return T(ones ^ copy_and_calculate_raw<Bits>(ones, dst, src, size,
+		engine));
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,357 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_EXECUTION_
+#define INDI_INC_CRC_EXECUTION_
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "indi/crc.hpp"
+#include "indi/crc-braid.hpp"
+#include "indi/crc-simd.hpp"
+
+// Execution policy overloads of `calculate` and `calculate_raw`.
+//
+// Unlike the rest of the library, this file needs C++17, for the
+// standard execution policies. (With libstdc++, the parallel policies
+// run on TBB when it is installed, and it then has to be linked in, as
+// for the standard parallel algorithms.)
+//
+// The parallel policies split the input into pieces, calculate the raw
+// CRC of each piece on its own with `std::transform` under the same
+// policy, and then `combine` them in order. The unsequenced policies
+// (`par_unseq`, and `unseq` from C++20) let the CRC of each piece be
+// calculated with a `clmul_engine`, which uses SIMD instructions where
+// the CPU has them; the others use a `braided_engine`.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+template <typename Policy>
+struct is_unsequenced_policy : std::is_same<std::decay_t<Policy>,
+	std::execution::parallel_unsequenced_policy>
+{};
+
+#if __cpp_lib_execution >= 201902L
+template <>
+struct is_unsequenced_policy<std::execution::unsequenced_policy> :
+	std::true_type
+{};
+#endif
+
+template <typename Policy>
+struct is_parallel_policy : std::integral_constant<bool,
+	std::is_same<std::decay_t<Policy>,
+			std::execution::parallel_policy>::value ||
+		std::is_same<std::decay_t<Policy>,
+			std::execution::parallel_unsequenced_policy>::value>
+{};
+
+template <typename Policy>
+constexpr auto is_execution_policy_v =
+	std::is_execution_policy_v<std::decay_t<Policy>>;
+
+template <std::size_t Bits, typename T, typename Policy>
+using policy_engine = std::conditional_t<
+	is_unsequenced_policy<std::decay_t<Policy>>::value,
+	clmul_engine<Bits, T>, braided_engine<Bits, T>>;
+
+// Pieces smaller than this aren't worth a thread.
+constexpr auto policy_piece = std::size_t{1u} << 20;
+
+template <typename Range>
+auto policy_begin(Range const& range)
+{
+	using std::begin;
+	return begin(range);
+}
+
+template <typename Range>
+auto policy_end(Range const& range)
+{
+	using std::end;
+	return end(range);
+}
+
+template <std::size_t Bits, typename Policy, typename T,
+	typename RandomAccessIterator, typename Engine>
+auto policy_update(Policy&& policy, T init, RandomAccessIterator first,
+	RandomAccessIterator last, T poly, Engine const& engine)
+{
+	auto const size = static_cast<std::size_t>(last - first);
+	if (!is_parallel_policy<Policy>::value || size < 2u * policy_piece)
+		return calculate_raw<Bits>(init, first, last, engine);
+	
+	auto const threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto const pieces = std::min<std::size_t>(size / policy_piece,
+		4u * threads);
+	auto const piece_first = [=](std::size_t piece)
+		{ return first + size * piece / pieces; };
+	
+	// Every piece but the first starts from 0, so that its CRC can be
+	// combined with the ones before.
+	auto indices = std::vector<std::size_t>(pieces);
+	std::iota(indices.begin(), indices.end(), std::size_t{0});
+	auto crcs = std::vector<T>(pieces);
+	std::transform(std::forward<Policy>(policy), indices.begin(),
+		indices.end(), crcs.begin(), [&](std::size_t piece)
+		{
+			return calculate_raw<Bits>(piece == 0u ? init : T{0},
+				piece_first(piece), piece_first(piece + 1u), engine);
+		});
+	
+	auto crc = crcs[0];
+	for (auto piece = std::size_t{1}; piece < pieces; ++piece)
+		crc = combine<Bits>(crc, crcs[piece], static_cast<std::uintmax_t>(
+			piece_first(piece + 1u) - piece_first(piece)), poly);
+	
+	return crc;
+}
+
+// Building an engine means working out its tables (and folding
+// constants), which costs more than a small input, so each thread
+// keeps the last one it built and uses it again for the same
+// polynomial. The pieces only use it while the calling thread waits for
+// them.
+template <typename Engine, typename T>
+auto cached_engine(T poly) -> Engine const&
+{
+	thread_local auto engine = std::unique_ptr<Engine>{};
+	thread_local auto engine_poly = T{};
+	
+	if (!engine || engine_poly != poly)
+	{
+		engine = std::make_unique<Engine>(poly);
+		engine_poly = poly;
+	}
+	
+	return *engine;
+}
+
+template <std::size_t Bits, typename Policy, typename T,
+	typename RandomAccessIterator>
+auto policy_calculate_raw(Policy&& policy, T init,
+	RandomAccessIterator first, RandomAccessIterator last, T poly)
+{
+	auto const& engine = cached_engine<policy_engine<Bits, T, Policy>>(
+		poly);
+	return policy_update<Bits>(std::forward<Policy>(policy), init, first,
+		last, poly, engine);
+}
+
+// Contiguous ranges of bytes are handed over as pointers, which engines
+// can work on directly.
+template <std::size_t Bits, typename Policy, typename T, typename Range>
+auto policy_calculate_raw(Policy&& policy, T init, Range const& range,
+	T poly, std::true_type)
+{
+	auto const first = reinterpret_cast<unsigned char const*>(
+		range.data());
+	return policy_calculate_raw<Bits>(std::forward<Policy>(policy), init,
+		first, first + range.size(), poly);
+}
+
+template <std::size_t Bits, typename Policy, typename T, typename Range>
+auto policy_calculate_raw(Policy&& policy, T init, Range const& range,
+	T poly, std::false_type)
+{
+	return policy_calculate_raw<Bits>(std::forward<Policy>(policy), init,
+		policy_begin(range), policy_end(range), poly);
+}
+
+template <std::size_t Bits, typename Policy, typename Range,
+	typename T = crc_type_t<Bits>>
+auto policy_calculate(Policy&& policy, Range const& range)
+{
+	static_assert(Bits == 16 || Bits == 32,
+		"there is only a default polynomial for CRC16 and CRC32");
+	
+	constexpr auto ones = detail_::ones<Bits, T>();
+	constexpr auto poly = Bits == 16 ? T(polynomials::crc16) :
+		T(polynomials::crc32);
+	return T(ones ^ policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), ones, range, poly,
+		is_contiguous_byte_range<Range>{}));
+}
+
+} // namespace detail_
+
+// calculate_raw<Bits>(Policy&& p, T init, RAIt first, RAIt last, T poly)
+// calculate_raw<Bits>(Policy&& p, T init, Range const& r, T poly)
+// calculate<Bits>(Policy&& p, RAIt first, RAIt last, T poly)
+// calculate<Bits>(Policy&& p, Range const& r, T poly)
+// calculate<16>(Policy&& p, RAIt first, RAIt last)
+// calculate<32>(Policy&& p, RAIt first, RAIt last)
+// calculate<16>(Policy const& p, Range const& r)
+// calculate<32>(Policy const& p, Range const& r)
+
+//! Calculates a raw CRC under an execution policy.
+//! 
+//! This gives the same CRC as `calculate_raw` without a policy. Under
+//! `std::execution::par` and `std::execution::par_unseq`, large inputs
+//! are split into pieces, whose CRCs are calculated in parallel and
+//! combined; under `std::execution::par_unseq` and
+//! `std::execution::unseq`, the CRCs are calculated with SIMD
+//! instructions where the CPU has them.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param policy  The execution policy.
+//! \param init  The initial value.
+//! \param first  The start of the sequence.
+//! \param last  The end of the sequence.
+//! \param poly  The encoded polynomial value.
+//! 
+//! \returns The raw CRC.
+template <std::size_t Bits, typename Policy, typename T,
+	typename RandomAccessIterator>
+auto calculate_raw(Policy&& policy, T init, RandomAccessIterator first,
+		RandomAccessIterator last, T poly) ->
+	std::enable_if_t<detail_::is_execution_policy_v<Policy> &&
+			detail_::is_random_access_iterator<RandomAccessIterator>::
+				value &&
+			std::is_integral<T>::value,
+		T>
+{
+	return detail_::policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), init, first, last, poly);
+}
+
+template <std::size_t Bits, typename Policy, typename T, typename Range>
+auto calculate_raw(Policy&& policy, T init, Range const& range, T poly)
+		->
+	std::enable_if_t<detail_::is_execution_policy_v<Policy> &&
+			!detail_::is_input_iterator<Range>::value &&
+			std::is_integral<T>::value,
+		T>
+{
+	return detail_::policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), init, range, poly,
+		detail_::is_contiguous_byte_range<Range>{});
+}
+
+//! Calculates a CRC under an execution policy.
+//! 
+//! This gives the same CRC as `calculate` without a policy (see the
+//! policy overload of `calculate_raw`). For example:
+//! 
+//!     auto const crc = indi::crc::calculate<32>(std::execution::par,
+//!         data);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param policy  The execution policy.
+//! \param first  The start of the sequence.
+//! \param last  The end of the sequence.
+//! \param poly  The encoded polynomial value.
+//! 
+//! \returns The CRC.
+template <std::size_t Bits, typename Policy,
+	typename RandomAccessIterator, typename T>
+auto calculate(Policy&& policy, RandomAccessIterator first,
+		RandomAccessIterator last, T poly) ->
+	std::enable_if_t<detail_::is_execution_policy_v<Policy> &&
+			detail_::is_random_access_iterator<RandomAccessIterator>::
+				value &&
+			std::is_integral<T>::value,
+		T>
+{
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return T(ones ^ detail_::policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), ones, first, last, poly));
+}
+
+template <std::size_t Bits, typename Policy, typename Range, typename T>
+auto calculate(Policy&& policy, Range const& range, T poly) ->
+	std::enable_if_t<detail_::is_execution_policy_v<Policy> &&
+			!detail_::is_input_iterator<Range>::value &&
+			std::is_integral<T>::value,
+		T>
+{
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return T(ones ^ detail_::policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), ones, range, poly,
+		detail_::is_contiguous_byte_range<Range>{}));
+}
+
+template <std::size_t Bits, typename Policy,
+	typename RandomAccessIterator, typename T = crc_type_t<Bits>>
+auto calculate(Policy&& policy, RandomAccessIterator first,
+		RandomAccessIterator last) ->
+	std::enable_if_t<(Bits == 16 || Bits == 32) &&
+			detail_::is_execution_policy_v<Policy> &&
+			detail_::is_random_access_iterator<RandomAccessIterator>::
+				value,
+		T>
+{
+	constexpr auto ones = detail_::ones<Bits, T>();
+	constexpr auto poly = Bits == 16 ? T(polynomials::crc16) :
+		T(polynomials::crc32);
+	return T(ones ^ detail_::policy_calculate_raw<Bits>(
+		std::forward<Policy>(policy), ones, first, last, poly));
+}
+
+// These name the policies, rather than taking any policy, so that they
+// are picked over `calculate(Range const&, Table const&)`.
+
+template <std::size_t Bits, typename Range, typename T = crc_type_t<Bits>>
+auto calculate(std::execution::sequenced_policy const& policy,
+		Range const& range) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value, T>
+{
+	return detail_::policy_calculate<Bits>(policy, range);
+}
+
+template <std::size_t Bits, typename Range, typename T = crc_type_t<Bits>>
+auto calculate(std::execution::parallel_policy const& policy,
+		Range const& range) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value, T>
+{
+	return detail_::policy_calculate<Bits>(policy, range);
+}
+
+template <std::size_t Bits, typename Range, typename T = crc_type_t<Bits>>
+auto calculate(std::execution::parallel_unsequenced_policy const& policy,
+		Range const& range) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value, T>
+{
+	return detail_::policy_calculate<Bits>(policy, range);
+}
+
+#if __cpp_lib_execution >= 201902L
+template <std::size_t Bits, typename Range, typename T = crc_type_t<Bits>>
+auto calculate(std::execution::unsequenced_policy const& policy,
+		Range const& range) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value, T>
+{
+	return detail_::policy_calculate<Bits>(policy, range);
+}
+#endif
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
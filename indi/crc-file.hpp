@@ -0,0 +1,307 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_FILE_
+#define INDI_INC_CRC_FILE_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "indi/crc.hpp"
+
+// File checksumming routines.
+//
+// Unlike the rest of the library, these functions are not portable
+// standard C++: they are written against the POSIX file API, because
+// positioned reads (`pread`) are what allow several threads to work on
+// different parts of the same file at once.
+//
+// All errors are reported by throwing `std::system_error`.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Size of the buffer used for reading files.
+constexpr auto file_buffer_size = std::size_t{256u * 1024u};
+
+[[noreturn]] inline auto throw_errno(std::string const& what)
+{
+	throw std::system_error{errno, std::generic_category(), what};
+}
+
+} // namespace detail_
+
+//! Owning wrapper for a POSIX file descriptor.
+//! 
+//! The file descriptor is closed on destruction. Errors on closing are
+//! ignored, because files are only ever opened for reading.
+class file_descriptor
+{
+public:
+	constexpr file_descriptor() noexcept = default;
+	
+	explicit constexpr file_descriptor(int fd) noexcept :
+		fd_{fd}
+	{}
+	
+	file_descriptor(file_descriptor&& other) noexcept :
+		fd_{other.release()}
+	{}
+	
+	auto operator=(file_descriptor&& other) noexcept -> file_descriptor&
+	{
+		reset(other.release());
+		return *this;
+	}
+	
+	~file_descriptor() { reset(); }
+	
+	constexpr auto get() const noexcept -> int { return fd_; }
+	
+	explicit constexpr operator bool() const noexcept { return fd_ >= 0; }
+	
+	auto release() noexcept -> int
+	{
+		auto const fd = fd_;
+		fd_ = -1;
+		return fd;
+	}
+	
+	auto reset(int fd = -1) noexcept -> void
+	{
+		if (fd_ >= 0)
+			::close(fd_);
+		fd_ = fd;
+	}
+
+private:
+	int fd_ = -1;
+};
+
+//! Opens a file for reading.
+//! 
+//! \param path  The path of the file.
+//! 
+//! \throws std::system_error if the file could not be opened.
+//! 
+//! \returns The open file descriptor.
+inline auto open_file(std::string const& path)
+{
+	auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		detail_::throw_errno(path);
+	
+	return file_descriptor{fd};
+}
+
+//! Gets the size of an open file.
+//! 
+//! \param fd  The open file descriptor.
+//! 
+//! \throws std::system_error if the file could not be queried.
+//! 
+//! \returns The file size in bytes.
+inline auto file_size(int fd)
+{
+	struct ::stat st;
+	if (::fstat(fd, &st) != 0)
+		detail_::throw_errno("fstat");
+	
+	return static_cast<std::uint_least64_t>(st.st_size);
+}
+
+//! Calculates the raw CRC of part of an open file.
+//! 
+//! This reads the `length` bytes starting at `offset` using positioned
+//! reads, so the file offset is not changed, and several threads can
+//! work on different parts of the same file descriptor at once.
+//! 
+//! If the end of the file is reached before `length` bytes have been
+//! read, the CRC of the bytes that were read is returned. Passing
+//! `UINT_LEAST64_MAX` as the length thus reads to the end of the file.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Table  The lookup table type (anything that can be passed
+//!     to `calculate_raw`).
+//! 
+//! \param init  The initial CRC value.
+//! \param fd  The open file descriptor.
+//! \param offset  The offset of the first byte.
+//! \param length  The number of bytes.
+//! \param table  The lookup table.
+//! \param bytes_read  If not null, set to the number of bytes read.
+//! 
+//! \throws std::system_error if there was a read error.
+//! 
+//! \returns The computed raw CRC.
+template <std::size_t Bits, typename T, typename Table>
+auto calculate_raw_file(T init, int fd, std::uint_least64_t offset,
+		std::uint_least64_t length, Table const& table,
+		std::uint_least64_t* bytes_read = nullptr) -> T
+{
+	auto const buffer = std::make_unique<unsigned char[]>(
+		detail_::file_buffer_size);
+	
+	auto total = std::uint_least64_t{0};
+	
+	while (total < length)
+	{
+		auto const want = static_cast<std::size_t>(
+			std::min<std::uint_least64_t>(length - total,
+				detail_::file_buffer_size));
+		
+		auto const got = ::pread(fd, buffer.get(), want,
+			static_cast<::off_t>(offset + total));
+		
+		if (got < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			detail_::throw_errno("pread");
+		}
+		
+		if (got == 0)
+			break;
+		
+		init = calculate_raw<Bits>(init, buffer.get(),
+			buffer.get() + got, table);
+		total += static_cast<std::uint_least64_t>(got);
+	}
+	
+	if (bytes_read)
+		*bytes_read = total;
+	
+	return init;
+}
+
+//! Calculates the CRC of an open file, from the current offset to the
+//! end of the file.
+//! 
+//! This uses plain sequential reads, so it works for pipes and
+//! terminals as well as regular files.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Table  The lookup table type.
+//! \tparam T  The CRC type.
+//! 
+//! \param fd  The open file descriptor.
+//! \param table  The lookup table.
+//! \param bytes_read  If not null, set to the number of bytes read.
+//! 
+//! \throws std::system_error if there was a read error.
+//! 
+//! \returns The computed CRC.
+template <std::size_t Bits, typename Table, typename T = crc_type_t<Bits>>
+auto calculate_stream(int fd, Table const& table,
+		std::uint_least64_t* bytes_read = nullptr) -> T
+{
+	constexpr auto ones = detail_::ones<Bits, T>();
+	
+	auto const buffer = std::make_unique<unsigned char[]>(
+		detail_::file_buffer_size);
+	
+	auto crc = ones;
+	auto total = std::uint_least64_t{0};
+	
+	for (;;)
+	{
+		auto const got = ::read(fd, buffer.get(),
+			detail_::file_buffer_size);
+		
+		if (got < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			detail_::throw_errno("read");
+		}
+		
+		if (got == 0)
+			break;
+		
+		crc = calculate_raw<Bits>(crc, buffer.get(), buffer.get() + got,
+			table);
+		total += static_cast<std::uint_least64_t>(got);
+	}
+	
+	if (bytes_read)
+		*bytes_read = total;
+	
+	return T(ones ^ crc);
+}
+
+//! Calculates the CRC of a file.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Table  The lookup table type.
+//! \tparam T  The CRC type.
+//! 
+//! \param path  The path of the file.
+//! \param table  The lookup table.
+//! \param bytes_read  If not null, set to the number of bytes read.
+//! 
+//! \throws std::system_error if the file could not be opened or read.
+//! 
+//! \returns The computed CRC.
+template <std::size_t Bits, typename Table, typename T = crc_type_t<Bits>>
+auto calculate_file(std::string const& path, Table const& table,
+		std::uint_least64_t* bytes_read = nullptr) ->
+	std::enable_if_t<!std::is_integral<Table>::value, T>
+{
+	auto const fd = open_file(path);
+	return calculate_stream<Bits, Table, T>(fd.get(), table, bytes_read);
+}
+
+//! Calculates the CRC of a file.
+//! 
+//! This is a convenience function that generates a lookup table from
+//! `poly`, then calls the table version.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! 
+//! \param path  The path of the file.
+//! \param poly  The encoded polynomial value.
+//! \param bytes_read  If not null, set to the number of bytes read.
+//! 
+//! \throws std::system_error if the file could not be opened or read.
+//! 
+//! \returns The computed CRC.
+template <std::size_t Bits, typename T>
+auto calculate_file(std::string const& path, T poly,
+		std::uint_least64_t* bytes_read = nullptr) ->
+	std::enable_if_t<std::is_integral<T>::value, T>
+{
+	auto const table = generate_table<Bits>(poly);
+	return calculate_file<Bits, decltype(table), T>(path, table,
+		bytes_read);
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
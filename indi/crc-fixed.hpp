@@ -0,0 +1,302 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_FIXED_
+#define INDI_INC_CRC_FIXED_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+
+// CRCs of inputs whose length is known at compile time.
+//
+// For short keys, the generic code spends more time deciding what to do
+// (which kernel, how long a tail) than working out the CRC. With the
+// bit-size, the polynomial, and the length all template arguments, the
+// decisions are made at compile time, every loop is written out, and
+// the folding constants are worked out by the compiler.
+
+// Telling run time from compile time needs GCC 9 or Clang 9. Anywhere
+// else, the fixed-length functions always use the lookup table.
+#if INDI_CRC_HAVE_PCLMUL && \
+	((defined(__clang__) && __clang_major__ >= 9) || \
+		(!defined(__clang__) && __GNUC__ >= 9))
+#define INDI_CRC_HAVE_FIXED_KERNELS 1
+#else
+#define INDI_CRC_HAVE_FIXED_KERNELS 0
+#endif
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// The lookup table for a polynomial, generated at compile time, an
+// entry at a time, as `generate_table` does. (Its `std::array` can only
+// be filled in constant expressions from C++17.)
+template <typename T>
+struct fixed_table_values
+{
+	T values[256];
+};
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+constexpr auto make_fixed_table() noexcept
+{
+	using T = crc_type_t<Bits>;
+	constexpr auto reversed = polynomials::reversed<Bits>(Polynomial);
+	
+	auto table = fixed_table_values<T>{};
+	for (auto n = std::size_t{0}; n < 256u; ++n)
+		table.values[n] = table_entry(reversed, n);
+	
+	return table;
+}
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+struct fixed_table
+{
+	static constexpr fixed_table_values<crc_type_t<Bits>> value =
+		make_fixed_table<Bits, Polynomial>();
+};
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+constexpr fixed_table_values<crc_type_t<Bits>>
+	fixed_table<Bits, Polynomial>::value;
+
+// A byte at a time, written out (-O2 won't unroll long loops).
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t... I>
+constexpr auto fixed_table_update(crc_type_t<Bits> crc,
+	unsigned char const* p, std::index_sequence<I...>) noexcept
+{
+	using T = crc_type_t<Bits>;
+	constexpr auto const& table = fixed_table<Bits, Polynomial>::value;
+	
+	using expand = int[];
+	(void)expand{0, (crc = T(table.values[(crc ^ p[I]) & 0xFFu] ^ (crc >> 8)),
+		0)...};
+	return crc;
+}
+
+#if INDI_CRC_HAVE_FIXED_KERNELS
+
+// CRC-32C has its own instruction, which adds 8 bytes at a time (4 on
+// 32-bit x86).
+#if defined(__x86_64__)
+using fixed_word = std::uint64_t;
+#else
+using fixed_word = std::uint32_t;
+#endif
+
+#define INDI_CRC_TARGET_FIXED_SSE42 \
+	__attribute__((target("sse4.2"), flatten))
+
+#if defined(__x86_64__)
+INDI_CRC_TARGET_FIXED_SSE42
+inline auto fixed_crc32c_word(std::uint32_t crc, std::uint64_t word)
+	noexcept
+{
+	return static_cast<std::uint32_t>(_mm_crc32_u64(crc, word));
+}
+#endif
+
+INDI_CRC_TARGET_FIXED_SSE42
+inline auto fixed_crc32c_word(std::uint32_t crc, std::uint32_t word)
+	noexcept
+{
+	return _mm_crc32_u32(crc, word);
+}
+
+template <std::size_t N, std::size_t... I>
+INDI_CRC_TARGET_FIXED_SSE42
+inline auto fixed_crc32c(std::uint32_t crc, unsigned char const* p,
+	std::index_sequence<I...>) noexcept -> std::uint32_t
+{
+	constexpr auto size = sizeof(fixed_word);
+	
+	using expand = int[];
+	(void)expand{0, (crc = fixed_crc32c_word(crc, [p]
+		{
+			auto word = fixed_word{};
+			std::memcpy(&word, p + I * size, size);
+			return word;
+		}()), 0)...};
+	p += sizeof...(I) * size;
+	
+	if ((N % size) & 4u)
+	{
+		auto word = std::uint32_t{};
+		std::memcpy(&word, p, 4u);
+		crc = _mm_crc32_u32(crc, word);
+		p += 4;
+	}
+	
+	if ((N % size) & 2u)
+	{
+		auto word = std::uint16_t{};
+		std::memcpy(&word, p, 2u);
+		crc = _mm_crc32_u16(crc, word);
+		p += 2;
+	}
+	
+	if ((N % size) & 1u)
+		crc = _mm_crc32_u8(crc, *p);
+	
+	return crc;
+}
+
+#define INDI_CRC_TARGET_FIXED_PCLMUL \
+	__attribute__((target("pclmul,sse4.1"), flatten))
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+struct fixed_clmul_constants
+{
+	static constexpr clmul_constants value =
+		make_clmul_constants<Bits>(Polynomial);
+};
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial>
+constexpr clmul_constants fixed_clmul_constants<Bits, Polynomial>::value;
+
+// Folds 16 bytes at a time, and reduces 8 more in one go: 8 bytes
+// added to a 64-bit CRC give the CRC of a 16-byte block that holds them
+// (and the CRC) in its second half, from 0. The last few bytes go
+// through the table.
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+INDI_CRC_TARGET_FIXED_PCLMUL
+inline auto fixed_clmul(crc_type_t<Bits> crc, unsigned char const* p)
+	noexcept
+{
+	using T = crc_type_t<Bits>;
+	constexpr auto bulk = N & ~std::size_t{15u};
+	constexpr auto const& k = fixed_clmul_constants<Bits, Polynomial>::
+		value;
+	
+	auto c = static_cast<std::uint64_t>(crc);
+	if (bulk != 0u)
+		c = clmul_update<true>(c, p, bulk, k);
+	
+	if (N & 8u)
+	{
+		auto word = std::uint64_t{};
+		std::memcpy(&word, p + bulk, 8u);
+		c = clmul_reduce(_mm_set_epi64x(static_cast<long long>(c ^ word),
+			0), k, std::true_type{});
+	}
+	
+	return fixed_table_update<Bits, Polynomial>(T(c), p + (N & ~7u),
+		std::make_index_sequence<N % 8u>{});
+}
+
+#undef INDI_CRC_TARGET_FIXED_PCLMUL
+#undef INDI_CRC_TARGET_FIXED_SSE42
+
+// Picks the fastest way the CPU has.
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+inline auto fixed_update(crc_type_t<Bits> crc, unsigned char const* p)
+	noexcept -> crc_type_t<Bits>
+{
+	using T = crc_type_t<Bits>;
+	constexpr auto crc32c = Bits == 32u && Polynomial ==
+		T(polynomials::crc32c);
+	
+	if (crc32c && cpu().sse42)
+		return T(fixed_crc32c<N>(std::uint32_t(crc), p,
+			std::make_index_sequence<N / sizeof(fixed_word)>{}));
+	
+	// Below 8 bytes, the table is as fast.
+	if (N >= 8u && cpu().pclmul)
+		return fixed_clmul<Bits, Polynomial, N>(crc, p);
+	
+	return fixed_table_update<Bits, Polynomial>(crc, p,
+		std::make_index_sequence<N>{});
+}
+
+#endif // INDI_CRC_HAVE_FIXED_KERNELS
+
+} // namespace detail_
+
+//! Calculates the raw CRC of a fixed number of bytes.
+//! 
+//! Everything about the calculation is known at compile time, so there
+//! are no loops or length checks. At run time, CRC-32C uses the SSE4.2
+//! CRC32 instruction, and other CRCs of 8 bytes or more use carry-less
+//! multiplication, when the CPU has them (with GCC 9 or Clang 9 or
+//! later on x86). Otherwise, and in constant expressions, a lookup
+//! table generated at compile time is used.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Polynomial  The encoded polynomial value.
+//! \tparam N  The number of bytes.
+//! 
+//! \param crc  The raw CRC of the preceding sequence (or the initial
+//!     value).
+//! \param p  The first of the `N` bytes.
+//! 
+//! \returns The raw CRC.
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+constexpr auto calculate_fixed_raw(crc_type_t<Bits> crc,
+	unsigned char const* p) noexcept
+{
+#if INDI_CRC_HAVE_FIXED_KERNELS
+	if (!__builtin_is_constant_evaluated())
+		return detail_::fixed_update<Bits, Polynomial, N>(crc, p);
+#endif
+	
+	return detail_::fixed_table_update<Bits, Polynomial>(crc, p,
+		std::make_index_sequence<N>{});
+}
+
+//! Calculates the CRC of a fixed number of bytes.
+//! 
+//! This is the same as `calculate`, for short keys of a length known at
+//! compile time (see `calculate_fixed_raw`). For example:
+//! 
+//!     unsigned char const key[16] = { ... };
+//!     auto const crc = indi::crc::calculate_fixed<32,
+//!         indi::crc::polynomials::crc32c, 16>(key);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam Polynomial  The encoded polynomial value.
+//! \tparam N  The number of bytes.
+//! 
+//! \param p  The first of the `N` bytes.
+//! 
+//! \returns The CRC.
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+constexpr auto calculate_fixed(unsigned char const* p) noexcept
+{
+	constexpr auto ones = detail_::ones<Bits, crc_type_t<Bits>>();
+	return crc_type_t<Bits>(ones ^
+		calculate_fixed_raw<Bits, Polynomial, N>(ones, p));
+}
+
+template <std::size_t Bits, crc_type_t<Bits> Polynomial, std::size_t N>
+constexpr auto calculate_fixed(std::array<unsigned char, N> const& key)
+	noexcept
+{
+	return calculate_fixed<Bits, Polynomial, N>(key.data());
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
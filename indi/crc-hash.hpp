@@ -0,0 +1,302 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_HASH_
+#define INDI_INC_CRC_HASH_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-fixed.hpp"
+#include "indi/crc-simd.hpp"
+
+// CRC-32C as a hash function.
+//
+// One CRC-32C gives only 32 bits, and being linear, it maps keys that
+// differ in the same bits to hashes that differ in the same bits. So
+// the hash runs two CRC-32Cs side by side, with different seeds: the
+// first over the key's 8-byte words, and the second over the same words
+// with their halves swapped, which makes it a different linear function
+// of the key, so the two together carry 64 bits. A multiply-xorshift
+// finaliser then breaks up the linearity.
+//
+// The hash is the same on every machine: the CRC32 instruction
+// (SSE4.2) and the lookup table give the same CRCs, so it can be used
+// for routing between machines.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Keeps the two CRCs apart when both seeds are the same.
+constexpr auto hash_seed_twist = std::uint32_t{0x9E3779B9u};
+
+// The murmur3 finaliser, over both CRCs and the length.
+inline auto hash_finish(std::uint32_t a, std::uint32_t b,
+	std::size_t length) noexcept
+{
+	auto h = ((std::uint64_t{b} << 32) | a) ^
+		(std::uint64_t{length} * 0x9E3779B97F4A7C15u);
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDu;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53u;
+	h ^= h >> 33;
+	return h;
+}
+
+// The key, 8 bytes at a time, through the table. The second CRC takes
+// bytes 4 to 7 of each word, then 0 to 3.
+inline auto hash_table(std::uint32_t& a, std::uint32_t& b,
+	unsigned char const* p, std::size_t words) noexcept -> void
+{
+	using T = crc_type_t<32>;
+	constexpr auto const& table =
+		fixed_table<32, polynomials::crc32c>::value.values;
+	
+	auto x = T(a);
+	auto y = T(b);
+	for (; words != 0u; --words, p += 8)
+	{
+		for (auto n = 0u; n < 8u; ++n)
+		{
+			x = T(table[(x ^ p[n]) & 0xFFu] ^ (x >> 8));
+			y = T(table[(y ^ p[(n + 4u) % 8u]) & 0xFFu] ^ (y >> 8));
+		}
+	}
+	
+	a = std::uint32_t(x);
+	b = std::uint32_t(y);
+}
+
+inline auto hash_bytes_table(unsigned char const* p, std::size_t length,
+	std::uint32_t a, std::uint32_t b) noexcept
+{
+	hash_table(a, b, p, length / 8u);
+	
+	if (length % 8u != 0u)
+	{
+		unsigned char last[8] = {};
+		std::memcpy(last, p + (length & ~std::size_t{7u}), length % 8u);
+		hash_table(a, b, last, 1u);
+	}
+	
+	return hash_finish(a, b, length);
+}
+
+#if INDI_CRC_HAVE_PCLMUL && defined(__x86_64__)
+
+#define INDI_CRC_HAVE_HASH_SSE42 1
+
+#define INDI_CRC_TARGET_HASH_SSE42 __attribute__((target("sse4.2")))
+
+INDI_CRC_TARGET_HASH_SSE42
+inline auto hash_sse42(std::uint32_t& a, std::uint32_t& b,
+	std::uint64_t w) noexcept -> void
+{
+	a = std::uint32_t(_mm_crc32_u64(a, w));
+	b = std::uint32_t(_mm_crc32_u64(b, (w << 32) | (w >> 32)));
+}
+
+INDI_CRC_TARGET_HASH_SSE42
+inline auto hash_sse42(std::uint32_t& a, std::uint32_t& b,
+	unsigned char const* p, std::size_t words) noexcept -> void
+{
+	for (; words != 0u; --words, p += 8)
+	{
+		auto w = std::uint64_t{};
+		std::memcpy(&w, p, 8u);
+		hash_sse42(a, b, w);
+	}
+}
+
+// As `hash_bytes_table`, but the last few bytes are loaded as a word,
+// padded with zeros (x86 is little-endian, so the first byte goes at
+// the bottom). Keys of at least 8 bytes load the last 8, and shift out
+// the ones already done.
+INDI_CRC_TARGET_HASH_SSE42
+inline auto hash_bytes_sse42(unsigned char const* p, std::size_t length,
+	std::uint32_t a, std::uint32_t b) noexcept
+{
+	hash_sse42(a, b, p, length / 8u);
+	
+	auto const left = length % 8u;
+	if (left != 0u)
+	{
+		auto w = std::uint64_t{};
+		if (length >= 8u)
+		{
+			std::memcpy(&w, p + length - 8u, 8u);
+			w >>= 64u - 8u * left;
+		}
+		else
+		{
+			auto shift = 0u;
+			if (left & 4u)
+			{
+				auto x = std::uint32_t{};
+				std::memcpy(&x, p, 4u);
+				w = x;
+				shift = 32u;
+			}
+			if (left & 2u)
+			{
+				auto x = std::uint16_t{};
+				std::memcpy(&x, p + shift / 8u, 2u);
+				w |= std::uint64_t{x} << shift;
+				shift += 16u;
+			}
+			if (left & 1u)
+				w |= std::uint64_t{p[shift / 8u]} << shift;
+		}
+		
+		hash_sse42(a, b, w);
+	}
+	
+	return hash_finish(a, b, length);
+}
+
+#undef INDI_CRC_TARGET_HASH_SSE42
+
+#else
+
+#define INDI_CRC_HAVE_HASH_SSE42 0
+
+#endif
+
+} // namespace detail_
+
+//! Hashes a sequence of bytes with CRC-32C.
+//! 
+//! See `hash`. The key is worked on 8 bytes at a time, the last few
+//! padded with zeros; the length is mixed in at the end, so keys that
+//! only differ in trailing zeros still hash differently.
+//! 
+//! \param p  The first byte.
+//! \param length  The number of bytes.
+//! \param seed  The seed: its low and high halves seed the two CRCs.
+//! 
+//! \returns The 64-bit hash.
+inline auto hash_bytes(void const* p, std::size_t length,
+	std::uint64_t seed = 0u) noexcept -> std::uint64_t
+{
+	auto const bytes = static_cast<unsigned char const*>(p);
+	auto const a = std::uint32_t(seed);
+	auto const b = std::uint32_t(seed >> 32) ^ detail_::hash_seed_twist;
+	
+#if INDI_CRC_HAVE_HASH_SSE42
+	if (detail_::cpu().sse42)
+		return detail_::hash_bytes_sse42(bytes, length, a, b);
+#endif
+	
+	return detail_::hash_bytes_table(bytes, length, a, b);
+}
+
+namespace detail_ {
+
+// Contiguous ranges of trivially copyable elements (strings, vectors,
+// arrays, spans, and string views) hash their elements.
+template <typename Key, typename = void>
+struct is_hashable_range : std::false_type{};
+
+template <typename Key>
+struct is_hashable_range<Key, void_t<
+        decltype(*std::declval<Key const&>().data()),
+        decltype(std::declval<Key const&>().size())>> :
+    std::integral_constant<bool,
+        std::is_pointer<decltype(std::declval<Key const&>().data())>::
+            value &&
+        std::is_trivially_copyable<std::remove_pointer_t<
+            decltype(std::declval<Key const&>().data())>>::value>{};
+
+template <typename Key>
+auto hash_key(Key const& key, std::uint64_t seed, std::true_type)
+	noexcept
+{
+	return hash_bytes(key.data(), key.size() * sizeof(*key.data()), seed);
+}
+
+template <typename Key>
+auto hash_key(Key const& key, std::uint64_t seed, std::false_type)
+	noexcept
+{
+	static_assert(std::is_trivially_copyable<Key>::value,
+		"key is neither a contiguous range nor trivially copyable");
+	return hash_bytes(&key, sizeof(key), seed);
+}
+
+} // namespace detail_
+
+//! A CRC-32C hash function object, for unordered containers and for
+//! sharding.
+//! 
+//! Keys can be:
+//! 
+//! * contiguous ranges of trivially copyable elements, with `data()` and
+//!   `size()` members, like `std::string`, `std::vector<std::uint8_t>`,
+//!   and `std::string_view`, which hash their elements;
+//! * anything else trivially copyable, like integers and plain structs,
+//!   which hash their bytes (so structs with padding need their padding
+//!   zeroed, and pointers hash their address).
+//! 
+//! Each 8 bytes of the key cost two CRC32 instructions, which run side
+//! by side, on CPUs with SSE4.2, and 16 table lookups elsewhere; the
+//! hashes are the same either way. For example:
+//! 
+//!     auto map = std::unordered_map<std::string, int,
+//!         indi::crc::hash<std::string>>{};
+//!     auto const shard = indi::crc::hash<std::uint64_t>{seed}(id) % n;
+//! 
+//! \tparam Key  The key type.
+template <typename Key>
+class hash
+{
+public:
+	//! Creates a hash function.
+	//! 
+	//! \param seed  The seed (see `hash_bytes`).
+	explicit hash(std::uint64_t seed = 0u) noexcept : seed_(seed) {}
+	
+	//! Hashes a key.
+	auto operator()(Key const& key) const noexcept -> std::size_t
+	{
+		return static_cast<std::size_t>(hash64(key));
+	}
+	
+	//! Hashes a key, giving all 64 bits even where `std::size_t` is
+	//! smaller.
+	auto hash64(Key const& key) const noexcept -> std::uint64_t
+	{
+		return detail_::hash_key(key, seed_,
+			detail_::is_hashable_range<Key>{});
+	}
+	
+	//! Gets the seed.
+	auto seed() const noexcept { return seed_; }
+
+private:
+	std::uint64_t seed_;
+};
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,476 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_INDEX_
+#define INDI_INC_CRC_INDEX_
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "indi/crc.hpp"
+#include "indi/crc-file.hpp"
+#include "indi/crc-simd.hpp"
+
+// Block CRC index files.
+//
+// An index file holds the CRC of every fixed-size block of a data
+// file, so that any part of the data file can be verified without
+// reading the rest of it. Index files are laid out so they can be used
+// straight from a memory mapping: a 64-byte header, followed by one
+// 64-bit CRC per block. Everything is in the byte order of the machine
+// that wrote the file; opening an index written on a machine with the
+// other byte order fails.
+//
+// Like `indi/crc-file.hpp`, this is written against the POSIX file API.
+// I/O errors are reported by throwing `std::system_error`, and invalid
+// index files by throwing `std::runtime_error`.
+
+namespace indi {
+namespace crc {
+
+//! The header at the start of an index file.
+struct index_header
+{
+	//! `"INDICRCX"`.
+	char magic[8];
+	
+	//! The format version, currently 1.
+	std::uint32_t version;
+	
+	//! `0x01020304`, in the byte order of the machine that wrote it.
+	std::uint32_t byte_order;
+	
+	//! The CRC bit-size.
+	std::uint32_t bits;
+	
+	std::uint32_t reserved1;
+	
+	//! The encoded polynomial value.
+	std::uint64_t polynomial;
+	
+	//! The block size in bytes. The last block may be shorter.
+	std::uint64_t block_size;
+	
+	//! The size of the data file.
+	std::uint64_t file_size;
+	
+	//! The number of blocks.
+	std::uint64_t block_count;
+	
+	//! The CRC of the whole data file.
+	std::uint64_t file_crc;
+};
+
+static_assert(sizeof(index_header) == 64u,
+	"the index header must be 64 bytes");
+
+namespace detail_ {
+
+constexpr char index_magic[8] = {'I', 'N', 'D', 'I', 'C', 'R', 'C', 'X'};
+constexpr auto index_version = std::uint32_t{1u};
+constexpr auto index_byte_order = std::uint32_t{0x01020304u};
+
+inline auto index_file_size(std::uint64_t block_count) noexcept
+{
+	return sizeof(index_header) + block_count * sizeof(std::uint64_t);
+}
+
+// Owning wrapper for a memory mapping.
+class mapping
+{
+public:
+	mapping() noexcept = default;
+	
+	mapping(void* address, std::size_t length) noexcept :
+		address_{address},
+		length_{length}
+	{}
+	
+	mapping(mapping&& other) noexcept :
+		address_{other.address_},
+		length_{other.length_}
+	{
+		other.address_ = nullptr;
+	}
+	
+	auto operator=(mapping&& other) noexcept -> mapping&
+	{
+		std::swap(address_, other.address_);
+		std::swap(length_, other.length_);
+		return *this;
+	}
+	
+	~mapping()
+	{
+		if (address_)
+			::munmap(address_, length_);
+	}
+	
+	auto get() const noexcept { return address_; }
+	auto size() const noexcept { return length_; }
+
+private:
+	void* address_ = nullptr;
+	std::size_t length_ = 0;
+};
+
+inline auto map_file(int fd, std::size_t length, bool writable,
+	std::string const& path)
+{
+	auto const address = ::mmap(nullptr, length,
+		writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+		throw_errno(path);
+	return mapping{address, length};
+}
+
+// Calls `f(n)` for every `n` in `[first, last)`, on up to `threads`
+// threads (0 meaning one per hardware thread). Work is handed out one
+// item at a time, so uneven items still finish together. If any call
+// throws, the remaining items are skipped and the first exception is
+// rethrown.
+template <typename F>
+auto parallel_for(std::uint64_t first, std::uint64_t last,
+	std::size_t threads, F f)
+{
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	if (last - first < threads)
+		threads = static_cast<std::size_t>(last - first);
+	
+	std::atomic<std::uint64_t> next{first};
+	std::atomic<bool> failed{false};
+	auto error = std::exception_ptr{};
+	std::mutex error_mutex;
+	
+	auto const run = [&]
+	{
+		for (auto n = next++; n < last && !failed; n = next++)
+		{
+			try
+			{
+				f(n);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock{error_mutex};
+				if (!failed.exchange(true))
+					error = std::current_exception();
+			}
+		}
+	};
+	
+	auto workers = std::vector<std::thread>{};
+	for (auto i = std::size_t{1}; i < threads; ++i)
+		workers.emplace_back(run);
+	
+	run();
+	
+	for (auto& worker : workers)
+		worker.join();
+	
+	if (error)
+		std::rethrow_exception(error);
+}
+
+} // namespace detail_
+
+//! A read-only, memory-mapped index file.
+class crc_index
+{
+public:
+	//! Opens and maps an index file.
+	//! 
+	//! Only the header is checked; the block CRCs are used straight from
+	//! the mapping.
+	//! 
+	//! \throws std::system_error if the file could not be read.
+	//! \throws std::runtime_error if the file is not a valid index.
+	explicit crc_index(std::string const& path)
+	{
+		auto const fd = open_file(path);
+		auto const size = file_size(fd.get());
+		
+		auto const invalid = [&path](char const* why)
+		{
+			return std::runtime_error{path + ": " + why};
+		};
+		
+		if (size < sizeof(index_header))
+			throw invalid("not a CRC index");
+		
+		map_ = detail_::map_file(fd.get(), static_cast<std::size_t>(size),
+			false, path);
+		
+		auto const& h = header();
+		if (std::memcmp(h.magic, detail_::index_magic, sizeof(h.magic)) != 0)
+			throw invalid("not a CRC index");
+		if (h.byte_order != detail_::index_byte_order)
+			throw invalid("CRC index has the wrong byte order");
+		if (h.version != detail_::index_version)
+			throw invalid("unsupported CRC index version");
+		if (h.block_size == 0u || h.block_count !=
+				(h.file_size + h.block_size - 1u) / h.block_size ||
+				size != detail_::index_file_size(h.block_count))
+			throw invalid("corrupt CRC index");
+	}
+	
+	auto header() const noexcept -> index_header const&
+	{
+		return *static_cast<index_header const*>(map_.get());
+	}
+	
+	//! Gets the CRCs of all the blocks.
+	auto block_crcs() const noexcept -> std::uint64_t const*
+	{
+		return reinterpret_cast<std::uint64_t const*>(
+			static_cast<char const*>(map_.get()) + sizeof(index_header));
+	}
+	
+	auto block_count() const noexcept { return header().block_count; }
+	auto block_size() const noexcept { return header().block_size; }
+	
+	//! Gets the length of a block (the last one may be short).
+	auto block_length(std::uint64_t n) const noexcept
+	{
+		auto const& h = header();
+		return std::min(h.block_size, h.file_size - n * h.block_size);
+	}
+
+private:
+	detail_::mapping map_;
+};
+
+//! Builds an index file for a data file.
+//! 
+//! The blocks are checksummed in parallel (with `calculate_raw_file`),
+//! and the whole-file CRC is then derived from the block CRCs with
+//! `combine`, so the data is only read once. The index is written to a
+//! temporary file that is renamed into place when it is complete, so
+//! an interrupted build never leaves a partial index behind.
+//! 
+//! \tparam Bits  The CRC bit-size (at most 64).
+//! \tparam T  The CRC type.
+//! 
+//! \param path  The data file.
+//! \param index_path  The index file to write.
+//! \param poly  The encoded polynomial value.
+//! \param block_size  The block size in bytes.
+//! \param threads  The number of threads (0 means one per hardware
+//!     thread).
+//! 
+//! \throws std::system_error if a file could not be read or written.
+//! \throws std::invalid_argument if `block_size` is 0.
+//! 
+//! \returns The CRC of the whole data file.
+template <std::size_t Bits, typename T>
+auto build_index(std::string const& path, std::string const& index_path,
+	T poly, std::uint64_t block_size, std::size_t threads = 0) -> T
+{
+	static_assert(Bits <= 64u, "index files hold at most 64-bit CRCs");
+	
+	if (block_size == 0u)
+		throw std::invalid_argument{"block size must not be 0"};
+	
+	constexpr auto ones = detail_::ones<Bits, T>();
+	
+	auto const fd = open_file(path);
+	auto const size = file_size(fd.get());
+	auto const count = (size + block_size - 1u) / block_size;
+	
+	auto const temp_path = index_path + ".tmp";
+	auto const out = file_descriptor{::open(temp_path.c_str(),
+		O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)};
+	if (!out)
+		detail_::throw_errno(temp_path);
+	
+	try
+	{
+		auto const length = detail_::index_file_size(count);
+		if (::ftruncate(out.get(), static_cast<::off_t>(length)) != 0)
+			detail_::throw_errno(temp_path);
+		
+		auto const map = detail_::map_file(out.get(), length, true,
+			temp_path);
+		auto const h = static_cast<index_header*>(map.get());
+		auto const crcs = reinterpret_cast<std::uint64_t*>(
+			static_cast<char*>(map.get()) + sizeof(index_header));
+		
+		auto const engine = clmul_engine<Bits, T>{poly};
+		auto const block_length = [=](std::uint64_t n)
+		{
+			return std::min(block_size, size - n * block_size);
+		};
+		
+		detail_::parallel_for(0u, count, threads, [&](std::uint64_t n)
+		{
+			auto bytes_read = std::uint_least64_t{0};
+			auto const length = block_length(n);
+			crcs[n] = ones ^ calculate_raw_file<Bits>(ones, fd.get(),
+				n * block_size, length, engine, &bytes_read);
+			if (bytes_read != length)
+				throw std::runtime_error{path + ": file changed while reading"};
+		});
+		
+		// Starting from the CRC of no data at all, which is 0.
+		auto file_crc = T{0};
+		for (auto n = std::uint64_t{0}; n < count; ++n)
+			file_crc = combine<Bits>(file_crc, static_cast<T>(crcs[n]),
+				block_length(n), poly);
+		
+		std::memcpy(h->magic, detail_::index_magic, sizeof(h->magic));
+		h->version = detail_::index_version;
+		h->byte_order = detail_::index_byte_order;
+		h->bits = static_cast<std::uint32_t>(Bits);
+		h->reserved1 = 0u;
+		h->polynomial = poly;
+		h->block_size = block_size;
+		h->file_size = size;
+		h->block_count = count;
+		h->file_crc = file_crc;
+		
+		if (::msync(map.get(), length, MS_SYNC) != 0)
+			detail_::throw_errno(temp_path);
+		if (::rename(temp_path.c_str(), index_path.c_str()) != 0)
+			detail_::throw_errno(index_path);
+		
+		return file_crc;
+	}
+	catch (...)
+	{
+		::unlink(temp_path.c_str());
+		throw;
+	}
+}
+
+//! Verifies blocks of a data file against its index.
+//! 
+//! To resume an interrupted verification of the whole file, pass the
+//! block it had got to as `first`.
+//! 
+//! \tparam Bits  The CRC bit-size, which must match the index.
+//! 
+//! \param fd  The open data file.
+//! \param index  The index.
+//! \param first  The first block to verify.
+//! \param count  The number of blocks to verify (clamped to the end of
+//!     the file).
+//! \param threads  The number of threads (0 means one per hardware
+//!     thread).
+//! 
+//! \throws std::system_error if the data file could not be read.
+//! \throws std::invalid_argument if `Bits` doesn't match the index.
+//! 
+//! \returns The numbers of the blocks that don't match, in increasing
+//!     order. Blocks that are cut short by the file having been
+//!     truncated don't match.
+template <std::size_t Bits>
+auto verify_blocks(int fd, crc_index const& index, std::uint64_t first,
+	std::uint64_t count, std::size_t threads = 0)
+{
+	using T = crc_type_t<Bits>;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	
+	auto const& h = index.header();
+	if (h.bits != Bits)
+		throw std::invalid_argument{"CRC bit-size doesn't match the index"};
+	
+	auto const engine = clmul_engine<Bits>{static_cast<T>(h.polynomial)};
+	
+	first = std::min(first, h.block_count);
+	auto const last = first + std::min(count, h.block_count - first);
+	
+	auto bad = std::vector<std::uint64_t>{};
+	std::mutex bad_mutex;
+	
+	detail_::parallel_for(first, last, threads, [&](std::uint64_t n)
+	{
+		auto bytes_read = std::uint_least64_t{0};
+		auto const length = index.block_length(n);
+		auto const crc = ones ^ calculate_raw_file<Bits>(ones, fd,
+			n * h.block_size, length, engine, &bytes_read);
+		
+		if (bytes_read != length || crc != index.block_crcs()[n])
+		{
+			std::lock_guard<std::mutex> lock{bad_mutex};
+			bad.push_back(n);
+		}
+	});
+	
+	std::sort(bad.begin(), bad.end());
+	return bad;
+}
+
+//! Verifies a byte range of a data file against its index.
+//! 
+//! Every block that overlaps the range is verified in full.
+//! 
+//! \tparam Bits  The CRC bit-size, which must match the index.
+//! 
+//! \param fd  The open data file.
+//! \param index  The index.
+//! \param offset  The offset of the first byte.
+//! \param length  The number of bytes (clamped to the end of the file).
+//! \param threads  The number of threads (0 means one per hardware
+//!     thread).
+//! 
+//! \throws std::system_error if the data file could not be read.
+//! \throws std::invalid_argument if `Bits` doesn't match the index.
+//! 
+//! \returns The numbers of the blocks that don't match, in increasing
+//!     order.
+template <std::size_t Bits>
+auto verify_range(int fd, crc_index const& index, std::uint64_t offset,
+	std::uint64_t length, std::size_t threads = 0)
+{
+	auto const block_size = index.block_size();
+	auto const size = index.header().file_size;
+	
+	// Clamp the range to the end of the file.
+	if (offset >= size)
+		length = 0u;
+	else
+		length = std::min(length, size - offset);
+	
+	if (length == 0u)
+		return verify_blocks<Bits>(fd, index, 0u, 0u, threads);
+	
+	auto const first = offset / block_size;
+	auto const last = (offset + length - 1u) / block_size;
+	return verify_blocks<Bits>(fd, index, first, last - first + 1u,
+		threads);
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,255 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_NIBBLE_
+#define INDI_INC_CRC_NIBBLE_
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+
+namespace indi {
+namespace crc {
+
+//! Generates a 16-element lookup table for CRC calculations a nibble (4
+//! bits) at a time.
+//! 
+//! This is the same as `generate_table`, only for 4-bit values instead
+//! of 8-bit ones. It's 16 times smaller, at the cost of twice as many
+//! lookups; see `nibble_engine`.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns An std::array<T, 16> with the computed CRCs of every value
+//!          from 0 to 15, using the given polynomial.
+template <std::size_t Bits, typename T>
+constexpr auto generate_nibble_table(T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	auto const reversed_polynomial =
+		polynomials::reversed<Bits>(polynomial);
+	
+	auto table = std::array<T, 16>{};
+	
+	for (auto n = std::size_t{0}; n < std::size_t{16}; ++n)
+	{
+		auto crc = T(n);
+		
+		for (auto bit = 0; bit < 4; ++bit)
+			crc = T((crc & 1u) ? ((crc >> 1) ^ reversed_polynomial) :
+				(crc >> 1));
+		
+		table[n] = crc;
+	}
+	
+	return table;
+}
+
+//! Generates a 16-element lookup table for non-reflected CRC
+//! calculations a nibble at a time.
+//! 
+//! This is the same as `generate_normal_table`, only for 4-bit values
+//! instead of 8-bit ones.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns An std::array<T, 16> with the computed non-reflected CRCs
+//!          of every value from 0 to 15, using the given polynomial.
+template <std::size_t Bits, typename T>
+constexpr auto generate_normal_nibble_table(T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	constexpr auto mask = detail_::ones<Bits, T>();
+	
+	auto table = std::array<T, 16>{};
+	
+	for (auto n = std::size_t{0}; n < std::size_t{16}; ++n)
+	{
+		auto crc = T{0};
+		
+		for (auto bit = 3; bit >= 0; --bit)
+		{
+			auto const feedback = ((crc >> (Bits - 1u)) ^ (n >> bit)) & 1u;
+			crc = T((crc << 1) & mask);
+			if (feedback)
+				crc ^= polynomial;
+		}
+		
+		table[n] = crc;
+	}
+	
+	return table;
+}
+
+//! A CRC engine that uses a 16-element lookup table.
+//! 
+//! A 256-element table takes 1 to 2 KB (depending on the CRC type),
+//! which can push other data out of the L1 cache; on paths where the
+//! table has usually been evicted by the time a CRC is needed, the
+//! cache misses can cost more than the CRC itself. This engine looks
+//! up a nibble at a time instead, from a table that takes 16 bytes for
+//! CRCs up to 8 bits, 32 bytes up to 16 bits, one 64-byte cache line up
+//! to 32 bits, and two cache lines up to 64 bits. It needs twice as
+//! many lookups as a 256-element table, so it is slower when the table
+//! would be in cache anyway.
+//! 
+//! Like a lookup table, a reflected engine can be passed to `calculate`
+//! and `calculate_raw`, and a non-reflected one to
+//! `calculate_normal_raw`:
+//! 
+//!     auto const engine = indi::crc::nibble_engine<32>{
+//!         indi::crc::polynomials::crc32c};
+//!     auto const crc = indi::crc::calculate<32>(data, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+template <std::size_t Bits, typename T, bool Reflected>
+class basic_nibble_engine
+{
+public:
+	using crc_engine_tag = void;
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto reflected = Reflected;
+	
+	//! The table entries are the smallest type that holds a CRC.
+	using entry_type = detail_::crc_least_t<Bits>;
+	using table_type = std::array<entry_type, 16>;
+	
+	//! Creates an engine.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	explicit basic_nibble_engine(T polynomial) noexcept :
+		table_(compact(Reflected ?
+			generate_nibble_table<Bits>(polynomial) :
+			generate_normal_nibble_table<Bits>(polynomial)))
+	{}
+	
+	//! Calculates the raw CRC of a sequence of bytes.
+	//! 
+	//! \param crc  The raw CRC of the preceding sequence (or the
+	//!     initial value).
+	//! \param first  The start of the sequence.
+	//! \param last  The end of the sequence.
+	//! 
+	//! \returns The raw CRC.
+	constexpr auto update(T crc, unsigned char const* first,
+		unsigned char const* last) const noexcept -> T
+	{
+		for (; first != last; ++first)
+			crc = next(crc, *first, std::integral_constant<bool,
+				Reflected>{});
+		
+		return crc;
+	}
+	
+	//! Gets the lookup table.
+	constexpr auto table() const noexcept -> table_type const&
+	{
+		return table_;
+	}
+
+private:
+	static auto compact(std::array<T, 16> const& table) noexcept
+	{
+		auto result = table_type{};
+		for (auto n = std::size_t{0}; n < std::size_t{16}; ++n)
+			result[n] = entry_type(table[n]);
+		return result;
+	}
+	
+	constexpr auto next(T crc, unsigned char b,
+		std::true_type /* reflected */) const noexcept -> T
+	{
+		crc ^= b;
+		crc = T((crc >> 4) ^ table_[crc & 0xfu]);
+		crc = T((crc >> 4) ^ table_[crc & 0xfu]);
+		return crc;
+	}
+	
+	constexpr auto next(T crc, unsigned char b,
+		std::false_type /* reflected */) const noexcept -> T
+	{
+		crc = next_normal(crc, b >> 4);
+		crc = next_normal(crc, b & 0xfu);
+		return crc;
+	}
+	
+	constexpr auto next_normal(T crc, unsigned nibble) const noexcept -> T
+	{
+		constexpr auto up = Bits <= 4u ? 4u - Bits : 0u;
+		constexpr auto down = Bits > 4u ? Bits - 4u : 0u;
+		
+		// As in calculate_next_normal, for CRCs narrower than a nibble
+		// the whole CRC combines with the nibble.
+		return Bits <= 4u ?
+			T(table_[((crc << up) ^ nibble) & 0xfu]) :
+			T((table_[((crc >> down) ^ nibble) & 0xfu] ^ (crc << 4)) &
+				detail_::ones<Bits, T>());
+	}
+	
+	alignas(sizeof(table_type) < 64u ? sizeof(table_type) : 64u)
+		table_type table_;
+};
+
+//! A reflected CRC engine that uses a 16-element lookup table.
+//! 
+//! \see basic_nibble_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using nibble_engine = basic_nibble_engine<Bits, T, true>;
+
+//! A non-reflected CRC engine that uses a 16-element lookup table.
+//! 
+//! \see basic_nibble_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using normal_nibble_engine = basic_nibble_engine<Bits, T, false>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,1478 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_SIMD_
+#define INDI_INC_CRC_SIMD_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-braid.hpp"
+
+// Carry-less multiplication (PCLMULQDQ and VPCLMULQDQ) CRC engines.
+//
+// These need GCC or Clang on x86, for the `target` function attribute
+// that lets the SIMD code live in the same binary as code for machines
+// without it. Which code runs is decided at run time, so the same
+// binary runs everywhere; anywhere else, the engines fall back to
+// braided table lookups (see `indi/crc-braid.hpp`).
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || defined(__i386__))
+#define INDI_CRC_HAVE_PCLMUL 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define INDI_CRC_HAVE_PCLMUL 0
+#endif
+
+// VPCLMULQDQ needs GCC 8 or Clang 6 to compile.
+#if INDI_CRC_HAVE_PCLMUL && defined(__x86_64__) && \
+	((defined(__clang__) && __clang_major__ >= 6) || \
+		(!defined(__clang__) && __GNUC__ >= 8))
+#define INDI_CRC_HAVE_VPCLMUL 1
+#else
+#define INDI_CRC_HAVE_VPCLMUL 0
+#endif
+
+namespace indi {
+namespace crc {
+
+//! The kernels a `clmul_engine` can use for large inputs.
+enum class clmul_kernel
+{
+	//! The fastest one the CPU supports.
+	automatic,
+	//! Braided lookup tables (see `braided_engine`).
+	table,
+	//! 128-bit PCLMULQDQ folding.
+	pclmul,
+	//! 512-bit AVX-512 VPCLMULQDQ folding.
+	vpclmul,
+	//! 16 byte-wise CRCs at once, with SSSE3 PSHUFB table lookups
+	//! (CRCs of up to 32 bits only). This is no faster than `table`, so
+	//! it is only used when asked for.
+	pshufb,
+	//! 32 byte-wise CRCs at once, with AVX2 VPSHUFB table lookups
+	//! (CRCs of up to 32 bits only).
+	vpshufb
+};
+
+namespace detail_ {
+
+// Below this many bytes, setting up the folding costs more than it
+// saves, and the table is used.
+constexpr auto clmul_min_length = std::size_t{64u};
+
+// The default size above which the 512-bit kernel is used. Running
+// 512-bit instructions can lower the clock speed of the core for a
+// while afterwards, which slows down everything else running on it, so
+// they are only worth it for large inputs.
+constexpr auto vpclmul_default_threshold = std::size_t{4096u};
+
+static_assert(vpclmul_default_threshold <= cache_block,
+	"blocked functions must reach the 512-bit kernel by default");
+
+// The 512-bit kernel needs at least this much.
+constexpr auto vpclmul_min_length = std::size_t{256u};
+
+// Below this many bytes, the shuffle kernels are slower than the braided
+// tables, mostly because of the cost of combining the CRCs of their
+// parts. The 16-part kernel is at best level with the tables, even on
+// large inputs.
+constexpr auto vpshufb_min_length = std::size_t{8192u};
+constexpr auto pshufb_min_length = std::size_t{16384u};
+
+// All the folding is done on 64-bit CRCs. A CRC of any width up to 64
+// is turned into one by using the polynomial P' = P * x^(64 - Bits):
+// the 64-bit CRC with P' is then the CRC with P, zero-extended (when
+// reflected) or shifted to the top (when not).
+template <std::size_t Bits, typename T>
+constexpr auto clmul_polynomial(T polynomial) noexcept
+{
+	return std::uint64_t(std::uint64_t(polynomial) << (64u - Bits));
+}
+
+// The constants for folding a 64-bit CRC with P'.
+//
+// In reflected form, bit i of a 128-bit value is the coefficient of
+// x^(127 - i), so the low half holds the high terms. Carry-less
+// multiplication of two reflected 64-bit values gives their product
+// times x. So to move a 128-bit value forward by n bits, its low half is
+// multiplied by x^(n + 63) mod P' and its high half by x^(n - 1) mod P';
+// each `fold` pair holds those two.
+// 
+// In normal form (for non-reflected CRCs), bit i is the coefficient of
+// x^i and products come out exact, so the low half is multiplied by
+// x^n mod P' and the high half by x^(n + 64) mod P'. The constants are
+// then in normal form too.
+struct clmul_constants
+{
+	std::uint64_t fold128[2];
+	std::uint64_t fold512[2];
+	std::uint64_t fold1024[2];
+	std::uint64_t fold2048[2];
+	
+	// floor(x^128 / P') - x^64, for Barrett reduction.
+	std::uint64_t mu;
+	
+	// P' - x^64.
+	std::uint64_t polynomial;
+};
+
+template <std::size_t Bits, typename T>
+constexpr auto make_clmul_constants(T polynomial) noexcept
+{
+	auto const poly = clmul_polynomial<Bits>(polynomial);
+	
+	auto k = clmul_constants{};
+	k.fold128[0] = x_pow_mod<64>(128u + 63u, poly);
+	k.fold128[1] = x_pow_mod<64>(128u - 1u, poly);
+	k.fold512[0] = x_pow_mod<64>(512u + 63u, poly);
+	k.fold512[1] = x_pow_mod<64>(512u - 1u, poly);
+	k.fold1024[0] = x_pow_mod<64>(1024u + 63u, poly);
+	k.fold1024[1] = x_pow_mod<64>(1024u - 1u, poly);
+	k.fold2048[0] = x_pow_mod<64>(2048u + 63u, poly);
+	k.fold2048[1] = x_pow_mod<64>(2048u - 1u, poly);
+	k.mu = barrett_mu<64>(poly);
+	k.polynomial = polynomials::reversed<64>(poly);
+	return k;
+}
+
+template <std::size_t Bits, typename T>
+constexpr auto make_normal_clmul_constants(T polynomial) noexcept
+{
+	auto const poly = clmul_polynomial<Bits>(polynomial);
+	
+	auto k = clmul_constants{};
+	k.fold128[0] = x_pow_mod_normal<64>(128u, poly);
+	k.fold128[1] = x_pow_mod_normal<64>(128u + 64u, poly);
+	k.fold512[0] = x_pow_mod_normal<64>(512u, poly);
+	k.fold512[1] = x_pow_mod_normal<64>(512u + 64u, poly);
+	k.fold1024[0] = x_pow_mod_normal<64>(1024u, poly);
+	k.fold1024[1] = x_pow_mod_normal<64>(1024u + 64u, poly);
+	k.fold2048[0] = x_pow_mod_normal<64>(2048u, poly);
+	k.fold2048[1] = x_pow_mod_normal<64>(2048u + 64u, poly);
+	k.mu = barrett_mu_normal<64>(poly);
+	k.polynomial = poly;
+	return k;
+}
+
+// The constants for the shuffle kernels.
+//
+// These calculate a CRC of up to 32 bits a byte at a time, as with a
+// lookup table, but for 16 or 32 separate parts of the input at once,
+// one in each byte of a vector register. A CRC is kept in up to four
+// "planes": plane 0 holds the byte that the next input byte is added to,
+// and each step shifts the others down a plane. The 256-element table
+// is the xor of two 16-element ones, indexed by the low and high nibbles
+// of the byte, so each byte of it fits in a register and is looked up
+// with PSHUFB.
+//
+// Non-reflected CRCs are worked out on a whole number of bytes, with
+// the polynomial P * x^(8 * planes - Bits), like the folding kernels do.
+struct shuffle_constants
+{
+	// Byte `plane` of the table entries for a low nibble, and for a high
+	// nibble.
+	unsigned char low[4][16];
+	unsigned char high[4][16];
+	
+	// x^(8 * 2^n) mod P, in reflected form, for combining the CRCs of
+	// the parts.
+	std::uint32_t powers[64];
+	
+	// The polynomial in reversed form.
+	std::uint32_t reversed_polynomial;
+};
+
+template <std::size_t Bits>
+constexpr auto shuffle_planes = (Bits + 7u) / 8u;
+
+// Fills in the powers of x needed to combine CRCs.
+template <std::size_t Bits>
+constexpr auto make_shuffle_powers(shuffle_constants& k,
+	std::uint32_t polynomial) noexcept
+{
+	k.reversed_polynomial = polynomials::reversed<Bits>(polynomial);
+	k.powers[0] = x_pow_8n_mod<Bits>(1u, k.reversed_polynomial);
+	for (auto n = std::size_t{1}; n < 64u; ++n)
+		k.powers[n] = multiply_mod<Bits>(k.powers[n - 1],
+			k.powers[n - 1], k.reversed_polynomial);
+}
+
+template <std::size_t Bits, typename T>
+constexpr auto make_shuffle_constants(T polynomial,
+	std::true_type /* reflected */) noexcept
+{
+	auto k = shuffle_constants{};
+	auto const table = generate_table<Bits>(std::uint32_t(polynomial));
+	
+	for (auto plane = std::size_t{0}; plane < shuffle_planes<Bits>; ++plane)
+	{
+		for (auto n = std::size_t{0}; n < 16u; ++n)
+		{
+			k.low[plane][n] = static_cast<unsigned char>(
+				table[n] >> (8u * plane));
+			k.high[plane][n] = static_cast<unsigned char>(
+				table[n << 4] >> (8u * plane));
+		}
+	}
+	
+	make_shuffle_powers<Bits>(k, std::uint32_t(polynomial));
+	return k;
+}
+
+template <std::size_t Bits, typename T>
+constexpr auto make_shuffle_constants(T polynomial,
+	std::false_type /* reflected */) noexcept
+{
+	constexpr auto planes = shuffle_planes<Bits>;
+	constexpr auto width = 8u * planes;
+	
+	auto k = shuffle_constants{};
+	auto const table = generate_normal_table<width>(
+		std::uint32_t(std::uint32_t(polynomial) << (width - Bits)));
+	
+	// Plane 0 is the top byte.
+	for (auto plane = std::size_t{0}; plane < planes; ++plane)
+	{
+		auto const shift = 8u * (planes - 1u - plane);
+		for (auto n = std::size_t{0}; n < 16u; ++n)
+		{
+			k.low[plane][n] = static_cast<unsigned char>(
+				table[n] >> shift);
+			k.high[plane][n] = static_cast<unsigned char>(
+				table[n << 4] >> shift);
+		}
+	}
+	
+	make_shuffle_powers<Bits>(k, std::uint32_t(polynomial));
+	return k;
+}
+
+// The shuffle kernels are only for CRCs of up to 32 bits.
+template <std::size_t Bits, bool Reflected, typename T>
+constexpr auto make_shuffle_constants_for(T polynomial, std::false_type
+	/* narrow */) noexcept
+{
+	return (void)polynomial, shuffle_constants{};
+}
+
+template <std::size_t Bits, bool Reflected, typename T>
+constexpr auto make_shuffle_constants_for(T polynomial, std::true_type
+	/* narrow */) noexcept
+{
+	return make_shuffle_constants<Bits>(polynomial,
+		std::integral_constant<bool, Reflected>{});
+}
+
+// Gets the highest set bit of a value (or 0).
+constexpr auto top_bit(std::size_t value) noexcept
+{
+	while (value & (value - 1u))
+		value &= value - 1u;
+	return value;
+}
+
+// Combines the CRCs of the parts worked out by a shuffle kernel, each
+// `length` bytes long, and turns the result back into a `Bits`-bit CRC.
+template <std::size_t Bits, bool Reflected>
+inline auto shuffle_combine(std::uint32_t const* crcs, std::size_t parts,
+	std::size_t length, shuffle_constants const& k) noexcept
+{
+	constexpr auto shift = Reflected ? 0u :
+		unsigned(8u * shuffle_planes<Bits> - Bits);
+	
+	// Combining is done in reflected form.
+	auto const reflect = [](std::uint32_t crc)
+	{
+		crc >>= shift;
+		return Reflected ? crc : polynomials::reversed<Bits>(crc);
+	};
+	
+	// x^(8 * length) mod P (`length` has few bits set).
+	// IMPORTANT: The "1" must be cast to std::uint32_t before shifting.
+	auto advance = std::uint32_t(std::uint32_t{0x1u} << (Bits - 1u));
+	for (auto n = std::size_t{0}; length != 0u; ++n, length >>= 1)
+		if (length & 1u)
+			advance = multiply_mod<Bits>(advance, k.powers[n],
+				k.reversed_polynomial);
+	
+	// Multiplying by `advance` is linear, so it can be done by looking
+	// up each nibble of the other value in a table, filled in from
+	// `advance * x^n` for each term x^n. Bit `Bits - 1 - n` of a value
+	// is its x^n term.
+	constexpr auto nibbles = (Bits + 3u) / 4u;
+	std::uint32_t terms[4u * nibbles] = {};
+	terms[Bits - 1u] = advance;
+	for (auto bit = Bits - 1u; bit-- > 0u; )
+		terms[bit] = multiply_x_mod<Bits>(terms[bit + 1u],
+			k.reversed_polynomial);
+	
+	std::uint32_t times[nibbles][16];
+	for (auto n = 0u; n < nibbles; ++n)
+	{
+		times[n][0] = 0u;
+		for (auto bit = 0u; bit < 4u; ++bit)
+			for (auto low = 0u; low < (1u << bit); ++low)
+				times[n][low | (1u << bit)] = times[n][low] ^
+					terms[4u * n + bit];
+	}
+	
+	auto crc = reflect(crcs[0]);
+	for (auto part = std::size_t{1}; part < parts; ++part)
+	{
+		auto product = reflect(crcs[part]);
+		for (auto n = 0u; n < nibbles; ++n)
+			product ^= times[n][(crc >> (4u * n)) & 0xFu];
+		crc = product;
+	}
+	
+	return Reflected ? crc : polynomials::reversed<Bits>(crc);
+}
+
+struct cpu_features
+{
+	bool pclmul = false;
+	bool vpclmul = false;
+	bool sse42 = false;
+	bool ssse3 = false;
+	bool avx2 = false;
+};
+
+inline auto detect_cpu_features() noexcept
+{
+	auto f = cpu_features{};
+	
+#if INDI_CRC_HAVE_PCLMUL
+	unsigned a = 0, b = 0, c = 0, d = 0;
+	if (!__get_cpuid(1u, &a, &b, &c, &d))
+		return f;
+	
+	// PCLMULQDQ, and SSE4.1 for moving 64-bit values out of registers.
+	f.pclmul = (c & bit_PCLMUL) && (c & bit_SSE4_1);
+	f.ssse3 = (c & bit_SSSE3) != 0;
+	f.sse42 = (c & bit_SSE4_2) != 0;
+	
+	auto const osxsave = (c & bit_OSXSAVE) != 0;
+	auto const avx = (c & bit_AVX) != 0;
+	
+	if (!osxsave || __get_cpuid_max(0u, nullptr) < 7u)
+		return f;
+	
+	__cpuid_count(7u, 0u, a, b, c, d);
+	auto const avx2 = (b & (1u << 5)) != 0;
+	auto const avx512f = (b & (1u << 16)) != 0;
+	auto const avx512bw = (b & (1u << 30)) != 0;
+	auto const vpclmulqdq = (c & (1u << 10)) != 0;
+	
+	// The OS must also save the AVX and AVX-512 registers on context
+	// switches.
+	unsigned xcr0_lo = 0, xcr0_hi = 0;
+	__asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0u));
+	auto const ymm_state = (xcr0_lo & 0x06u) == 0x06u;
+	auto const zmm_state = (xcr0_lo & 0xE6u) == 0xE6u;
+	
+	f.avx2 = avx && avx2 && ymm_state;
+	f.vpclmul = f.pclmul && avx512f && avx512bw && vpclmulqdq &&
+		zmm_state;
+#endif
+	
+	return f;
+}
+
+inline auto cpu() noexcept -> cpu_features const&
+{
+	static auto const features = detect_cpu_features();
+	return features;
+}
+
+#if INDI_CRC_HAVE_PCLMUL
+
+#define INDI_CRC_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_load(std::uint64_t const (&k)[2]) noexcept
+{
+	return _mm_set_epi64x(static_cast<long long>(k[1]),
+		static_cast<long long>(k[0]));
+}
+
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_fold(__m128i x, __m128i k) noexcept
+{
+	return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+		_mm_clmulepi64_si128(x, k, 0x11));
+}
+
+// Reduces a 128-bit value to its CRC, in reflected form.
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_reduce(__m128i x, clmul_constants const& k,
+	std::true_type /* reflected */) noexcept -> std::uint64_t
+{
+	// The CRC is (X * x^64) mod P'. Fold the low half (the high terms)
+	// onto the high half, which leaves a 128-bit value congruent to
+	// X * x^64.
+	auto const z = _mm_xor_si128(
+		_mm_clmulepi64_si128(x, clmul_load(k.fold128), 0x10),
+		_mm_srli_si128(x, 8));
+	
+	// Barrett reduction: with W = H * x^64 + L, the quotient is
+	// H + floor(H * mu / x^64), and the remainder is L plus the low 64
+	// terms of the quotient times P'.
+	auto const constants = _mm_set_epi64x(
+		static_cast<long long>(k.polynomial), static_cast<long long>(k.mu));
+	
+	auto const high = static_cast<std::uint64_t>(_mm_cvtsi128_si64(z));
+	auto const low = static_cast<std::uint64_t>(_mm_extract_epi64(z, 1));
+	
+	auto const t = _mm_clmulepi64_si128(z, constants, 0x00);
+	auto const q = high ^
+		(static_cast<std::uint64_t>(_mm_cvtsi128_si64(t)) << 1);
+	
+	auto const qp = _mm_clmulepi64_si128(
+		_mm_cvtsi64_si128(static_cast<long long>(q)), constants, 0x10);
+	auto const r = (static_cast<std::uint64_t>(_mm_extract_epi64(qp, 1))
+		<< 1) | (static_cast<std::uint64_t>(_mm_cvtsi128_si64(qp)) >> 63);
+	
+	return low ^ r;
+}
+
+// Reduces a 128-bit value to its CRC, in normal form.
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_reduce(__m128i x, clmul_constants const& k,
+	std::false_type /* reflected */) noexcept -> std::uint64_t
+{
+	// As above, but the high half holds the high terms, and products
+	// need no adjusting.
+	auto const z = _mm_xor_si128(
+		_mm_clmulepi64_si128(x, clmul_load(k.fold128), 0x01),
+		_mm_slli_si128(x, 8));
+	
+	auto const constants = _mm_set_epi64x(
+		static_cast<long long>(k.polynomial), static_cast<long long>(k.mu));
+	
+	auto const high = static_cast<std::uint64_t>(_mm_extract_epi64(z, 1));
+	auto const low = static_cast<std::uint64_t>(_mm_cvtsi128_si64(z));
+	
+	auto const t = _mm_clmulepi64_si128(z, constants, 0x01);
+	auto const q = high ^
+		static_cast<std::uint64_t>(_mm_extract_epi64(t, 1));
+	
+	auto const qp = _mm_clmulepi64_si128(
+		_mm_cvtsi64_si128(static_cast<long long>(q)), constants, 0x10);
+	
+	return low ^ static_cast<std::uint64_t>(_mm_cvtsi128_si64(qp));
+}
+
+// Loads 16 bytes of input. For non-reflected CRCs, the first byte holds
+// the highest terms, so the bytes are reversed to put it at the top.
+template <bool Reflected>
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_loadu(unsigned char const* p) noexcept
+{
+	auto const x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+	if (Reflected)
+		return x;
+	
+	return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+		10, 11, 12, 13, 14, 15));
+}
+
+// Puts a 64-bit CRC where the first 8 bytes of input go.
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_initial(std::uint64_t crc, std::true_type /* reflected */)
+	noexcept
+{
+	return _mm_cvtsi64_si128(static_cast<long long>(crc));
+}
+
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_initial(std::uint64_t crc,
+	std::false_type /* reflected */) noexcept
+{
+	return _mm_set_epi64x(static_cast<long long>(crc), 0);
+}
+
+// Calculates a 64-bit raw CRC with 128-bit folding.
+// `length` must be a multiple of 16, and at least 16.
+template <bool Reflected>
+INDI_CRC_TARGET_PCLMUL
+inline auto clmul_update(std::uint64_t crc, unsigned char const* p,
+	std::size_t length, clmul_constants const& k) noexcept -> std::uint64_t
+{
+	using reflected = std::integral_constant<bool, Reflected>;
+	
+	auto const k128 = clmul_load(k.fold128);
+	
+	auto x0 = _mm_xor_si128(clmul_loadu<Reflected>(p),
+		clmul_initial(crc, reflected{}));
+	p += 16;
+	length -= 16;
+	
+	// Eight independent accumulators keep the multiplier busy.
+	if (length >= 112u)
+	{
+		auto x1 = clmul_loadu<Reflected>(p);
+		auto x2 = clmul_loadu<Reflected>(p + 16);
+		auto x3 = clmul_loadu<Reflected>(p + 32);
+		auto x4 = clmul_loadu<Reflected>(p + 48);
+		auto x5 = clmul_loadu<Reflected>(p + 64);
+		auto x6 = clmul_loadu<Reflected>(p + 80);
+		auto x7 = clmul_loadu<Reflected>(p + 96);
+		p += 112;
+		length -= 112;
+		
+		auto const k1024 = clmul_load(k.fold1024);
+		
+		while (length >= 128u)
+		{
+			x0 = _mm_xor_si128(clmul_fold(x0, k1024),
+				clmul_loadu<Reflected>(p));
+			x1 = _mm_xor_si128(clmul_fold(x1, k1024),
+				clmul_loadu<Reflected>(p + 16));
+			x2 = _mm_xor_si128(clmul_fold(x2, k1024),
+				clmul_loadu<Reflected>(p + 32));
+			x3 = _mm_xor_si128(clmul_fold(x3, k1024),
+				clmul_loadu<Reflected>(p + 48));
+			x4 = _mm_xor_si128(clmul_fold(x4, k1024),
+				clmul_loadu<Reflected>(p + 64));
+			x5 = _mm_xor_si128(clmul_fold(x5, k1024),
+				clmul_loadu<Reflected>(p + 80));
+			x6 = _mm_xor_si128(clmul_fold(x6, k1024),
+				clmul_loadu<Reflected>(p + 96));
+			x7 = _mm_xor_si128(clmul_fold(x7, k1024),
+				clmul_loadu<Reflected>(p + 112));
+			p += 128;
+			length -= 128;
+		}
+		
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x1);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x2);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x3);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x4);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x5);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x6);
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), x7);
+	}
+	
+	while (length >= 16u)
+	{
+		x0 = _mm_xor_si128(clmul_fold(x0, k128), clmul_loadu<Reflected>(p));
+		p += 16;
+		length -= 16;
+	}
+	
+	return clmul_reduce(x0, k, reflected{});
+}
+
+#undef INDI_CRC_TARGET_PCLMUL
+
+#endif // INDI_CRC_HAVE_PCLMUL
+
+#if INDI_CRC_HAVE_VPCLMUL
+
+#define INDI_CRC_TARGET_VPCLMUL \
+	__attribute__((target("avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1")))
+
+// Puts loaded bytes in order (see `clmul_loadu`).
+template <bool Reflected>
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_order(__m512i x) noexcept
+{
+	if (Reflected)
+		return x;
+	
+	// Reverse the bytes in each 128-bit lane.
+	return _mm512_shuffle_epi8(x, _mm512_set_epi64(
+		0x0001020304050607, 0x08090A0B0C0D0E0F,
+		0x0001020304050607, 0x08090A0B0C0D0E0F,
+		0x0001020304050607, 0x08090A0B0C0D0E0F,
+		0x0001020304050607, 0x08090A0B0C0D0E0F));
+}
+
+template <bool Reflected>
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_loadu(unsigned char const* p) noexcept
+{
+	return vpclmul_order<Reflected>(_mm512_loadu_si512(p));
+}
+
+// Copies a 128-bit value into every lane.
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_broadcast(std::uint64_t const (&k)[2]) noexcept
+{
+	return _mm512_set_epi64(static_cast<long long>(k[1]),
+		static_cast<long long>(k[0]), static_cast<long long>(k[1]),
+		static_cast<long long>(k[0]), static_cast<long long>(k[1]),
+		static_cast<long long>(k[0]), static_cast<long long>(k[1]),
+		static_cast<long long>(k[0]));
+}
+
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_fold(__m512i x, __m512i k, __m512i data) noexcept
+{
+	// 0x96 is a three-way exclusive or.
+	return _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(x, k, 0x00),
+		_mm512_clmulepi64_epi128(x, k, 0x11), data, 0x96);
+}
+
+// Calculates a 64-bit raw CRC with 512-bit folding.
+// `length` must be a multiple of 16, and at least 256.
+template <bool Reflected>
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_update(std::uint64_t crc, unsigned char const* p,
+	std::size_t length, clmul_constants const& k) noexcept -> std::uint64_t
+{
+	using reflected = std::integral_constant<bool, Reflected>;
+	
+	auto const k128 = clmul_load(k.fold128);
+	auto const k512 = vpclmul_broadcast(k.fold512);
+	auto const k2048 = vpclmul_broadcast(k.fold2048);
+	
+	auto x0 = _mm512_xor_si512(vpclmul_loadu<Reflected>(p),
+		_mm512_inserti32x4(_mm512_setzero_si512(),
+			clmul_initial(crc, reflected{}), 0));
+	auto x1 = vpclmul_loadu<Reflected>(p + 64);
+	auto x2 = vpclmul_loadu<Reflected>(p + 128);
+	auto x3 = vpclmul_loadu<Reflected>(p + 192);
+	p += 256;
+	length -= 256;
+	
+	// Four independent accumulators of four lanes each.
+	while (length >= 256u)
+	{
+		x0 = vpclmul_fold(x0, k2048, vpclmul_loadu<Reflected>(p));
+		x1 = vpclmul_fold(x1, k2048, vpclmul_loadu<Reflected>(p + 64));
+		x2 = vpclmul_fold(x2, k2048, vpclmul_loadu<Reflected>(p + 128));
+		x3 = vpclmul_fold(x3, k2048, vpclmul_loadu<Reflected>(p + 192));
+		p += 256;
+		length -= 256;
+	}
+	
+	x0 = vpclmul_fold(x0, k512, x1);
+	x0 = vpclmul_fold(x0, k512, x2);
+	x0 = vpclmul_fold(x0, k512, x3);
+	
+	while (length >= 64u)
+	{
+		x0 = vpclmul_fold(x0, k512, vpclmul_loadu<Reflected>(p));
+		p += 64;
+		length -= 64;
+	}
+	
+	// Down to a single 128-bit lane. (Going through memory avoids the
+	// lane extraction intrinsics, which make some versions of GCC warn
+	// about uninitialized values.)
+	__m128i lanes[4];
+	_mm512_storeu_si512(lanes, x0);
+	auto x = lanes[0];
+	x = _mm_xor_si128(clmul_fold(x, k128), lanes[1]);
+	x = _mm_xor_si128(clmul_fold(x, k128), lanes[2]);
+	x = _mm_xor_si128(clmul_fold(x, k128), lanes[3]);
+	
+	while (length >= 16u)
+	{
+		x = _mm_xor_si128(clmul_fold(x, k128), clmul_loadu<Reflected>(p));
+		p += 16;
+		length -= 16;
+	}
+	
+	return clmul_reduce(x, k, reflected{});
+}
+
+// The number of messages `vpclmul_update_batch` works on at once, each
+// in its own accumulator.
+constexpr auto vpclmul_batch_lanes = std::size_t{8u};
+
+// Below this many bytes, a message is done as quickly on its own with
+// the 128-bit kernel, which doesn't wait for seven others.
+constexpr auto vpclmul_batch_min_length = std::size_t{1024u};
+
+// Folds block number `block` of a message of `blocks` 64-byte blocks
+// into `x`, or, past the end of the message, leaves `x` as it is (and
+// loads the first block again, which is always there).
+template <bool Reflected>
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_masked_fold(__m512i x, __m512i k, unsigned char const* p,
+	std::size_t block, std::size_t blocks) noexcept
+{
+	auto const active = block < blocks;
+	auto const mask = static_cast<__mmask8>(active ? 0xFFu : 0x00u);
+	auto const data = vpclmul_loadu<Reflected>(p + (active ? 64u * block : 0u));
+	return _mm512_mask_mov_epi64(x, mask, vpclmul_fold(x, k, data));
+}
+
+// Calculates the 64-bit raw CRCs of up to `vpclmul_batch_lanes`
+// messages with 512-bit folding, one message to an accumulator, so
+// the multiplications for different messages overlap. All the
+// messages step along together until the longest one runs out; a
+// message that runs out sooner is masked, so its accumulator stays
+// put and its loads go back to its first block. The CRCs are the same
+// as `vpclmul_update` gives.
+// Every length must be a multiple of 16, and at least 64.
+template <bool Reflected>
+INDI_CRC_TARGET_VPCLMUL
+inline auto vpclmul_update_batch(std::uint64_t crc,
+	unsigned char const* const* messages, std::size_t const* lengths,
+	std::size_t count, std::uint64_t* crcs, clmul_constants const& k)
+	noexcept -> void
+{
+	using reflected = std::integral_constant<bool, Reflected>;
+	constexpr auto lanes = vpclmul_batch_lanes;
+	
+	static unsigned char const zeros[64] = {};
+	
+	auto const k128 = clmul_load(k.fold128);
+	auto const k512 = vpclmul_broadcast(k.fold512);
+	auto const initial = _mm512_inserti32x4(_mm512_setzero_si512(),
+		clmul_initial(crc, reflected{}), 0);
+	
+	// Unused lanes fold the same block of zeros.
+	unsigned char const* p[lanes];
+	std::size_t blocks[lanes];
+	auto steps = std::size_t{0};
+	for (auto lane = std::size_t{0}; lane < lanes; ++lane)
+	{
+		p[lane] = lane < count ? messages[lane] : zeros;
+		blocks[lane] = lane < count ? lengths[lane] / 64u : 1u;
+		steps = blocks[lane] > steps ? blocks[lane] : steps;
+	}
+	
+	__m512i x[lanes];
+	for (auto lane = std::size_t{0}; lane < lanes; ++lane)
+		x[lane] = _mm512_xor_si512(vpclmul_loadu<Reflected>(p[lane]),
+			initial);
+	
+	for (auto block = std::size_t{1}; block < steps; ++block)
+	{
+		// Written out, so the accumulators stay in registers.
+		x[0] = vpclmul_masked_fold<Reflected>(x[0], k512, p[0],
+			block, blocks[0]);
+		x[1] = vpclmul_masked_fold<Reflected>(x[1], k512, p[1],
+			block, blocks[1]);
+		x[2] = vpclmul_masked_fold<Reflected>(x[2], k512, p[2],
+			block, blocks[2]);
+		x[3] = vpclmul_masked_fold<Reflected>(x[3], k512, p[3],
+			block, blocks[3]);
+		x[4] = vpclmul_masked_fold<Reflected>(x[4], k512, p[4],
+			block, blocks[4]);
+		x[5] = vpclmul_masked_fold<Reflected>(x[5], k512, p[5],
+			block, blocks[5]);
+		x[6] = vpclmul_masked_fold<Reflected>(x[6], k512, p[6],
+			block, blocks[6]);
+		x[7] = vpclmul_masked_fold<Reflected>(x[7], k512, p[7],
+			block, blocks[7]);
+	}
+	
+	// The rest of each message, as in `vpclmul_update`.
+	for (auto lane = std::size_t{0}; lane < count; ++lane)
+	{
+		__m128i parts[4];
+		_mm512_storeu_si512(parts, x[lane]);
+		auto y = parts[0];
+		y = _mm_xor_si128(clmul_fold(y, k128), parts[1]);
+		y = _mm_xor_si128(clmul_fold(y, k128), parts[2]);
+		y = _mm_xor_si128(clmul_fold(y, k128), parts[3]);
+		
+		auto q = p[lane] + 64u * blocks[lane];
+		for (auto left = lengths[lane] % 64u; left != 0u; left -= 16u)
+		{
+			y = _mm_xor_si128(clmul_fold(y, k128), clmul_loadu<Reflected>(q));
+			q += 16;
+		}
+		
+		crcs[lane] = clmul_reduce(y, k, reflected{});
+	}
+}
+
+#undef INDI_CRC_TARGET_VPCLMUL
+
+#endif // INDI_CRC_HAVE_VPCLMUL
+
+#if INDI_CRC_HAVE_PCLMUL
+
+// Moves CRCs in and out of planes, a byte of each CRC in each plane
+// (see `shuffle_constants`).
+template <std::size_t Planes, bool Reflected, std::size_t Lanes>
+inline auto shuffle_split(std::uint32_t const* crcs,
+	unsigned char (&planes)[4][Lanes]) noexcept
+{
+	for (auto plane = std::size_t{0}; plane < Planes; ++plane)
+	{
+		auto const shift = 8u * (Reflected ? plane : Planes - 1u - plane);
+		for (auto lane = std::size_t{0}; lane < Lanes; ++lane)
+			planes[plane][lane] = static_cast<unsigned char>(
+				crcs[lane] >> shift);
+	}
+}
+
+template <std::size_t Planes, bool Reflected, std::size_t Lanes>
+inline auto shuffle_join(unsigned char const (&planes)[4][Lanes],
+	std::uint32_t* crcs) noexcept
+{
+	for (auto lane = std::size_t{0}; lane < Lanes; ++lane)
+	{
+		auto crc = std::uint32_t{0};
+		for (auto plane = std::size_t{0}; plane < Planes; ++plane)
+			crc |= std::uint32_t{planes[plane][lane]} <<
+				(8u * (Reflected ? plane : Planes - 1u - plane));
+		crcs[lane] = crc;
+	}
+}
+
+#define INDI_CRC_TARGET_PSHUFB __attribute__((target("ssse3")))
+
+// One round of a 16 x 16 byte matrix transpose: interleaves rows n and
+// n + 8, which rotates the 8-bit (row, column) index of every byte left
+// by one. Four rounds swap the rows and columns.
+INDI_CRC_TARGET_PSHUFB
+inline auto pshufb_interleave(__m128i const (&v)[16], __m128i (&t)[16])
+	noexcept
+{
+	t[0] = _mm_unpacklo_epi8(v[0], v[8]);
+	t[1] = _mm_unpackhi_epi8(v[0], v[8]);
+	t[2] = _mm_unpacklo_epi8(v[1], v[9]);
+	t[3] = _mm_unpackhi_epi8(v[1], v[9]);
+	t[4] = _mm_unpacklo_epi8(v[2], v[10]);
+	t[5] = _mm_unpackhi_epi8(v[2], v[10]);
+	t[6] = _mm_unpacklo_epi8(v[3], v[11]);
+	t[7] = _mm_unpackhi_epi8(v[3], v[11]);
+	t[8] = _mm_unpacklo_epi8(v[4], v[12]);
+	t[9] = _mm_unpackhi_epi8(v[4], v[12]);
+	t[10] = _mm_unpacklo_epi8(v[5], v[13]);
+	t[11] = _mm_unpackhi_epi8(v[5], v[13]);
+	t[12] = _mm_unpacklo_epi8(v[6], v[14]);
+	t[13] = _mm_unpackhi_epi8(v[6], v[14]);
+	t[14] = _mm_unpacklo_epi8(v[7], v[15]);
+	t[15] = _mm_unpackhi_epi8(v[7], v[15]);
+}
+
+INDI_CRC_TARGET_PSHUFB
+inline auto pshufb_lookup(__m128i low, __m128i high, __m128i low_index,
+	__m128i high_index) noexcept
+{
+	return _mm_xor_si128(_mm_shuffle_epi8(low, low_index),
+		_mm_shuffle_epi8(high, high_index));
+}
+
+// Adds a byte to each of the 16 CRCs. The planes are written out rather
+// than looped over, so that they stay in registers; the unused ones stay
+// zero.
+template <std::size_t Planes>
+INDI_CRC_TARGET_PSHUFB
+inline auto pshufb_step(__m128i (&state)[4], __m128i data,
+	__m128i const (&low)[4], __m128i const (&high)[4]) noexcept
+{
+	auto const nibble = _mm_set1_epi8(0x0F);
+	auto const index = _mm_xor_si128(state[0], data);
+	auto const l = _mm_and_si128(index, nibble);
+	auto const h = _mm_and_si128(_mm_srli_epi16(index, 4), nibble);
+	
+	state[0] = _mm_xor_si128(state[1], pshufb_lookup(low[0], high[0], l, h));
+	if (Planes > 1u)
+		state[1] = _mm_xor_si128(state[2],
+			pshufb_lookup(low[1], high[1], l, h));
+	if (Planes > 2u)
+		state[2] = _mm_xor_si128(state[3],
+			pshufb_lookup(low[2], high[2], l, h));
+	if (Planes > 3u)
+		state[3] = pshufb_lookup(low[3], high[3], l, h);
+}
+
+// Calculates the CRCs of 16 parts of the input, `length` bytes each (a
+// multiple of 64), one after the other, starting from (and writing
+// back to) `crcs`.
+template <std::size_t Planes, bool Reflected>
+INDI_CRC_TARGET_PSHUFB
+inline auto pshufb_update(std::uint32_t* crcs, unsigned char const* p,
+	std::size_t length, shuffle_constants const& k) noexcept
+{
+	unsigned char planes[4][16] = {};
+	shuffle_split<Planes, Reflected>(crcs, planes);
+	
+	__m128i low[4];
+	__m128i high[4];
+	__m128i state[4];
+	for (auto plane = std::size_t{0}; plane < 4u; ++plane)
+	{
+		low[plane] = _mm_loadu_si128(
+			reinterpret_cast<__m128i const*>(k.low[plane]));
+		high[plane] = _mm_loadu_si128(
+			reinterpret_cast<__m128i const*>(k.high[plane]));
+		state[plane] = _mm_loadu_si128(
+			reinterpret_cast<__m128i const*>(planes[plane]));
+	}
+	
+	for (auto offset = std::size_t{0}; offset < length; offset += 64u)
+	{
+		// Row n of block b is bytes 16 * b to 16 * b + 15 of the next
+		// 64 of part n; after transposing, row n is byte n of every
+		// part. Reading a whole cache line of each part at once keeps
+		// parts that are a multiple of 4 KiB apart, and so compete for
+		// the same few cache sets, from evicting each other.
+		__m128i v[4][16];
+		__m128i t[16];
+		for (auto n = std::size_t{0}; n < 16u; ++n)
+			for (auto b = std::size_t{0}; b < 4u; ++b)
+				v[b][n] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(
+					p + n * length + offset + 16u * b));
+		
+		for (auto b = std::size_t{0}; b < 4u; ++b)
+		{
+			pshufb_interleave(v[b], t);
+			pshufb_interleave(t, v[b]);
+			pshufb_interleave(v[b], t);
+			pshufb_interleave(t, v[b]);
+			
+			for (auto n = 0; n < 16; ++n)
+				pshufb_step<Planes>(state, v[b][n], low, high);
+		}
+	}
+	
+	for (auto plane = std::size_t{0}; plane < 4u; ++plane)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[plane]),
+			state[plane]);
+	shuffle_join<Planes, Reflected>(planes, crcs);
+}
+
+#undef INDI_CRC_TARGET_PSHUFB
+
+#define INDI_CRC_TARGET_VPSHUFB __attribute__((target("avx2")))
+
+// Like `pshufb_interleave`, for two matrices at once, one in each
+// 128-bit lane.
+INDI_CRC_TARGET_VPSHUFB
+inline auto vpshufb_interleave(__m256i const (&v)[16], __m256i (&t)[16])
+	noexcept
+{
+	t[0] = _mm256_unpacklo_epi8(v[0], v[8]);
+	t[1] = _mm256_unpackhi_epi8(v[0], v[8]);
+	t[2] = _mm256_unpacklo_epi8(v[1], v[9]);
+	t[3] = _mm256_unpackhi_epi8(v[1], v[9]);
+	t[4] = _mm256_unpacklo_epi8(v[2], v[10]);
+	t[5] = _mm256_unpackhi_epi8(v[2], v[10]);
+	t[6] = _mm256_unpacklo_epi8(v[3], v[11]);
+	t[7] = _mm256_unpackhi_epi8(v[3], v[11]);
+	t[8] = _mm256_unpacklo_epi8(v[4], v[12]);
+	t[9] = _mm256_unpackhi_epi8(v[4], v[12]);
+	t[10] = _mm256_unpacklo_epi8(v[5], v[13]);
+	t[11] = _mm256_unpackhi_epi8(v[5], v[13]);
+	t[12] = _mm256_unpacklo_epi8(v[6], v[14]);
+	t[13] = _mm256_unpackhi_epi8(v[6], v[14]);
+	t[14] = _mm256_unpacklo_epi8(v[7], v[15]);
+	t[15] = _mm256_unpackhi_epi8(v[7], v[15]);
+}
+
+INDI_CRC_TARGET_VPSHUFB
+inline auto vpshufb_lookup(__m256i low, __m256i high, __m256i low_index,
+	__m256i high_index) noexcept
+{
+	return _mm256_xor_si256(_mm256_shuffle_epi8(low, low_index),
+		_mm256_shuffle_epi8(high, high_index));
+}
+
+// Adds a byte to each of the 32 CRCs (see `pshufb_step`).
+template <std::size_t Planes>
+INDI_CRC_TARGET_VPSHUFB
+inline auto vpshufb_step(__m256i (&state)[4], __m256i data,
+	__m256i const (&low)[4], __m256i const (&high)[4]) noexcept
+{
+	auto const nibble = _mm256_set1_epi8(0x0F);
+	auto const index = _mm256_xor_si256(state[0], data);
+	auto const l = _mm256_and_si256(index, nibble);
+	auto const h = _mm256_and_si256(_mm256_srli_epi16(index, 4), nibble);
+	
+	state[0] = _mm256_xor_si256(state[1],
+		vpshufb_lookup(low[0], high[0], l, h));
+	if (Planes > 1u)
+		state[1] = _mm256_xor_si256(state[2],
+			vpshufb_lookup(low[1], high[1], l, h));
+	if (Planes > 2u)
+		state[2] = _mm256_xor_si256(state[3],
+			vpshufb_lookup(low[2], high[2], l, h));
+	if (Planes > 3u)
+		state[3] = vpshufb_lookup(low[3], high[3], l, h);
+}
+
+// Copies a 16-byte table into both 128-bit lanes.
+INDI_CRC_TARGET_VPSHUFB
+inline auto vpshufb_broadcast(unsigned char const (&table)[16]) noexcept
+{
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128(
+		reinterpret_cast<__m128i const*>(table)));
+}
+
+// Like `pshufb_update`, but for 32 parts. Row n holds parts n and
+// n + 16, one in each 128-bit lane, and the byte shuffles work within
+// lanes, so the same transpose works on both halves at once.
+template <std::size_t Planes, bool Reflected>
+INDI_CRC_TARGET_VPSHUFB
+inline auto vpshufb_update(std::uint32_t* crcs, unsigned char const* p,
+	std::size_t length, shuffle_constants const& k) noexcept
+{
+	unsigned char planes[4][32] = {};
+	shuffle_split<Planes, Reflected>(crcs, planes);
+	
+	__m256i low[4];
+	__m256i high[4];
+	__m256i state[4];
+	for (auto plane = std::size_t{0}; plane < 4u; ++plane)
+	{
+		low[plane] = vpshufb_broadcast(k.low[plane]);
+		high[plane] = vpshufb_broadcast(k.high[plane]);
+		state[plane] = _mm256_loadu_si256(
+			reinterpret_cast<__m256i const*>(planes[plane]));
+	}
+	
+	for (auto offset = std::size_t{0}; offset < length; offset += 64u)
+	{
+		__m256i v[4][16];
+		__m256i t[16];
+		for (auto n = std::size_t{0}; n < 16u; ++n)
+			for (auto b = std::size_t{0}; b < 4u; ++b)
+				v[b][n] = _mm256_inserti128_si256(_mm256_castsi128_si256(
+					_mm_loadu_si128(reinterpret_cast<__m128i const*>(
+						p + n * length + offset + 16u * b))),
+					_mm_loadu_si128(reinterpret_cast<__m128i const*>(
+						p + (n + 16u) * length + offset + 16u * b)), 1);
+		
+		for (auto b = std::size_t{0}; b < 4u; ++b)
+		{
+			vpshufb_interleave(v[b], t);
+			vpshufb_interleave(t, v[b]);
+			vpshufb_interleave(v[b], t);
+			vpshufb_interleave(t, v[b]);
+			
+			for (auto n = 0; n < 16; ++n)
+				vpshufb_step<Planes>(state, v[b][n], low, high);
+		}
+	}
+	
+	for (auto plane = std::size_t{0}; plane < 4u; ++plane)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes[plane]),
+			state[plane]);
+	shuffle_join<Planes, Reflected>(planes, crcs);
+}
+
+#undef INDI_CRC_TARGET_VPSHUFB
+
+#endif // INDI_CRC_HAVE_PCLMUL
+
+// Picks the best supported kernel no faster than the one asked for.
+// The shuffle kernels come after the folding ones, and are skipped for
+// CRCs that aren't `narrow` enough for them.
+inline auto resolve_kernel(clmul_kernel kernel, bool narrow) noexcept
+{
+	auto const& features = cpu();
+	
+	if (kernel == clmul_kernel::automatic)
+		kernel = clmul_kernel::vpclmul;
+	
+	if (kernel == clmul_kernel::vpclmul &&
+			!(INDI_CRC_HAVE_VPCLMUL && features.vpclmul))
+		kernel = clmul_kernel::pclmul;
+	
+	if (kernel == clmul_kernel::pclmul &&
+			!(INDI_CRC_HAVE_PCLMUL && features.pclmul))
+		kernel = clmul_kernel::vpshufb;
+	
+	// The 16-part shuffle kernel is no faster than the braided tables,
+	// so it is skipped unless asked for.
+	if (kernel == clmul_kernel::vpshufb &&
+			!(INDI_CRC_HAVE_PCLMUL && narrow && features.avx2))
+		kernel = clmul_kernel::table;
+	
+	if (kernel == clmul_kernel::pshufb &&
+			!(INDI_CRC_HAVE_PCLMUL && narrow && features.ssse3))
+		kernel = clmul_kernel::table;
+	
+	return kernel;
+}
+
+} // namespace detail_
+
+//! A CRC engine using carry-less multiplication.
+//! 
+//! This calculates CRCs of any width up to 64 bits, for any polynomial,
+//! by folding 128 bits at a time with the PCLMULQDQ instruction, or 512
+//! bits at a time with AVX-512 VPCLMULQDQ, which is several times
+//! faster than a lookup table. The kernel is picked when the engine is
+//! created, from what the CPU supports; on CPUs (or compilers) without
+//! either, the engine falls back to braided table lookups (see
+//! `braided_engine`), so it can be used unconditionally.
+//! 
+//! Some virtual machines hide PCLMULQDQ but not AVX2. For CRCs of up to
+//! 32 bits, the engine then splits large inputs into 32 parts, and
+//! works through them all at once a byte at a time, with the lookup
+//! table split into 16-element pieces held in vector registers and
+//! looked up with VPSHUFB. The CRCs of the parts are then combined.
+//! This is up to twice as fast as the braided tables, though much
+//! slower than folding. (With SSSE3 PSHUFB, 16 parts at a time are no
+//! faster than the braided tables, so that kernel is only used when
+//! asked for.)
+//! 
+//! Inputs shorter than 64 bytes (8192 bytes for the shuffle kernels),
+//! and what's left over at the end of longer ones, always use the
+//! braided tables. Because 512-bit instructions can make the CPU lower
+//! its clock speed for a while, the 512-bit kernel is only used for
+//! inputs of at least `wide_threshold` bytes, and shorter ones use the
+//! 128-bit kernel.
+//! 
+//! Use the `clmul_engine` (reflected) and `normal_clmul_engine`
+//! (non-reflected) aliases. Like a lookup table, a reflected engine
+//! can be passed to `calculate` and `calculate_raw`:
+//! 
+//!     auto const engine = indi::crc::clmul_engine<32>{
+//!         indi::crc::polynomials::crc32c};
+//!     auto const crc = indi::crc::calculate<32>(data, engine);
+//! 
+//! and a non-reflected one to `calculate_normal_raw`:
+//! 
+//!     auto const mpeg2 = indi::crc::normal_clmul_engine<32>{
+//!         indi::crc::polynomials::crc32};
+//!     auto const crc = indi::crc::calculate_normal_raw<32>(
+//!         std::uint_fast32_t{0xFFFFFFFFu}, data, mpeg2);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+template <std::size_t Bits, typename T, bool Reflected>
+class basic_clmul_engine
+{
+	static_assert(Bits > 0u && Bits <= 64u,
+		"carry-less multiplication supports 1 to 64-bit CRCs");
+
+public:
+	using crc_engine_tag = void;
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto reflected = Reflected;
+	
+	using fallback_type = basic_braided_engine<Bits, T, Reflected>;
+	
+	//! The tables and constants an engine works out from its polynomial.
+	struct constants
+	{
+		fallback_type fallback;
+		detail_::clmul_constants clmul;
+		detail_::shuffle_constants shuffle;
+	};
+	
+	//! Works out the tables and constants for a polynomial.
+	//! 
+	//! Engines can be created from the result without working anything
+	//! out again (see the second constructor). From C++17, when
+	//! `std::array` can be filled in at compile time, this can be done
+	//! at compile time too.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	static constexpr auto make_constants(T polynomial) noexcept -> constants
+	{
+		return constants{
+			fallback_type{polynomial},
+			Reflected ?
+				detail_::make_clmul_constants<Bits>(polynomial) :
+				detail_::make_normal_clmul_constants<Bits>(polynomial),
+			detail_::make_shuffle_constants_for<Bits, Reflected>(
+				polynomial, narrow{})};
+	}
+	
+	//! Creates an engine.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	//! \param kernel  The kernel to use. If the CPU doesn't support it,
+	//!     the next best one is used instead.
+	//! \param wide_threshold  The input size in bytes from which the
+	//!     512-bit kernel is used (at least 256). `calculate_multi`,
+	//!     `copy_and_calculate`, and `calculate_stripe` give the engine
+	//!     at most 4096 bytes at a time, so with a larger threshold
+	//!     they never use it.
+	explicit basic_clmul_engine(T polynomial,
+			clmul_kernel kernel = clmul_kernel::automatic,
+			std::size_t wide_threshold =
+				detail_::vpclmul_default_threshold) noexcept :
+		basic_clmul_engine(make_constants(polynomial), kernel,
+			wide_threshold)
+	{}
+	
+	//! Creates an engine from tables and constants worked out
+	//! beforehand, so only the kernel is picked at run time. For
+	//! example, with C++17:
+	//! 
+	//!     static constexpr auto k = indi::crc::clmul_engine<32>::
+	//!         make_constants(indi::crc::polynomials::crc32c);
+	//!     auto const engine = indi::crc::clmul_engine<32>{k};
+	//! 
+	//! \param k  The result of `make_constants`.
+	//! \param kernel  As for the first constructor.
+	//! \param wide_threshold  As for the first constructor.
+	explicit basic_clmul_engine(constants const& k,
+			clmul_kernel kernel = clmul_kernel::automatic,
+			std::size_t wide_threshold =
+				detail_::vpclmul_default_threshold) noexcept :
+		fallback_(k.fallback),
+		constants_(k.clmul),
+		shuffle_(k.shuffle),
+		kernel_(detail_::resolve_kernel(kernel, narrow::value)),
+		wide_threshold_(wide_threshold < detail_::vpclmul_min_length ?
+			detail_::vpclmul_min_length : wide_threshold)
+	{}
+	
+	//! Calculates the raw CRC of a sequence of bytes.
+	//! 
+	//! \param crc  The raw CRC of the preceding sequence (or the
+	//!     initial value).
+	//! \param first  The start of the sequence.
+	//! \param last  The end of the sequence.
+	//! 
+	//! \returns The raw CRC.
+	auto update(T crc, unsigned char const* first,
+		unsigned char const* last) const noexcept -> T
+	{
+		auto const length = static_cast<std::size_t>(last - first);
+		
+		if (kernel_ == clmul_kernel::pshufb ||
+			kernel_ == clmul_kernel::vpshufb)
+		{
+			if (length >= shuffle_min_length())
+				crc = shuffle(crc, first, length, narrow{});
+		}
+		else if (kernel_ != clmul_kernel::table &&
+				length >= detail_::clmul_min_length)
+		{
+			auto const bulk = length & ~std::size_t{15u};
+			
+			// The kernels work on 64-bit CRCs (see
+			// `detail_::clmul_polynomial`). A non-reflected CRC
+			// sits at the top of one.
+			auto c = static_cast<std::uint64_t>(crc) << shift;
+			
+#if INDI_CRC_HAVE_VPCLMUL
+			if (kernel_ == clmul_kernel::vpclmul && bulk >= wide_threshold_)
+				c = detail_::vpclmul_update<Reflected>(c, first, bulk,
+					constants_);
+			else
+#endif
+#if INDI_CRC_HAVE_PCLMUL
+				c = detail_::clmul_update<Reflected>(c, first, bulk,
+					constants_);
+#endif
+			
+			crc = static_cast<T>(c >> shift);
+			first += bulk;
+		}
+		
+		return fallback_.update(crc, first, last);
+	}
+	
+	//! Calculates the raw CRCs of several messages.
+	//! 
+	//! With the 512-bit kernel, messages of at least 1 KiB (and
+	//! shorter than `wide_threshold`) are worked on eight at a time,
+	//! each in its own accumulator, so the multiplications for one
+	//! message fill the gaps while the others wait for theirs. They
+	//! are grouped by length, so few lanes sit idle waiting for the
+	//! longest. Every other message goes to `update`: shorter ones
+	//! gain nothing from the wait, and out-of-order CPUs already
+	//! overlap the work on consecutive messages with the other
+	//! kernels. The CRCs are the same as `update` gives for each
+	//! message.
+	//! 
+	//! \param crc  The raw CRC of the sequence preceding every message
+	//!     (or the initial value).
+	//! \param messages  Pointers to the first byte of each message.
+	//! \param lengths  The length of each message, in bytes.
+	//! \param count  The number of messages.
+	//! \param crcs  Where to write the raw CRC of each message.
+	auto update_batch(T crc, unsigned char const* const* messages,
+		std::size_t const* lengths, std::size_t count, T* crcs) const
+		noexcept -> void
+	{
+#if INDI_CRC_HAVE_VPCLMUL
+		if (kernel_ == clmul_kernel::vpclmul)
+		{
+			constexpr auto lanes = detail_::vpclmul_batch_lanes;
+			constexpr auto chunk = std::size_t{128u};
+			std::size_t indices[chunk];
+			
+			auto n = std::size_t{0};
+			while (n < count)
+			{
+				auto size = std::size_t{0};
+				for (; n < count && size < chunk; ++n)
+				{
+					if (lengths[n] < detail_::vpclmul_batch_min_length ||
+						lengths[n] >= wide_threshold_)
+						crcs[n] = update(crc, messages[n],
+							messages[n] + lengths[n]);
+					else
+						indices[size++] = n;
+				}
+				
+				std::sort(indices, indices + size,
+					[lengths](std::size_t a, std::size_t b)
+					{
+						return lengths[a] < lengths[b];
+					});
+				
+				for (auto m = std::size_t{0}; m < size; m += lanes)
+					update_lanes(crc, messages, lengths, indices + m,
+						size - m < lanes ? size - m : lanes, crcs);
+			}
+			
+			return;
+		}
+#endif
+		
+		for (auto n = std::size_t{0}; n < count; ++n)
+			crcs[n] = update(crc, messages[n], messages[n] + lengths[n]);
+	}
+	
+	//! Gets the braided table engine, used for short inputs and tails.
+	auto fallback() const noexcept -> fallback_type const&
+	{
+		return fallback_;
+	}
+	
+	//! Gets the kernel used for large inputs.
+	auto kernel() const noexcept { return kernel_; }
+
+private:
+	using narrow = std::integral_constant<bool, (Bits <= 32u)>;
+	
+	static constexpr auto shift = Reflected ? 0u : unsigned(64u - Bits);
+
+#if INDI_CRC_HAVE_VPCLMUL
+	// Runs the 512-bit batch kernel over up to eight messages, picked
+	// by `indices`, finishing each one's last few bytes with the
+	// fallback.
+	auto update_lanes(T crc, unsigned char const* const* messages,
+		std::size_t const* lengths, std::size_t const* indices,
+		std::size_t count, T* crcs) const noexcept -> void
+	{
+		constexpr auto lanes = detail_::vpclmul_batch_lanes;
+		unsigned char const* firsts[lanes];
+		std::size_t bulks[lanes];
+		std::uint64_t results[lanes];
+		
+		for (auto lane = std::size_t{0}; lane < count; ++lane)
+		{
+			firsts[lane] = messages[indices[lane]];
+			bulks[lane] = lengths[indices[lane]] & ~std::size_t{15u};
+		}
+		
+		detail_::vpclmul_update_batch<Reflected>(
+			static_cast<std::uint64_t>(crc) << shift, firsts, bulks, count,
+			results, constants_);
+		
+		for (auto lane = std::size_t{0}; lane < count; ++lane)
+		{
+			auto const index = indices[lane];
+			crcs[index] = fallback_.update(T(results[lane] >> shift),
+				firsts[lane] + bulks[lane], firsts[lane] + lengths[index]);
+		}
+	}
+#endif
+	
+	// Runs a shuffle kernel over as much of the input as it can take,
+	// moving `first` past it.
+	auto shuffle(T crc, unsigned char const*& first, std::size_t length,
+		std::true_type /* narrow */) const noexcept -> T
+	{
+#if INDI_CRC_HAVE_PCLMUL
+		constexpr auto planes = detail_::shuffle_planes<Bits>;
+		constexpr auto widen = Reflected ? 0u :
+			unsigned(8u * planes - Bits);
+		
+		auto const parts = kernel_ == clmul_kernel::vpshufb ? 32u : 16u;
+		
+		while (length >= shuffle_min_length())
+		{
+			// Combining is quicker for part lengths with fewer bits
+			// set, so keep only the top two, and go round again for
+			// what's left.
+			auto part_length = (length / parts) & ~std::size_t{63u};
+			auto const top = detail_::top_bit(part_length);
+			part_length = top | detail_::top_bit(part_length ^ top);
+			
+			// The first part carries on from `crc`; the others start
+			// from 0, so they can be combined with it.
+			std::uint32_t crcs[32] = {};
+			crcs[0] = std::uint32_t(std::uint32_t(crc) << widen);
+			
+			if (kernel_ == clmul_kernel::vpshufb)
+				detail_::vpshufb_update<planes, Reflected>(crcs, first,
+					part_length, shuffle_);
+			else
+				detail_::pshufb_update<planes, Reflected>(crcs, first,
+					part_length, shuffle_);
+			
+			crc = T(detail_::shuffle_combine<Bits, Reflected>(crcs, parts,
+				part_length, shuffle_));
+			first += parts * part_length;
+			length -= parts * part_length;
+		}
+		
+		return crc;
+#else
+		return (void)first, (void)length, crc;
+#endif
+	}
+	
+	auto shuffle(T crc, unsigned char const*& /* first */,
+		std::size_t /* length */, std::false_type /* narrow */) const
+		noexcept -> T
+	{
+		return crc;
+	}
+	
+	auto shuffle_min_length() const noexcept
+	{
+		return kernel_ == clmul_kernel::vpshufb ?
+			detail_::vpshufb_min_length : detail_::pshufb_min_length;
+	}
+	
+	fallback_type fallback_;
+	detail_::clmul_constants constants_;
+	detail_::shuffle_constants shuffle_;
+	clmul_kernel kernel_;
+	std::size_t wide_threshold_;
+};
+
+//! A reflected CRC engine using carry-less multiplication.
+//! 
+//! \see basic_clmul_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using clmul_engine = basic_clmul_engine<Bits, T, true>;
+
+//! A non-reflected (MSB-first) CRC engine using carry-less
+//! multiplication.
+//! 
+//! \see basic_clmul_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using normal_clmul_engine = basic_clmul_engine<Bits, T, false>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,200 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_SLOT_
+#define INDI_INC_CRC_SLOT_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+
+// Redis cluster key slots.
+//
+// Redis cluster spreads keys over 16384 slots by the CRC-16/XMODEM
+// (non-reflected CRC-16/CCITT, starting from 0, with no final xor) of
+// the key, modulo 16384. If the key has a "hash tag", a non-empty part
+// between the first '{' and the first '}' after it, only that part is
+// hashed, so related keys can be kept in the same slot.
+
+namespace indi {
+namespace crc {
+
+//! The number of Redis cluster slots.
+constexpr auto key_slot_count = std::size_t{16384u};
+
+namespace detail_ {
+
+// The CRC-16/XMODEM lookup table, generated at compile time, as
+// `generate_normal_table` does, but in a plain array (see `fixed_table`
+// in `indi/crc-fixed.hpp`) of 16-bit entries, 512 bytes in all.
+struct slot_table_values
+{
+	std::uint_least16_t values[256];
+};
+
+constexpr auto make_slot_table() noexcept
+{
+	auto table = slot_table_values{};
+	for (auto n = std::size_t{0}; n < 256u; ++n)
+		table.values[n] = static_cast<std::uint_least16_t>(
+			normal_table_entry<16>(polynomials::crc16_ccitt, n));
+	
+	return table;
+}
+
+template <typename = void>
+struct slot_table
+{
+	static constexpr slot_table_values value = make_slot_table();
+};
+
+template <typename T>
+constexpr slot_table_values slot_table<T>::value;
+
+// The bits shifted above the CRC's 16 are never looked at again, and
+// the slot drops them, so they needn't be cleared at every step.
+inline auto slot_step(unsigned crc, unsigned char b) noexcept
+{
+	return (crc << 8) ^ slot_table<>::value.values[((crc >> 8) ^ b) &
+		0xFFu];
+}
+
+inline auto slot_update(unsigned crc, unsigned char const* first,
+	unsigned char const* last) noexcept
+{
+	for (; first != last; ++first)
+		crc = slot_step(crc, *first);
+	return crc;
+}
+
+// Narrows a key to its hash tag, if it has one.
+inline auto hash_tag(unsigned char const*& first,
+	unsigned char const*& last) noexcept -> void
+{
+	auto const length = static_cast<std::size_t>(last - first);
+	auto const open = static_cast<unsigned char const*>(
+		std::memchr(first, '{', length));
+	if (!open)
+		return;
+	
+	auto const close = static_cast<unsigned char const*>(
+		std::memchr(open + 1, '}', static_cast<std::size_t>(last - open -
+			1)));
+	if (!close || close == open + 1)
+		return;
+	
+	first = open + 1;
+	last = close;
+}
+
+} // namespace detail_
+
+//! Calculates the Redis cluster slot of a key.
+//! 
+//! This matches `HASH_SLOT` in Redis: the CRC-16/XMODEM of the key, or
+//! of its hash tag if it has one, modulo 16384.
+//! 
+//! \param key  The first byte of the key.
+//! \param length  The length of the key, in bytes.
+//! 
+//! \returns The slot, from 0 to 16383.
+inline auto key_slot(char const* key, std::size_t length) noexcept
+	-> std::uint_fast16_t
+{
+	auto first = reinterpret_cast<unsigned char const*>(key);
+	auto last = first + length;
+	detail_::hash_tag(first, last);
+	return std::uint_fast16_t(detail_::slot_update(0u, first, last) &
+		(key_slot_count - 1u));
+}
+
+//! Calculates the Redis cluster slot of a key held in a contiguous
+//! range of bytes, like `std::string` or `std::string_view`.
+template <typename Range>
+auto key_slot(Range const& key) noexcept ->
+	std::enable_if_t<detail_::is_contiguous_byte_range<Range>::value,
+		std::uint_fast16_t>
+{
+	return key_slot(reinterpret_cast<char const*>(key.data()),
+		key.size());
+}
+
+//! Calculates the Redis cluster slots of several keys, like the keys
+//! of a pipeline of commands.
+//! 
+//! The keys are worked on four at a time, a byte of each in turn, so
+//! the table lookups for one key don't wait for the ones before them:
+//! a byte at a time, each lookup needs the one before it, and most of
+//! the time goes on waiting. The slots are the same as `key_slot`
+//! gives for each key.
+//! 
+//! \param keys  Pointers to the first byte of each key.
+//! \param lengths  The length of each key, in bytes.
+//! \param count  The number of keys.
+//! \param slots  Where to write the slot of each key.
+inline auto key_slots(char const* const* keys, std::size_t const* lengths,
+	std::size_t count, std::uint_fast16_t* slots) noexcept -> void
+{
+	constexpr auto lanes = std::size_t{4u};
+	
+	auto n = std::size_t{0};
+	for (; n + lanes <= count; n += lanes)
+	{
+		unsigned char const* first[lanes];
+		unsigned char const* last[lanes];
+		for (auto lane = std::size_t{0}; lane < lanes; ++lane)
+		{
+			first[lane] = reinterpret_cast<unsigned char const*>(
+				keys[n + lane]);
+			last[lane] = first[lane] + lengths[n + lane];
+			detail_::hash_tag(first[lane], last[lane]);
+		}
+		
+		auto common = static_cast<std::size_t>(last[0] - first[0]);
+		for (auto lane = std::size_t{1}; lane < lanes; ++lane)
+		{
+			auto const length = static_cast<std::size_t>(last[lane] -
+				first[lane]);
+			common = length < common ? length : common;
+		}
+		
+		auto c0 = 0u, c1 = 0u, c2 = 0u, c3 = 0u;
+		for (auto i = std::size_t{0}; i < common; ++i)
+		{
+			c0 = detail_::slot_step(c0, first[0][i]);
+			c1 = detail_::slot_step(c1, first[1][i]);
+			c2 = detail_::slot_step(c2, first[2][i]);
+			c3 = detail_::slot_step(c3, first[3][i]);
+		}
+		
+		unsigned const crcs[lanes] = {c0, c1, c2, c3};
+		for (auto lane = std::size_t{0}; lane < lanes; ++lane)
+			slots[n + lane] = std::uint_fast16_t(detail_::slot_update(
+				crcs[lane], first[lane] + common, last[lane]) &
+					(key_slot_count - 1u));
+	}
+	
+	for (; n < count; ++n)
+		slots[n] = key_slot(keys[n], lengths[n]);
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
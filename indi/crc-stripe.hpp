@@ -0,0 +1,234 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_STRIPE_
+#define INDI_INC_CRC_STRIPE_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+#include "indi/crc-simd.hpp"
+
+// XOR parity and CRCs for the blocks of a stripe, in one pass.
+//
+// The CRC is linear: the raw CRC of a sequence is the initial value
+// shifted over it, xored with a part that depends on the bytes alone
+// (and is the same function of them for any initial value). So the
+// raw CRC of the xor of K blocks of the same length is the xor of
+// their raw CRCs, give or take one shifted initial value (there for an
+// even number of blocks), and the parity block's CRC never has to be
+// calculated from the parity block itself.
+//
+// The blocks are worked through a few kilobytes at a time. The engine
+// reads each piece from memory, and the parity is then worked out from
+// the pieces while they are still in the L1 cache.
+
+namespace indi {
+namespace crc {
+
+namespace detail_ {
+
+// Works out `size` bytes of the parity, from `offset` in each block.
+inline auto stripe_xor_bytes(unsigned char* parity,
+	unsigned char const* const* blocks, std::size_t count,
+	std::size_t offset, std::size_t size) noexcept -> void
+{
+	auto n = std::size_t{0};
+	for (; size - n >= 8u; n += 8u)
+	{
+		auto word = std::uint64_t{};
+		std::memcpy(&word, blocks[0] + offset + n, 8u);
+		for (auto block = std::size_t{1}; block < count; ++block)
+		{
+			auto next = std::uint64_t{};
+			std::memcpy(&next, blocks[block] + offset + n, 8u);
+			word ^= next;
+		}
+		std::memcpy(parity + n, &word, 8u);
+	}
+	
+	for (; n < size; ++n)
+	{
+		auto b = blocks[0][offset + n];
+		for (auto block = std::size_t{1}; block < count; ++block)
+			b ^= blocks[block][offset + n];
+		parity[n] = b;
+	}
+}
+
+#if INDI_CRC_HAVE_PCLMUL
+
+// As `stripe_xor_bytes`, 64 bytes at a time with SSE2.
+__attribute__((target("sse2")))
+inline auto stripe_xor_sse2(unsigned char* parity,
+	unsigned char const* const* blocks, std::size_t count,
+	std::size_t offset, std::size_t size) noexcept -> void
+{
+	auto n = std::size_t{0};
+	for (; size - n >= 64u; n += 64u)
+	{
+		auto p = reinterpret_cast<__m128i const*>(blocks[0] + offset + n);
+		auto x0 = _mm_loadu_si128(p);
+		auto x1 = _mm_loadu_si128(p + 1);
+		auto x2 = _mm_loadu_si128(p + 2);
+		auto x3 = _mm_loadu_si128(p + 3);
+		for (auto block = std::size_t{1}; block < count; ++block)
+		{
+			p = reinterpret_cast<__m128i const*>(
+				blocks[block] + offset + n);
+			x0 = _mm_xor_si128(x0, _mm_loadu_si128(p));
+			x1 = _mm_xor_si128(x1, _mm_loadu_si128(p + 1));
+			x2 = _mm_xor_si128(x2, _mm_loadu_si128(p + 2));
+			x3 = _mm_xor_si128(x3, _mm_loadu_si128(p + 3));
+		}
+		
+		auto const d = reinterpret_cast<__m128i*>(parity + n);
+		_mm_storeu_si128(d, x0);
+		_mm_storeu_si128(d + 1, x1);
+		_mm_storeu_si128(d + 2, x2);
+		_mm_storeu_si128(d + 3, x3);
+	}
+	
+	stripe_xor_bytes(parity + n, blocks, count, offset + n, size - n);
+}
+
+#endif
+
+inline auto stripe_xor(unsigned char* parity,
+	unsigned char const* const* blocks, std::size_t count,
+	std::size_t offset, std::size_t size) noexcept -> void
+{
+#if INDI_CRC_HAVE_PCLMUL
+	stripe_xor_sse2(parity, blocks, count, offset, size);
+#else
+	stripe_xor_bytes(parity, blocks, count, offset, size);
+#endif
+}
+
+} // namespace detail_
+
+//! Calculates the XOR parity block of a stripe, and the raw CRCs of its
+//! data blocks and of the parity block, in one pass.
+//! 
+//! The data blocks are read once. The parity block's CRC is worked out
+//! from the data blocks' CRCs, without reading the parity block.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param init  The initial value for every block.
+//! \param blocks  Pointers to the data blocks.
+//! \param count  The number of data blocks.
+//! \param size  The size of each block, in bytes.
+//! \param parity  Where to write the parity block (`size` bytes), which
+//!     must not overlap the data blocks.
+//! \param crcs  Where to write the `count + 1` raw CRCs: those of the
+//!     data blocks, in order, then that of the parity block.
+//! \param polynomial  The encoded polynomial value.
+//! \param engine  The CRC engine (reflected, for `polynomial`).
+template <std::size_t Bits, typename T, typename Engine>
+auto calculate_stripe_raw(T init, unsigned char const* const* blocks,
+		std::size_t count, std::size_t size, unsigned char* parity,
+		T* crcs, T polynomial, Engine const& engine) noexcept ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+	for (auto block = std::size_t{0}; block < count; ++block)
+		crcs[block] = init;
+	
+	for (auto offset = std::size_t{0}; offset < size; )
+	{
+		auto const piece = size - offset < detail_::cache_block ?
+			size - offset : detail_::cache_block;
+		
+		for (auto block = std::size_t{0}; block < count; ++block)
+		{
+			auto const first = blocks[block] + offset;
+			crcs[block] = T(engine.update(crcs[block], first,
+				first + piece));
+		}
+		
+		if (count != 0u)
+			detail_::stripe_xor(parity + offset, blocks, count, offset,
+				piece);
+		
+		offset += piece;
+	}
+	
+	if (count == 0u)
+		std::memset(parity, 0, size);
+	
+	// Each data block's raw CRC is the initial value shifted over the
+	// block, xored with the part that depends on its bytes. Xoring them
+	// leaves the shifted initial value in an odd number of times, so it
+	// has to be put back for an even number.
+	auto parity_crc = T{};
+	for (auto block = std::size_t{0}; block < count; ++block)
+		parity_crc ^= crcs[block];
+	if (count % 2u == 0u)
+		parity_crc ^= combine<Bits>(init, T{}, size, polynomial);
+	
+	crcs[count] = parity_crc;
+}
+
+//! Calculates the XOR parity block of a stripe, and the CRCs of its
+//! data blocks and of the parity block, in one pass.
+//! 
+//! This gives the same parity block as xoring the data blocks together,
+//! and the same CRCs as `calculate` over each of the data blocks and
+//! over the parity block (see `calculate_stripe_raw`). For example:
+//! 
+//!     auto const engine = indi::crc::clmul_engine<32>{
+//!         indi::crc::polynomials::crc32c};
+//!     unsigned char const* blocks[] = {a, b, c, d};
+//!     std::uint_fast32_t crcs[5];
+//!     indi::crc::calculate_stripe<32>(blocks, 4u, block_size, parity,
+//!         crcs, indi::crc::polynomials::crc32c, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param blocks  Pointers to the data blocks.
+//! \param count  The number of data blocks.
+//! \param size  The size of each block, in bytes.
+//! \param parity  Where to write the parity block (`size` bytes), which
+//!     must not overlap the data blocks.
+//! \param crcs  Where to write the `count + 1` CRCs: those of the data
+//!     blocks, in order, then that of the parity block.
+//! \param polynomial  The encoded polynomial value.
+//! \param engine  The CRC engine (reflected, for `polynomial`).
+template <std::size_t Bits, typename T, typename Engine>
+auto calculate_stripe(unsigned char const* const* blocks,
+		std::size_t count, std::size_t size, unsigned char* parity,
+		T* crcs, T polynomial, Engine const& engine) noexcept ->
+	std::enable_if_t<detail_::is_crc_engine<Engine>::value>
+{
+	constexpr auto ones = detail_::ones<Bits, T>();
+	calculate_stripe_raw<Bits>(ones, blocks, count, size, parity, crcs,
+		polynomial, engine);
+	for (auto block = std::size_t{0}; block <= count; ++block)
+		crcs[block] = T(crcs[block] ^ ones);
+}
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
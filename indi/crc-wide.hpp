@@ -0,0 +1,340 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INDI_INC_CRC_WIDE_
+#define INDI_INC_CRC_WIDE_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "indi/crc.hpp"
+
+namespace indi {
+namespace crc {
+
+//! A 65536-element lookup table, for CRCs of up to 16 bits two bytes at
+//! a time.
+//! 
+//! The entries are the smallest type that holds a CRC, so the table
+//! takes 64 KB for CRCs of up to 8 bits, and 128 KB up to 16 bits.
+template <std::size_t Bits>
+using wide_table = std::array<detail_::crc_least_t<Bits>, 65536>;
+
+//! Generates a 65536-element lookup table for CRC calculations two
+//! bytes at a time.
+//! 
+//! This extends `generate_table` to 16-bit values: entry `n` is the CRC
+//! of the bytes `n & 0xFF` and `n >> 8`, in that order, so that it can
+//! be looked up with the CRC added to the next two bytes, read
+//! little-endian. See `wide_engine`.
+//! 
+//! The table is filled in place, since it's too large to be returned on
+//! the stack.
+//! 
+//! \requires `Bits` must be greater than zero and at most 16. `T` must
+//!           be at least `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! \param table  The table to fill in.
+template <std::size_t Bits, typename T>
+auto generate_wide_table(T polynomial, wide_table<Bits>& table) noexcept
+	-> void
+{
+	static_assert(Bits <= 16u, "wide tables are for CRCs up to 16 bits");
+	
+	auto const bytes = generate_table<Bits>(polynomial);
+	
+	for (auto n = std::size_t{0}; n < table.size(); ++n)
+		table[n] = detail_::crc_least_t<Bits>(calculate_next(
+			calculate_next(T{0u}, std::uint_fast8_t(n & 0xFFu), bytes),
+			std::uint_fast8_t(n >> 8), bytes));
+}
+
+//! Generates a 65536-element lookup table for non-reflected CRC
+//! calculations two bytes at a time.
+//! 
+//! This extends `generate_normal_table` to 16-bit values: entry `n` is
+//! the CRC of the bytes `n >> 8` and `n & 0xFF`, in that order, so that
+//! it can be looked up with the CRC (shifted up to 16 bits) added to
+//! the next two bytes, read big-endian.
+//! 
+//! \requires `Bits` must be greater than zero and at most 16. `T` must
+//!           be at least `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! \param table  The table to fill in.
+template <std::size_t Bits, typename T>
+auto generate_normal_wide_table(T polynomial, wide_table<Bits>& table)
+	noexcept -> void
+{
+	static_assert(Bits <= 16u, "wide tables are for CRCs up to 16 bits");
+	
+	auto const bytes = generate_normal_table<Bits>(polynomial);
+	
+	for (auto n = std::size_t{0}; n < table.size(); ++n)
+		table[n] = detail_::crc_least_t<Bits>(calculate_next_normal<Bits>(
+			calculate_next_normal<Bits>(T{0u}, std::uint_fast8_t(n >> 8),
+				bytes),
+			std::uint_fast8_t(n & 0xFFu), bytes));
+}
+
+//! The alignment of shared wide tables.
+constexpr auto wide_table_alignment = std::size_t{4096u};
+
+namespace detail_ {
+
+template <std::size_t Bits, bool Reflected, typename T>
+auto make_wide_table(T polynomial) -> std::shared_ptr<wide_table<Bits> const>
+{
+	// Over-allocate, and line the table up with a page inside the
+	// allocation. (Over-aligned `new` needs C++17.)
+	auto const memory = std::shared_ptr<void>{
+		::operator new(sizeof(wide_table<Bits>) + wide_table_alignment),
+		[](void* p) { ::operator delete(p); }};
+	
+	auto const address = reinterpret_cast<std::uintptr_t>(memory.get());
+	auto const aligned = (address + wide_table_alignment - 1u) &
+		~std::uintptr_t{wide_table_alignment - 1u};
+	auto const table = ::new (reinterpret_cast<void*>(aligned))
+		wide_table<Bits>;
+	
+	if (Reflected)
+		generate_wide_table<Bits>(polynomial, *table);
+	else
+		generate_normal_wide_table<Bits>(polynomial, *table);
+	
+	// The table is trivially destructible, so only the memory needs
+	// freeing.
+	return std::shared_ptr<wide_table<Bits> const>{memory, table};
+}
+
+template <std::size_t Bits, bool Reflected, typename T>
+auto shared_wide_table(T polynomial)
+	-> std::shared_ptr<wide_table<Bits> const>
+{
+	static std::mutex mutex;
+	static std::map<std::uint_fast64_t,
+		std::weak_ptr<wide_table<Bits> const>> tables;
+	
+	std::lock_guard<std::mutex> lock{mutex};
+	
+	auto& entry = tables[polynomial];
+	auto table = entry.lock();
+	if (!table)
+	{
+		table = make_wide_table<Bits, Reflected>(polynomial);
+		entry = table;
+	}
+	
+	return table;
+}
+
+} // namespace detail_
+
+//! Gets a shared 65536-element lookup table for CRC calculations.
+//! 
+//! The table is generated with `generate_wide_table` the first time
+//! it's asked for, in its own page-aligned allocation, and shared by
+//! everything that asks for it after that, until the last reference to
+//! it is released. Processes that never ask for a wide table don't pay
+//! for one.
+//! 
+//! This is thread-safe.
+//! 
+//! \requires `Bits` must be greater than zero and at most 16. `T` must
+//!           be at least `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns The shared table.
+//! 
+//! \throws std::bad_alloc if the table could not be allocated.
+template <std::size_t Bits, typename T>
+auto shared_wide_table(T polynomial)
+{
+	return detail_::shared_wide_table<Bits, true>(polynomial);
+}
+
+//! Gets a shared 65536-element lookup table for non-reflected CRC
+//! calculations.
+//! 
+//! Like `shared_wide_table`, only with `generate_normal_wide_table`.
+//! 
+//! \requires `Bits` must be greater than zero and at most 16. `T` must
+//!           be at least `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns The shared table.
+//! 
+//! \throws std::bad_alloc if the table could not be allocated.
+template <std::size_t Bits, typename T>
+auto shared_normal_wide_table(T polynomial)
+{
+	return detail_::shared_wide_table<Bits, false>(polynomial);
+}
+
+//! A CRC engine that uses a 65536-element lookup table, for CRCs of up
+//! to 16 bits.
+//! 
+//! Each lookup depends on the one before, so a table-driven CRC takes
+//! the latency of one lookup per byte. With a table indexed by two
+//! bytes, it takes one lookup per two bytes. The table takes 128 KB
+//! (64 KB up to 8 bits), so it pays off on hot paths that checksum a
+//! lot of data, like CRC-16/MODBUS or CRC-8 fieldbus gateways, but not
+//! where the table would have been evicted between messages.
+//! 
+//! The table is shared between engines with the same polynomial (see
+//! `shared_wide_table`), so engines are cheap to create once one
+//! exists, and to copy.
+//! 
+//! Like a lookup table, a reflected engine can be passed to `calculate`
+//! and `calculate_raw`, and a non-reflected one to
+//! `calculate_normal_raw`:
+//! 
+//!     auto const engine = indi::crc::wide_engine<16>{
+//!         indi::crc::polynomials::crc16_ibm};
+//!     auto const crc = indi::crc::calculate_raw<16>(
+//!         std::uint_fast16_t{0xFFFFu}, data, engine);
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Reflected  True for reflected CRCs, false for non-reflected
+//!     (MSB-first) ones.
+template <std::size_t Bits, typename T, bool Reflected>
+class basic_wide_engine
+{
+	static_assert(Bits > 0u && Bits <= 16u,
+		"wide tables are for CRCs up to 16 bits");
+
+public:
+	using crc_engine_tag = void;
+	using crc_type = T;
+	static constexpr auto bits = Bits;
+	static constexpr auto reflected = Reflected;
+	
+	using table_type = wide_table<Bits>;
+	
+	//! Creates an engine.
+	//! 
+	//! \param polynomial  The encoded polynomial value.
+	//! 
+	//! \throws std::bad_alloc if the table could not be allocated.
+	explicit basic_wide_engine(T polynomial) :
+		table_(detail_::shared_wide_table<Bits, Reflected>(polynomial)),
+		bytes_(Reflected ? generate_table<Bits>(polynomial) :
+			generate_normal_table<Bits>(polynomial))
+	{}
+	
+	//! Calculates the raw CRC of a sequence of bytes.
+	//! 
+	//! \param crc  The raw CRC of the preceding sequence (or the
+	//!     initial value).
+	//! \param first  The start of the sequence.
+	//! \param last  The end of the sequence.
+	//! 
+	//! \returns The raw CRC.
+	auto update(T crc, unsigned char const* first,
+		unsigned char const* last) const noexcept -> T
+	{
+		return update(crc, first, last, std::integral_constant<bool,
+			Reflected>{});
+	}
+	
+	//! Gets the 65536-element lookup table.
+	auto table() const noexcept -> table_type const&
+	{
+		return *table_;
+	}
+
+private:
+	auto update(T crc, unsigned char const* first,
+		unsigned char const* last, std::true_type /* reflected */)
+		const noexcept -> T
+	{
+		auto const& table = *table_;
+		
+		// The CRC lines up with the first bits of the next two bytes.
+		for (; last - first >= 2; first += 2)
+			crc = T(table[crc ^ first[0] ^ (unsigned{first[1]} << 8)]);
+		
+		if (first != last)
+			crc = calculate_next(crc, *first, bytes_);
+		
+		return crc;
+	}
+	
+	auto update(T crc, unsigned char const* first,
+		unsigned char const* last, std::false_type /* reflected */)
+		const noexcept -> T
+	{
+		auto const& table = *table_;
+		
+		// The CRC, shifted up to 16 bits, lines up with the first bits
+		// of the next two bytes.
+		for (; last - first >= 2; first += 2)
+			crc = T(table[(unsigned(crc) << (16u - Bits)) ^
+				(unsigned{first[0]} << 8) ^ first[1]]);
+		
+		if (first != last)
+			crc = calculate_next_normal<Bits>(crc, *first, bytes_);
+		
+		return crc;
+	}
+	
+	std::shared_ptr<table_type const> table_;
+	std::array<T, 256> bytes_;
+};
+
+//! A reflected CRC engine that uses a 65536-element lookup table.
+//! 
+//! \see basic_wide_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using wide_engine = basic_wide_engine<Bits, T, true>;
+
+//! A non-reflected CRC engine that uses a 65536-element lookup table.
+//! 
+//! \see basic_wide_engine
+template <std::size_t Bits, typename T = crc_type_t<Bits>>
+using normal_wide_engine = basic_wide_engine<Bits, T, false>;
+
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -22,7 +22,9 @@
 #include <cstdint>
 #include <iterator>
 #include <numeric>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace indi {
 namespace crc {
@@ -59,6 +61,15 @@ struct crc_type
 template <std::size_t Bits>
 using crc_type_t = typename crc_type<Bits>::type;
 
+// The functions that go over the same bytes more than once
+// (`calculate_multi`, `copy_and_calculate`, and `calculate_stripe`) do
+// it a block of this many bytes at a time. That is small enough for a
+// block (or the pieces of a few) to stay in the L1 cache between
+// passes, and just enough for the 512-bit kernel of a `clmul_engine`
+// with the default `wide_threshold`; an engine with a larger one only
+// uses its 128-bit kernel through them.
+constexpr auto cache_block = std::size_t{4096u};
+
 //! Create a value with a given number of set bits.
 //! 
 //! This produces a value of type `T` with the `Bits` least significant
@@ -125,6 +136,114 @@ struct is_random_access_iterator<T,
             >::type> :
     std::true_type{};
 
+template <typename...>
+struct make_void
+{
+	using type = void;
+};
+
+template <typename... Ts>
+using void_t = typename make_void<Ts...>::type;
+
+//! CRC engine detector.
+//! 
+//! A CRC engine is an object that calculates CRCs some faster way than
+//! a plain lookup table, which can be passed to `calculate` and
+//! `calculate_raw` in place of a table. An engine type has:
+//! 
+//! * a `crc_engine_tag` member type (which marks it as an engine);
+//! * a `crc_type` member type, the CRC type;
+//! * a `bits` static constant, the CRC bit-size;
+//! * a `reflected` static constant, true if the engine calculates
+//!   reflected CRCs (for `calculate_raw`), or false if it calculates
+//!   non-reflected ones (for `calculate_normal_raw`);
+//! * an `update(crc_type crc, unsigned char const* first,
+//!   unsigned char const* last) const` member function, which
+//!   calculates the raw CRC of a contiguous sequence of bytes, given
+//!   the raw CRC of the preceding sequence.
+//! 
+//! Sequences that are not contiguous bytes are copied to a buffer a
+//! piece at a time, and handed to `update` from there.
+//! 
+//! An engine may also have an `update_batch(crc_type crc,
+//! unsigned char const* const* messages, std::size_t const* lengths,
+//! std::size_t count, crc_type* crcs) const` member function, which
+//! calculates the raw CRCs of several contiguous messages at once, for
+//! `calculate_batch`.
+template <typename T, typename = void>
+struct is_crc_engine : std::false_type{};
+
+template <typename T>
+struct is_crc_engine<T, void_t<typename T::crc_engine_tag>> :
+    std::true_type{};
+
+//! Multiple engine detector.
+//! 
+//! True if every one of `Ts` is a CRC engine, and there is at least one
+//! (see `is_crc_engine`).
+template <typename... Ts>
+struct are_crc_engines : std::false_type{};
+
+template <typename T>
+struct are_crc_engines<T> : is_crc_engine<T>{};
+
+template <typename T, typename U, typename... Ts>
+struct are_crc_engines<T, U, Ts...> :
+    std::integral_constant<bool, is_crc_engine<T>::value &&
+        are_crc_engines<U, Ts...>::value>{};
+
+//! Batch engine detector.
+//! 
+//! True if `T` is a CRC engine with an `update_batch` member function
+//! (see `is_crc_engine`).
+template <typename T, typename = void>
+struct has_update_batch : std::false_type{};
+
+template <typename T>
+struct has_update_batch<T, void_t<decltype(
+        std::declval<T const&>().update_batch(
+            std::declval<typename T::crc_type>(),
+            std::declval<unsigned char const* const*>(),
+            std::declval<std::size_t const*>(), std::size_t{},
+            std::declval<typename T::crc_type*>()))>> :
+    std::true_type{};
+
+//! Byte pointer detector.
+//! 
+//! True if `It` is a pointer to a byte-sized integer type, so a
+//! sequence of `It`s can be handed to an engine as raw memory.
+template <typename It>
+struct is_byte_pointer : std::integral_constant<bool,
+        std::is_pointer<It>::value &&
+            std::is_integral<std::remove_cv_t<
+                std::remove_pointer_t<It>>>::value &&
+            sizeof(std::remove_pointer_t<It>) == 1>{};
+
+//! Contiguous byte range detector.
+//! 
+//! True if `Range` has `data()` and `size()` members, with `data()`
+//! returning a byte pointer (as `std::vector<unsigned char>`,
+//! `std::string`, and `std::array<std::uint8_t, N>` do).
+template <typename Range, typename = void>
+struct is_contiguous_byte_range : std::false_type{};
+
+template <typename Range>
+struct is_contiguous_byte_range<Range, void_t<
+        decltype(std::declval<Range const&>().data()),
+        decltype(std::declval<Range const&>().size())>> :
+    is_byte_pointer<decltype(std::declval<Range const&>().data())>{};
+
+//! The smallest type that holds a CRC, for keeping tables compact
+//! (`crc_type_t` is a "fast" type, which can be wider than needed).
+template <std::size_t Bits>
+using crc_least_t = std::conditional_t<(Bits <= 8),
+	std::uint_least8_t,
+	std::conditional_t<(Bits <= 16),
+		std::uint_least16_t,
+		std::conditional_t<(Bits <= 32),
+			std::uint_least32_t,
+			std::uint_least64_t>>>;
+
 } // namespace detail_
 
 template <std::size_t Bits>
@@ -330,6 +449,393 @@ constexpr auto reversed(T polynomial) noexcept
 
 } // namespace polynomials
 
+namespace detail_ {
+
+//! Multiplies a polynomial by `x`, modulo a CRC polynomial.
+//! 
+//! Both the operand and the result are in the reflected form used by
+//! the CRC calculation functions: bit `Bits - 1` is the coefficient of
+//! `x^0`, and bit 0 is the coefficient of `x^(Bits - 1)`.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T     The CRC type.
+//! 
+//! \param a  The polynomial to multiply, in reflected form.
+//! \param reversed_polynomial  The CRC polynomial in reversed form.
+//! 
+//! \returns `(a * x) mod P`, in reflected form.
+template <std::size_t Bits, typename T>
+constexpr auto multiply_x_mod(T a, T reversed_polynomial) noexcept
+{
+	return T((a & 1u) ? ((a >> 1) ^ reversed_polynomial) : (a >> 1));
+}
+
+//! Multiplies two polynomials modulo a CRC polynomial.
+//! 
+//! All values are in reflected form (see `multiply_x_mod`).
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T     The CRC type.
+//! 
+//! \param a  The first polynomial, in reflected form.
+//! \param b  The second polynomial, in reflected form.
+//! \param reversed_polynomial  The CRC polynomial in reversed form.
+//! 
+//! \returns `(a * b) mod P`, in reflected form.
+template <std::size_t Bits, typename T>
+constexpr auto multiply_mod(T a, T b, T reversed_polynomial) noexcept
+{
+	auto product = T{};
+	
+	// Walk the terms of a from x^0 upwards, adding b * x^i for every
+	// term present.
+	for (auto bit = std::size_t{0}; bit < Bits; ++bit)
+	{
+		// IMPORTANT: The "1" must be cast to T before shifting.
+		if (a & (T(0x1u) << (Bits - 1 - bit)))
+			product ^= b;
+		
+		b = multiply_x_mod<Bits>(b, reversed_polynomial);
+	}
+	
+	return product;
+}
+
+//! Calculates `x^(8 * n) mod P`.
+//! 
+//! This is the operator that advances a CRC over `n` zero bytes. The
+//! result is in reflected form (see `multiply_x_mod`).
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T     The CRC type.
+//! 
+//! \param n  The number of bytes.
+//! \param reversed_polynomial  The CRC polynomial in reversed form.
+//! 
+//! \returns `x^(8 * n) mod P`, in reflected form.
+template <std::size_t Bits, typename T>
+constexpr auto x_pow_8n_mod(std::uintmax_t n, T reversed_polynomial)
+	noexcept
+{
+	// IMPORTANT: The "1" must be cast to T before shifting.
+	auto result = T(T(0x1u) << (Bits - 1));
+	
+	auto square = result;
+	for (auto bit = 0; bit < 8; ++bit)
+		square = multiply_x_mod<Bits>(square, reversed_polynomial);
+	
+	// Square-and-multiply over the bits of n.
+	while (n != 0u)
+	{
+		if (n & 1u)
+			result = multiply_mod<Bits>(result, square,
+				reversed_polynomial);
+		
+		square = multiply_mod<Bits>(square, square, reversed_polynomial);
+		n >>= 1;
+	}
+	
+	return result;
+}
+
+} // namespace detail_
+
+//! Combines the CRCs of two consecutive sequences.
+//! 
+//! Given the CRC of a sequence `A`, and the CRC of a sequence `B` that
+//! is `length2` bytes long, this calculates the CRC of the sequence
+//! `A` followed by `B`, without needing `A` or `B` themselves.
+//! 
+//! This works both for CRCs returned by `calculate` and for raw CRCs
+//! returned by `calculate_raw`, so long as `crc2` was calculated with
+//! the same initial value as the final xor value - that is, with all
+//! bits set for `calculate`, or 0 for `calculate_raw`. (`crc1` can be
+//! calculated with any initial value.)
+//! 
+//! Because of this, a large sequence can be split into pieces, the
+//! pieces can have their CRCs calculated in parallel, and then the
+//! results can be combined in order.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The CRC type.
+//! 
+//! \param crc1  The CRC of the first sequence.
+//! \param crc2  The CRC of the second sequence.
+//! \param length2  The length of the second sequence, in bytes.
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns The CRC of the concatenated sequences.
+template <std::size_t Bits, typename T>
+constexpr auto combine(T crc1, T crc2, std::uintmax_t length2,
+		T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	auto const reversed_polynomial =
+		polynomials::reversed<Bits>(polynomial);
+	
+	auto const shift = detail_::x_pow_8n_mod<Bits>(length2,
+		reversed_polynomial);
+	
+	return T(detail_::multiply_mod<Bits>(crc1, shift,
+		reversed_polynomial) ^ crc2);
+}
+
+//! Calculates the residue of a CRC.
+//! 
+//! When a message is followed by its CRC, as returned by `calculate`,
+//! least significant byte first (the order reflected CRCs are sent
+//! in), the CRC of the whole frame is always the same value, whatever
+//! the message: the residue. So a frame can be checked with one pass
+//! over the message and the CRC together (see `verify`).
+//! 
+//! \requires `Bits` must be a multiple of 8. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The CRC type.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns The CRC of any message followed by its CRC.
+template <std::size_t Bits, typename T>
+constexpr auto residue(T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0 && Bits % CHAR_BIT == 0,
+		"the CRC must be a whole number of bytes");
+	
+	// Xoring the CRC into the raw CRC of the message leaves all bits
+	// set (the final xor value), whatever the message, and the CRC
+	// bytes then shift that over Bits / 8 bytes.
+	constexpr auto ones = detail_::ones<Bits, T>();
+	auto const reversed_polynomial =
+		polynomials::reversed<Bits>(polynomial);
+	auto const shift = detail_::x_pow_8n_mod<Bits>(Bits / CHAR_BIT,
+		reversed_polynomial);
+	
+	return T(ones ^ detail_::multiply_mod<Bits>(ones, shift,
+		reversed_polynomial));
+}
+
+// Polynomial arithmetic ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// These are the building blocks of faster CRC algorithms: folding
+// (carry-less multiplication) kernels move data forward by multiplying
+// it by `x^n mod P` for some fixed distances `n`, and reduce the result
+// with Barrett reduction, which needs `floor(x^(2 * Bits) / P)`. All of
+// them are `constexpr`, so those constants can be worked out at compile
+// time for any polynomial.
+// 
+// Reflected form is the form the reflected CRC functions use: bit
+// `Bits - 1` is the coefficient of `x^0`. Normal form is the other way
+// round: bit 0 is the coefficient of `x^0`, as used by the non-reflected
+// functions, and by the encoded polynomials themselves.
+
+//! Calculates `x^n mod P`, in reflected form.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param n  The power of `x`.
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns `x^n mod P`, in reflected form.
+template <std::size_t Bits, typename T>
+constexpr auto x_pow_mod(std::uintmax_t n, T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	auto const reversed_polynomial =
+		polynomials::reversed<Bits>(polynomial);
+	
+	// IMPORTANT: The "1" must be cast to T before shifting.
+	auto result = T(T(0x1u) << (Bits - 1));
+	auto square = detail_::multiply_x_mod<Bits>(result,
+		reversed_polynomial);
+	
+	// Square-and-multiply over the bits of n.
+	while (n != 0u)
+	{
+		if (n & 1u)
+			result = detail_::multiply_mod<Bits>(result, square,
+				reversed_polynomial);
+		
+		square = detail_::multiply_mod<Bits>(square, square,
+			reversed_polynomial);
+		n >>= 1;
+	}
+	
+	return result;
+}
+
+//! Calculates `x^n mod P`, in normal form.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param n  The power of `x`.
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns `x^n mod P`, in normal form.
+template <std::size_t Bits, typename T>
+constexpr auto x_pow_mod_normal(std::uintmax_t n, T polynomial) noexcept
+{
+	return polynomials::reversed<Bits>(x_pow_mod<Bits>(n, polynomial));
+}
+
+//! Calculates the Barrett reduction constant for a polynomial, in
+//! normal form.
+//! 
+//! This is `floor(x^(2 * Bits) / P)`, which has degree `Bits`; like an
+//! encoded polynomial, the `x^Bits` term is left out.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns `floor(x^(2 * Bits) / P) - x^Bits`, in normal form.
+template <std::size_t Bits, typename T>
+constexpr auto barrett_mu_normal(T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	constexpr auto mask = detail_::ones<Bits, T>();
+	// IMPORTANT: The "1" must be cast to T before shifting.
+	constexpr auto top = T(T(0x1u) << (Bits - 1));
+	
+	// Long division of x^(2 * Bits). `window` holds the running
+	// remainder, below the term being divided out (`lead`).
+	auto quotient = T{};
+	auto lead = true;
+	auto window = T{};
+	
+	for (auto term = std::size_t{0}; term <= Bits; ++term)
+	{
+		quotient = T(((quotient << 1) | (lead ? 1u : 0u)) & mask);
+		if (lead)
+			window ^= polynomial;
+		lead = (window & top) != 0u;
+		window = T((window << 1) & mask);
+	}
+	
+	return quotient;
+}
+
+//! Calculates the Barrett reduction constant for a polynomial, in
+//! reflected form.
+//! 
+//! \see barrett_mu_normal
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns `floor(x^(2 * Bits) / P) - x^Bits`, in reflected form.
+template <std::size_t Bits, typename T>
+constexpr auto barrett_mu(T polynomial) noexcept
+{
+	return polynomials::reversed<Bits>(barrett_mu_normal<Bits>(polynomial));
+}
+
+namespace detail_ {
+
+// One entry of a lookup table (for `generate_table`), on its own so
+// that tables can be filled in constant expressions before C++17,
+// where `std::array` can't be (see `fixed_table` in
+// `indi/crc-fixed.hpp`).
+template <typename T>
+constexpr auto table_entry(T reversed_polynomial, std::size_t n) noexcept
+{
+	// Start with the value set as the index.
+	auto crc = T(n);
+	
+	// For each bit...
+	for (auto bit = 0; bit < 8; ++bit)
+	{
+		// ... if the bit is set, XOR the value with the reversed
+		// polynomial.
+		if (crc & 1)
+		{
+			crc >>= 1;
+			crc ^= reversed_polynomial;
+		}
+		// ... if the bit is not set, do nothing.
+		else
+		{
+			crc >>= 1;
+		}
+	}
+	
+	return crc;
+}
+
+// The same for `generate_normal_table`.
+template <std::size_t Bits, typename T>
+constexpr auto normal_table_entry(T polynomial, std::size_t n) noexcept
+{
+	constexpr auto mask = detail_::ones<Bits, T>();
+	
+	auto crc = T{0};
+	
+	// Feed in each bit of the index, most significant first. (This
+	// works for CRCs narrower than a byte, where the index can't just
+	// be put at the top of the CRC.)
+	for (auto bit = 7; bit >= 0; --bit)
+	{
+		auto const feedback = ((crc >> (Bits - 1u)) ^ (n >> bit)) & 1u;
+		crc = T((crc << 1) & mask);
+		if (feedback)
+			crc ^= polynomial;
+	}
+	
+	return crc;
+}
+
+} // namespace detail_
+
 //! Generates a 256-element lookup table for CRC calculations.
 //! 
 //! The lookup table can be used in any of the CRC calculation
@@ -362,27 +868,7 @@ constexpr auto generate_table(T polynomial) noexcept
 	auto table = std::array<T, 256>{};
 	
 	for (auto n = std::size_t{0}; n < std::size_t{256}; ++n)
-	{
-		// Start with the value set as the index.
-		table[n] = T(n);
-		
-		// For each bit...
-		for (auto bit = 0; bit < 8; ++bit)
-		{
-			// ... if the bit is set, XOR the value with the reversed
-			// polynomial.
-			if (table[n] & 1)
-			{
-				table[n] >>= 1;
-				table[n] ^= reversed_polynomial;
-			}
-			// ... if the bit is not set, do nothing.
-			else
-			{
-				table[n] >>= 1;
-			}
-		}
-	}
+		table[n] = detail_::table_entry(reversed_polynomial, n);
 	
 	return table;
 }
@@ -429,6 +915,44 @@ constexpr auto generate_table() noexcept ->
 	return generate_table<Bits>(polynomials::crc32);
 }
 
+//! Generates a 256-element lookup table for non-reflected CRC
+//! calculations.
+//! 
+//! Non-reflected (or MSB-first) CRCs process each byte from its most
+//! significant bit down, and keep the CRC with the highest power of x
+//! in its most significant bit, as CRC-32/MPEG-2, CRC-16/XMODEM, and
+//! CRC-64/ECMA-182 do. The lookup table can be used in
+//! `calculate_next_normal` and `calculate_normal_raw`.
+//! 
+//! \requires `Bits` must be greater than zero. `T` must be at least
+//!           `Bits` bits in size.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \tparam T The type of the encoded polynomial value.
+//! 
+//! \param polynomial  The encoded polynomial value.
+//! 
+//! \returns An std::array<T, 256> with the computed non-reflected CRCs
+//!          of every value from 0 to 255, using the given polynomial.
+template <std::size_t Bits, typename T>
+constexpr auto generate_normal_table(T polynomial) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits <= (sizeof(T) * CHAR_BIT), "T is too small");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	auto table = std::array<T, 256>{};
+	
+	for (auto n = std::size_t{0}; n < std::size_t{256}; ++n)
+		table[n] = detail_::normal_table_entry<Bits>(polynomial, n);
+	
+	return table;
+}
+
 //! Calculates the CRC of an 8-bit value given a previous CRC and a
 //! lookup table.
 //! 
@@ -541,7 +1065,47 @@ constexpr auto calculate_next(T current, std::uint_fast8_t b,
 	static_assert(N >= 256,
 		"CRC lookup table must have at least 256 items");
 	
-	return calculate_next(current, b, table + 0);
+	return calculate_next(current, b, table + 0);
+}
+
+//! Calculates the non-reflected CRC of an 8-bit value given a previous
+//! CRC and a lookup table.
+//! 
+//! \requires `T` is an unsigned integral type.
+//! \requires `Table` is a lookup table from `generate_normal_table`
+//!     (or anything else indexable with 256 values convertible to `T`).
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! \tparam T  The CRC type.
+//! \tparam Table  The lookup table type.
+//! 
+//! \param current  The CRC of the preceding input sequence.
+//! \param b  The next 8-bit value in the input sequence.
+//! \param table  The lookup table.
+//! 
+//! \returns The computed CRC.
+template <std::size_t Bits, typename T, typename Table>
+constexpr auto calculate_next_normal(T current, std::uint_fast8_t b,
+		Table const& table) noexcept
+{
+	static_assert(std::is_integral<T>::value,
+		"CRC type must be integer");
+	static_assert(std::is_unsigned<T>::value,
+		"CRC type must be unsigned");
+	static_assert(Bits > 0, "0-bit CRCs make no sense");
+	
+	using std::begin;
+	
+	constexpr auto up = Bits <= 8u ? 8u - Bits : 0u;
+	constexpr auto down = Bits > 8u ? Bits - 8u : 0u;
+	
+	// For CRCs narrower than a byte, the whole CRC combines with the
+	// byte; otherwise only the top byte does, and the rest is shifted
+	// up past it.
+	return Bits <= 8u ?
+		T(begin(table)[((current << up) ^ b) & 0xffu]) :
+		T((begin(table)[((current >> down) ^ b) & 0xffu] ^
+			(current << 8)) & detail_::ones<Bits, T>());
 }
 
 // calculate_raw ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -556,6 +1120,43 @@ constexpr auto calculate_next(T current, std::uint_fast8_t b,
 // calculate_raw<Bits>(T init, Range const& r, T poly)
 // calculate_raw<Bits>(T init, Range const& r, RAIt table_first)
 // calculate_raw<Bits>(T init, Range const& r, Table const& table)
+// calculate_raw<Bits>(T init, InIt first, Sen last, Engine const& e)
+// calculate_raw<Bits>(T init, Range const& r, Engine const& e)
+
+namespace detail_ {
+
+// Contiguous bytes go straight to the engine.
+template <typename T, typename InputIterator, typename Sentinel,
+	typename Engine>
+auto engine_update(T init, InputIterator first, Sentinel last,
+	Engine const& engine, std::true_type) noexcept
+{
+	return T(engine.update(init,
+		reinterpret_cast<unsigned char const*>(first),
+		reinterpret_cast<unsigned char const*>(last)));
+}
+
+// Anything else is copied to a buffer a piece at a time.
+template <typename T, typename InputIterator, typename Sentinel,
+	typename Engine>
+auto engine_update(T init, InputIterator first, Sentinel last,
+	Engine const& engine, std::false_type) noexcept
+{
+	unsigned char buffer[256];
+	
+	while (first != last)
+	{
+		auto size = std::size_t{0};
+		for (; size < sizeof(buffer) && first != last; ++size, ++first)
+			buffer[size] = static_cast<unsigned char>(*first);
+		
+		init = T(engine.update(init, buffer, buffer + size));
+	}
+	
+	return init;
+}
+
+} // namespace detail_
 
 template <std::size_t Bits, typename T, typename InputIterator,
 	typename Sentinel, typename RandomAccessIterator>
@@ -580,7 +1181,8 @@ constexpr auto calculate_raw(T init, InputIterator first, Sentinel last,
 	std::enable_if_t<
 		detail_::is_input_iterator<InputIterator>::value &&
 			!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	auto calculator = [&table](auto last, auto b)
@@ -611,6 +1213,54 @@ constexpr auto calculate_raw(T init, InputIterator first, Sentinel last,
 	return calculate_raw<Bits>(init, first, last, table);
 }
 
+template <std::size_t Bits, typename T, typename InputIterator,
+	typename Sentinel, typename Engine>
+auto calculate_raw(T init, InputIterator first, Sentinel last,
+		Engine const& engine) noexcept ->
+	std::enable_if_t<
+		detail_::is_input_iterator<InputIterator>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		T>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs (use calculate_normal_raw)");
+	
+	using is_contiguous = std::integral_constant<bool,
+		std::is_same<InputIterator, Sentinel>::value &&
+			detail_::is_byte_pointer<InputIterator>::value>;
+	return detail_::engine_update(init, first, last, engine,
+		is_contiguous{});
+}
+
+template <std::size_t Bits, typename T, typename Range, typename Engine>
+auto calculate_raw(T init, Range const& range, Engine const& engine)
+		noexcept ->
+	std::enable_if_t<
+		!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value &&
+			detail_::is_contiguous_byte_range<Range>::value,
+		T>
+{
+	return calculate_raw<Bits>(init, range.data(),
+		range.data() + range.size(), engine);
+}
+
+template <std::size_t Bits, typename T, typename Range, typename Engine>
+auto calculate_raw(T init, Range const& range, Engine const& engine)
+		noexcept ->
+	std::enable_if_t<
+		!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value &&
+			!detail_::is_contiguous_byte_range<Range>::value,
+		T>
+{
+	using std::begin;
+	using std::end;
+	return calculate_raw<Bits>(init, begin(range), end(range), engine);
+}
+
 template <std::size_t Bits, typename T, typename InputIterator,
 	typename Sentinel>
 constexpr auto calculate_raw(T init, InputIterator first, Sentinel last)
@@ -697,7 +1347,8 @@ constexpr auto calculate_raw(T init, Range const& range,
 	std::enable_if_t<
 		!detail_::is_input_iterator<Range>::value &&
 			!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	using std::begin;
@@ -712,7 +1363,8 @@ constexpr auto calculate_raw(T init, const U(&range)[N],
 		Table const& table) noexcept ->
 	std::enable_if_t<
 		!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	using std::begin;
@@ -778,6 +1430,119 @@ constexpr auto calculate_raw(T init, const U(&range)[N]) noexcept ->
 	return calculate_raw<32>(init, range, poly);
 }
 
+// calculate_normal_raw ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Non-reflected CRCs differ in their initial and final values more than
+// reflected ones, so there is no calculate_normal that assumes them:
+// pass the initial value as `init`, and apply any final XOR to the
+// result. For example, CRC-32/MPEG-2 is:
+// 
+//     calculate_normal_raw<32>(std::uint_fast32_t{0xFFFFFFFFu}, data,
+//         polynomials::crc32)
+// 
+// and CRC-16/XMODEM is:
+// 
+//     calculate_normal_raw<16>(std::uint_fast16_t{0u}, data,
+//         polynomials::crc16_ccitt)
+// 
+// calculate_normal_raw<Bits>(T init, InIt first, Sen last, T poly)
+// calculate_normal_raw<Bits>(T init, InIt first, Sen last, Table const& t)
+// calculate_normal_raw<Bits>(T init, InIt first, Sen last, Engine const& e)
+// calculate_normal_raw<Bits>(T init, Range const& r, T poly)
+// calculate_normal_raw<Bits>(T init, Range const& r, Table const& t)
+// calculate_normal_raw<Bits>(T init, Range const& r, Engine const& e)
+
+template <std::size_t Bits, typename T, typename InputIterator,
+	typename Sentinel, typename Table>
+constexpr auto calculate_normal_raw(T init, InputIterator first,
+		Sentinel last, Table const& table) noexcept ->
+	std::enable_if_t<
+		detail_::is_input_iterator<InputIterator>::value &&
+			!std::is_integral<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
+		T>
+{
+	auto calculator = [&table](auto last, auto b)
+		{ return calculate_next_normal<Bits>(last, b, table); };
+	return std::accumulate(first, last, init, calculator);
+}
+
+template <std::size_t Bits, typename T, typename InputIterator,
+	typename Sentinel>
+constexpr auto calculate_normal_raw(T init, InputIterator first,
+		Sentinel last, T poly) noexcept ->
+	std::enable_if_t<
+		detail_::is_input_iterator<InputIterator>::value &&
+			std::is_integral<T>::value,
+		T>
+{
+	auto const table = generate_normal_table<Bits>(poly);
+	return calculate_normal_raw<Bits>(init, first, last, table);
+}
+
+template <std::size_t Bits, typename T, typename InputIterator,
+	typename Sentinel, typename Engine>
+auto calculate_normal_raw(T init, InputIterator first, Sentinel last,
+		Engine const& engine) noexcept ->
+	std::enable_if_t<
+		detail_::is_input_iterator<InputIterator>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		T>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(!Engine::reflected,
+		"engine calculates reflected CRCs (use calculate_raw)");
+	
+	using is_contiguous = std::integral_constant<bool,
+		std::is_same<InputIterator, Sentinel>::value &&
+			detail_::is_byte_pointer<InputIterator>::value>;
+	return detail_::engine_update(init, first, last, engine,
+		is_contiguous{});
+}
+
+template <std::size_t Bits, typename T, typename Range, typename Table>
+constexpr auto calculate_normal_raw(T init, Range const& range,
+		Table const& table) noexcept ->
+	std::enable_if_t<
+		!detail_::is_input_iterator<Range>::value &&
+			!detail_::is_crc_engine<Table>::value,
+		T>
+{
+	using std::begin;
+	using std::end;
+	return calculate_normal_raw<Bits>(init, begin(range), end(range),
+		table);
+}
+
+template <std::size_t Bits, typename T, typename Range, typename Engine>
+auto calculate_normal_raw(T init, Range const& range,
+		Engine const& engine) noexcept ->
+	std::enable_if_t<
+		!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value &&
+			detail_::is_contiguous_byte_range<Range>::value,
+		T>
+{
+	return calculate_normal_raw<Bits>(init, range.data(),
+		range.data() + range.size(), engine);
+}
+
+template <std::size_t Bits, typename T, typename Range, typename Engine>
+auto calculate_normal_raw(T init, Range const& range,
+		Engine const& engine) noexcept ->
+	std::enable_if_t<
+		!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value &&
+			!detail_::is_contiguous_byte_range<Range>::value,
+		T>
+{
+	using std::begin;
+	using std::end;
+	return calculate_normal_raw<Bits>(init, begin(range), end(range),
+		engine);
+}
+
 // calculate ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 // calculate<Bits>(InIt first, Sen last, T poly)
@@ -790,6 +1555,8 @@ constexpr auto calculate_raw(T init, const U(&range)[N]) noexcept ->
 // calculate<Bits>(Range const& r, Table const& table)
 // calculate<16>(Range const& r)
 // calculate<32>(Range const& r)
+// calculate<Bits>(InIt first, Sen last, Engine const& e)
+// calculate<Bits>(Range const& r, Engine const& e)
 
 template <std::size_t Bits, typename InputIterator, typename Sentinel,
 	typename RandomAccessIterator, typename T = crc_type_t<Bits>>
@@ -811,7 +1578,8 @@ constexpr auto calculate(InputIterator first, Sentinel last,
 		Table const& table) ->
 	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
 			!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	using std::begin;
@@ -842,6 +1610,30 @@ constexpr auto calculate(InputIterator first, Sentinel last, T poly) ->
 	return ones ^ calculate_raw<Bits>(ones, first, last, poly);
 }
 
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename Engine>
+auto calculate(InputIterator first, Sentinel last, Engine const& engine)
+		->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		typename Engine::crc_type>
+{
+	using T = typename Engine::crc_type;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return T(ones ^ calculate_raw<Bits>(ones, first, last, engine));
+}
+
+template <std::size_t Bits, typename Range, typename Engine>
+auto calculate(Range const& range, Engine const& engine) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		typename Engine::crc_type>
+{
+	using T = typename Engine::crc_type;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	return T(ones ^ calculate_raw<Bits>(ones, range, engine));
+}
+
 template <std::size_t Bits, typename InputIterator, typename Sentinel,
 	typename T = crc_type_t<Bits>>
 constexpr auto calculate(InputIterator first, Sentinel last) ->
@@ -901,7 +1693,8 @@ constexpr auto calculate(Range const& range,
 		Table const& table) ->
 	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
 			!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	using std::begin;
@@ -915,7 +1708,8 @@ template <std::size_t Bits, typename U, std::size_t N, typename Table,
 constexpr auto calculate(U const(&range)[N],
 		Table const& table) ->
 	std::enable_if_t<!std::is_integral<Table>::value &&
-			!detail_::is_random_access_iterator<Table>::value,
+			!detail_::is_random_access_iterator<Table>::value &&
+			!detail_::is_crc_engine<Table>::value,
 		T>
 {
 	using std::begin;
@@ -1013,6 +1807,407 @@ constexpr auto calculate(const U(&range)[N]) ->
 	return calculate<Bits>(begin(range), end(range));
 }
 
+// verify ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// verify<Bits>(InIt first, Sen last, T poly)
+// verify<Bits>(InIt first, Sen last, T poly, Engine const& e)
+// verify<Bits>(Range const& r, T poly)
+// verify<Bits>(Range const& r, T poly, Engine const& e)
+
+//! Verifies a frame that ends with its CRC.
+//! 
+//! The frame is a message followed by its CRC, as returned by
+//! `calculate`, least significant byte first. Rather than calculating
+//! the CRC of the message and comparing it with the one at the end,
+//! this calculates the CRC of the whole frame, in one pass, and checks
+//! it against the `residue`.
+//! 
+//! \requires `Bits` must be a multiple of 8, and the frame at least
+//!           `Bits / 8` bytes long.
+//! 
+//! \tparam Bits  The CRC bit-size.
+//! 
+//! \param first  The start of the frame.
+//! \param last  The end of the frame.
+//! \param poly  The encoded polynomial value.
+//! 
+//! \returns `true` if the CRC at the end of the frame matches.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename T>
+constexpr auto verify(InputIterator first, Sentinel last, T poly) ->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			std::is_integral<T>::value,
+		bool>
+{
+	return calculate<Bits>(first, last, poly) == residue<Bits>(poly);
+}
+
+//! Verifies a frame that ends with its CRC, using an engine.
+//! 
+//! This is the same as the other `verify`, but calculates the CRC with
+//! the engine, which must be for the same polynomial.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename T, typename Engine>
+auto verify(InputIterator first, Sentinel last, T poly,
+		Engine const& engine) ->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			std::is_integral<T>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		bool>
+{
+	using R = typename Engine::crc_type;
+	return calculate<Bits>(first, last, engine) ==
+		R(residue<Bits>(poly));
+}
+
+template <std::size_t Bits, typename Range, typename T>
+constexpr auto verify(Range const& range, T poly) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			std::is_integral<T>::value,
+		bool>
+{
+	using std::begin;
+	using std::end;
+	return verify<Bits>(begin(range), end(range), poly);
+}
+
+template <std::size_t Bits, typename Range, typename T, typename Engine>
+auto verify(Range const& range, T poly, Engine const& engine) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			std::is_integral<T>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		bool>
+{
+	using R = typename Engine::crc_type;
+	return calculate<Bits>(range, engine) == R(residue<Bits>(poly));
+}
+
+// calculate_batch ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// calculate_batch<Bits>(InIt first, Sen last, OutIt out, Engine const& e)
+// calculate_batch<Bits>(Range const& r, OutIt out, Engine const& e)
+
+namespace detail_ {
+
+// Engines that can work on several messages at once get them in
+// batches, when the messages are contiguous bytes that stay put.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename OutputIterator, typename Engine>
+auto batch_update(InputIterator first, Sentinel last, OutputIterator out,
+	Engine const& engine, std::true_type)
+{
+	using T = typename Engine::crc_type;
+	constexpr auto ones = detail_::ones<Bits, T>();
+	constexpr auto batch = std::size_t{256u};
+	
+	unsigned char const* messages[batch];
+	std::size_t lengths[batch];
+	T crcs[batch];
+	
+	while (first != last)
+	{
+		auto count = std::size_t{0};
+		for (; count < batch && first != last; ++count, ++first)
+		{
+			auto const& message = *first;
+			messages[count] = reinterpret_cast<unsigned char const*>(
+				message.data());
+			lengths[count] = message.size();
+		}
+		
+		engine.update_batch(ones, messages, lengths, count, crcs);
+		
+		for (auto n = std::size_t{0}; n < count; ++n)
+			*out++ = T(ones ^ crcs[n]);
+	}
+	
+	return out;
+}
+
+// Anything else is done a message at a time.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename OutputIterator, typename Engine>
+auto batch_update(InputIterator first, Sentinel last, OutputIterator out,
+	Engine const& engine, std::false_type)
+{
+	for (; first != last; ++first)
+		*out++ = calculate<Bits>(*first, engine);
+	
+	return out;
+}
+
+} // namespace detail_
+
+//! Calculates the CRCs of several messages.
+//! 
+//! Each message is a range of bytes, as for `calculate`. The CRCs are
+//! the same as `calculate` gives for each message, but when the
+//! messages are contiguous, and the engine can work on several
+//! messages at once (like `clmul_engine`), they are handed to it in
+//! batches, which is faster for messages of a few KiB.
+//! 
+//! \param first  The first message.
+//! \param last  The end of the messages.
+//! \param out  Where to write the CRC of each message.
+//! \param engine  The CRC engine.
+//! 
+//! \returns `out`, after the last CRC.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename OutputIterator, typename Engine>
+auto calculate_batch(InputIterator first, Sentinel last,
+		OutputIterator out, Engine const& engine) ->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		OutputIterator>
+{
+	static_assert(Engine::bits == Bits,
+		"engine bit-size does not match");
+	static_assert(Engine::reflected,
+		"engine calculates non-reflected CRCs");
+	
+	using message = typename std::iterator_traits<InputIterator>::
+		reference;
+	using is_batch = std::integral_constant<bool,
+		detail_::has_update_batch<Engine>::value &&
+			std::is_lvalue_reference<message>::value &&
+			detail_::is_contiguous_byte_range<
+				std::remove_reference_t<message>>::value>;
+	return detail_::batch_update<Bits>(first, last, out, engine,
+		is_batch{});
+}
+
+template <std::size_t Bits, typename Range, typename OutputIterator,
+	typename Engine>
+auto calculate_batch(Range const& range, OutputIterator out,
+		Engine const& engine) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		OutputIterator>
+{
+	using std::begin;
+	using std::end;
+	return calculate_batch<Bits>(begin(range), end(range), out, engine);
+}
+
+// verify_batch ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// verify_batch<Bits>(InIt first, Sen last, OutIt out, T poly,
+//         Engine const& e)
+// verify_batch<Bits>(Range const& r, OutIt out, T poly, Engine const& e)
+
+namespace detail_ {
+
+// Takes the CRCs `calculate_batch` writes, and writes whether each one
+// is the residue instead.
+template <typename OutputIterator, typename T>
+struct residue_check_iterator
+{
+	OutputIterator out;
+	T residue;
+	
+	auto operator*() noexcept -> residue_check_iterator& { return *this; }
+	auto operator++() noexcept -> residue_check_iterator& { return *this; }
+	auto operator++(int) noexcept -> residue_check_iterator&
+		{ return *this; }
+	
+	auto operator=(T crc) -> residue_check_iterator&
+	{
+		*out++ = crc == residue;
+		return *this;
+	}
+};
+
+} // namespace detail_
+
+//! Verifies several frames that end with their CRCs.
+//! 
+//! Each frame is a range of bytes, as for `verify`, and the results are
+//! the same as `verify` gives for each frame, but the frames are handed
+//! to the engine as for `calculate_batch`.
+//! 
+//! \param first  The first frame.
+//! \param last  The end of the frames.
+//! \param out  Where to write whether each frame's CRC matches, as a
+//!     `bool`.
+//! \param poly  The encoded polynomial value.
+//! \param engine  The CRC engine, for the same polynomial.
+//! 
+//! \returns `out`, after the last result.
+template <std::size_t Bits, typename InputIterator, typename Sentinel,
+	typename OutputIterator, typename T, typename Engine>
+auto verify_batch(InputIterator first, Sentinel last,
+		OutputIterator out, T poly, Engine const& engine) ->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			std::is_integral<T>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		OutputIterator>
+{
+	using R = typename Engine::crc_type;
+	auto checks = detail_::residue_check_iterator<OutputIterator, R>{
+		out, R(residue<Bits>(poly))};
+	return calculate_batch<Bits>(first, last, checks, engine).out;
+}
+
+template <std::size_t Bits, typename Range, typename OutputIterator,
+	typename T, typename Engine>
+auto verify_batch(Range const& range, OutputIterator out, T poly,
+		Engine const& engine) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			std::is_integral<T>::value &&
+			detail_::is_crc_engine<Engine>::value,
+		OutputIterator>
+{
+	using std::begin;
+	using std::end;
+	return verify_batch<Bits>(begin(range), end(range), out, poly,
+		engine);
+}
+
+// calculate_multi ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// calculate_multi(InIt first, Sen last, Engines const&... e)
+// calculate_multi(Range const& r, Engines const&... e)
+
+namespace detail_ {
+
+// The input is worked on a block at a time (see `cache_block`), and
+// every engine gets a block before the next one is read, so it is
+// still in the L1 cache for all but the first.
+
+template <typename Crcs, typename Engines, std::size_t... I>
+auto multi_update_block(Crcs& crcs, unsigned char const* first,
+	unsigned char const* last, Engines const& engines,
+	std::index_sequence<I...>) noexcept -> void
+{
+	using expand = int[];
+	(void)expand{0, (std::get<I>(crcs) =
+		typename std::tuple_element<I, Crcs>::type(
+			std::get<I>(engines).update(std::get<I>(crcs), first, last)),
+		0)...};
+}
+
+// Contiguous bytes go straight to the engines.
+template <typename Crcs, typename InputIterator, typename Sentinel,
+	typename Engines, typename Indices>
+auto multi_update(Crcs& crcs, InputIterator first, Sentinel last,
+	Engines const& engines, Indices indices, std::true_type) noexcept
+	-> void
+{
+	auto p = reinterpret_cast<unsigned char const*>(first);
+	auto const end = reinterpret_cast<unsigned char const*>(last);
+	
+	while (p != end)
+	{
+		auto const size = static_cast<std::size_t>(end - p);
+		auto const next = p + (size < cache_block ? size : cache_block);
+		multi_update_block(crcs, p, next, engines, indices);
+		p = next;
+	}
+}
+
+// Anything else is copied to a buffer a block at a time.
+template <typename Crcs, typename InputIterator, typename Sentinel,
+	typename Engines, typename Indices>
+auto multi_update(Crcs& crcs, InputIterator first, Sentinel last,
+	Engines const& engines, Indices indices, std::false_type) noexcept
+	-> void
+{
+	unsigned char buffer[cache_block];
+	
+	while (first != last)
+	{
+		auto size = std::size_t{0};
+		for (; size < sizeof(buffer) && first != last; ++size, ++first)
+			buffer[size] = static_cast<unsigned char>(*first);
+		
+		multi_update_block(crcs, buffer, buffer + size, engines, indices);
+	}
+}
+
+template <typename... Engines, std::size_t... I>
+auto multi_finish(std::tuple<typename Engines::crc_type...> const& crcs,
+	std::index_sequence<I...>) noexcept
+{
+	return std::make_tuple(typename Engines::crc_type(
+		ones<Engines::bits, typename Engines::crc_type>() ^
+			std::get<I>(crcs))...);
+}
+
+} // namespace detail_
+
+//! Calculates several CRCs of a sequence at once.
+//! 
+//! This gives the same CRCs as calling `calculate` with each engine in
+//! turn, but reads the sequence only once, which is faster when it is
+//! too large for the caches. The sequence is worked on in small blocks,
+//! and each engine gets a block while it is still in the L1 cache. For
+//! example:
+//! 
+//!     auto const crc32 = indi::crc::clmul_engine<32>{
+//!         indi::crc::polynomials::crc32};
+//!     auto const crc32c = indi::crc::clmul_engine<32>{
+//!         indi::crc::polynomials::crc32c};
+//!     auto const crc64 = indi::crc::clmul_engine<64>{
+//!         indi::crc::polynomials::crc64_ecma};
+//!     auto const crcs = indi::crc::calculate_multi(data, crc32,
+//!         crc32c, crc64);
+//!     // std::get<0>(crcs) is the CRC-32, and so on.
+//! 
+//! \param first  The start of the sequence.
+//! \param last  The end of the sequence.
+//! \param engines  The CRC engines (all reflected), one for each CRC.
+//! 
+//! \returns A tuple of the CRCs, in the same order as the engines.
+template <typename InputIterator, typename Sentinel, typename... Engines>
+auto calculate_multi(InputIterator first, Sentinel last,
+		Engines const&... engines) ->
+	std::enable_if_t<detail_::is_input_iterator<InputIterator>::value &&
+			detail_::are_crc_engines<Engines...>::value,
+		std::tuple<typename Engines::crc_type...>>
+{
+	static_assert(std::is_same<
+			std::integer_sequence<bool, Engines::reflected...>,
+			std::integer_sequence<bool, (true || Engines::reflected)...>>::
+				value,
+		"engine calculates non-reflected CRCs");
+	
+	auto crcs = std::make_tuple(typename Engines::crc_type(
+		detail_::ones<Engines::bits, typename Engines::crc_type>())...);
+	auto const all = std::tuple<Engines const&...>(engines...);
+	auto const indices = std::index_sequence_for<Engines...>{};
+	
+	using is_contiguous = std::integral_constant<bool,
+		std::is_same<InputIterator, Sentinel>::value &&
+			detail_::is_byte_pointer<InputIterator>::value>;
+	detail_::multi_update(crcs, first, last, all, indices,
+		is_contiguous{});
+	
+	return detail_::multi_finish<Engines...>(crcs, indices);
+}
+
+template <typename Range, typename... Engines>
+auto calculate_multi(Range const& range, Engines const&... engines) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			detail_::are_crc_engines<Engines...>::value &&
+			detail_::is_contiguous_byte_range<Range>::value,
+		std::tuple<typename Engines::crc_type...>>
+{
+	return calculate_multi(range.data(), range.data() + range.size(),
+		engines...);
+}
+
+template <typename Range, typename... Engines>
+auto calculate_multi(Range const& range, Engines const&... engines) ->
+	std::enable_if_t<!detail_::is_input_iterator<Range>::value &&
+			detail_::are_crc_engines<Engines...>::value &&
+			!detail_::is_contiguous_byte_range<Range>::value,
+		std::tuple<typename Engines::crc_type...>>
+{
+	using std::begin;
+	using std::end;
+	return calculate_multi(begin(range), end(range), engines...);
+}
+
 } // namespace crc
 } // namespace indi
 
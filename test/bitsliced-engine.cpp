@@ -0,0 +1,129 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-bitslice.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Checks both kinds of engine against 256-element tables, for message
+// lengths up to a few words, with numbers of messages that fill groups
+// exactly and that don't. The messages overlap, and start at every
+// alignment.
+template <std::size_t Bits, indi::crc::crc_type_t<Bits> Polynomial>
+auto check_engines()
+{
+	using T = indi::crc::crc_type_t<Bits>;
+	
+	auto const data = random_bytes(2000u);
+	auto const table = indi::crc::generate_table<Bits>(Polynomial);
+	auto const normal_table = indi::crc::generate_normal_table<Bits>(
+		Polynomial);
+	auto const mask = indi::crc::detail_::ones<Bits, T>();
+	
+	auto const reflected = indi::crc::bitsliced_engine<Bits, Polynomial>{};
+	auto const normal = indi::crc::normal_bitsliced_engine<Bits,
+		Polynomial>{};
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto count : {1u, 63u, 64u, 65u, 256u, 300u})
+	{
+		for (auto length = std::size_t{0}; length <= 20u; ++length)
+		{
+			auto const init = static_cast<T>(random() & mask);
+			
+			auto messages = std::vector<unsigned char const*>(count);
+			for (auto n = std::size_t{0}; n < count; ++n)
+				messages[n] = data.data() + 3u * n;
+			
+			auto crcs = std::vector<T>(count);
+			auto normal_crcs = std::vector<T>(count);
+			reflected.update(init, messages.data(), count, length,
+				crcs.data());
+			normal.update(init, messages.data(), count, length,
+				normal_crcs.data());
+			
+			for (auto n = std::size_t{0}; n < count; ++n)
+			{
+				auto const first = messages[n];
+				auto const last = first + length;
+				
+				if (crcs[n] != indi::crc::calculate_raw<Bits>(init, first,
+						last, table) ||
+					normal_crcs[n] != indi::crc::calculate_normal_raw<Bits>(
+						init, first, last, normal_table))
+				{
+					BOOST_ERROR("Bits " << Bits << ", count " << count <<
+						", length " << length << ", message " << n);
+					return;
+				}
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(bitsliced_engine_suite)
+
+BOOST_AUTO_TEST_CASE(bitsliced_engine_values)
+{
+	check_engines<3, 0x3u>();
+	check_engines<5, 0x09u>();
+	check_engines<8, 0x07u>();
+	check_engines<12, 0x80Fu>();
+	check_engines<16, polys::crc16_ccitt>();
+	check_engines<16, polys::crc16_ibm>();
+	check_engines<24, 0x864CFBu>();
+	check_engines<32, polys::crc32>();
+	check_engines<32, polys::crc32c>();
+}
+
+BOOST_AUTO_TEST_CASE(bitsliced_engine_check)
+{
+	unsigned char const check[] = {
+		'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	unsigned char const* const messages[] = {check, check, check};
+	
+	std::uint_fast16_t modbus[3];
+	indi::crc::bitsliced_engine<16, polys::crc16_ibm>{}.update(0xFFFFu,
+		messages, 3u, 9u, modbus);
+	for (auto const crc : modbus)
+		BOOST_CHECK_EQUAL(crc, 0x4B37u);
+	
+	std::uint_fast32_t crc32[3];
+	indi::crc::bitsliced_engine<32, polys::crc32>{}.update(0xFFFFFFFFu,
+		messages, 3u, 9u, crc32);
+	for (auto const crc : crc32)
+		BOOST_CHECK_EQUAL(crc ^ 0xFFFFFFFFu, 0xCBF43926u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-braid.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Checks both kinds of engine against 256-element tables, over every
+// length up to a few blocks, plus some larger ones, at a few
+// alignments, with random initial values.
+template <std::size_t Bits, std::size_t Braids, typename T>
+auto check_engines(T polynomial)
+{
+	auto const data = random_bytes(5000u);
+	auto const table = indi::crc::generate_table<Bits>(polynomial);
+	auto const normal_table = indi::crc::generate_normal_table<Bits>(
+		polynomial);
+	auto const mask = indi::crc::detail_::ones<Bits, T>();
+	
+	auto const reflected = indi::crc::braided_engine<Bits, T, Braids>{
+		polynomial};
+	auto const normal = indi::crc::normal_braided_engine<Bits, T,
+		Braids>{polynomial};
+	
+	auto lengths = std::vector<std::size_t>{};
+	for (auto length = std::size_t{0}; length <= 24u * Braids; ++length)
+		lengths.push_back(length);
+	for (auto length : {1000u, 4093u})
+		lengths.push_back(length);
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto offset = std::size_t{0}; offset < 3u; ++offset)
+	{
+		for (auto length : lengths)
+		{
+			auto const init = static_cast<T>(random() & mask);
+			auto const first = data.data() + offset;
+			auto const last = first + length;
+			
+			if (reflected.update(init, first, last) !=
+					indi::crc::calculate_raw<Bits>(init, first, last, table) ||
+				normal.update(init, first, last) !=
+					indi::crc::calculate_normal_raw<Bits>(init, first, last,
+						normal_table))
+			{
+				BOOST_ERROR("Bits " << Bits << ", braids " << Braids <<
+					", offset " << offset << ", length " << length);
+				return;
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(braided_engine_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, std::size_t Braids = 5, typename T>
+//     constexpr auto generate_braid_tables<Bits, Braids>(
+//             T polynomial) noexcept ->
+//         std::array<std::array<T, 256>, 8>
+//     template <std::size_t Bits, std::size_t Braids = 5, typename T>
+//     constexpr auto generate_normal_braid_tables<Bits, Braids>(
+//             T polynomial) noexcept ->
+//         std::array<std::array<T, 256>, 8>
+BOOST_AUTO_TEST_CASE(generate_braid_tables_values)
+{
+	BOOST_CHECK((std::is_same<
+		std::array<std::array<std::uint_fast32_t, 256>, 8>,
+		decltype(indi::crc::generate_braid_tables<32>(polys::crc32))>::
+			value));
+	
+	// With one braid, the last byte of a word isn't carried any
+	// further, so the last table is the plain lookup table.
+	BOOST_CHECK((indi::crc::generate_braid_tables<32, 1>(polys::crc32)[7] ==
+		indi::crc::generate_table<32>(polys::crc32)));
+	BOOST_CHECK((indi::crc::generate_normal_braid_tables<16, 1>(
+		polys::crc16_ccitt)[7] ==
+		indi::crc::generate_normal_table<16>(polys::crc16_ccitt)));
+	BOOST_CHECK((indi::crc::generate_braid_tables<64, 1>(
+		polys::crc64_ecma)[7] ==
+		indi::crc::generate_table<64>(polys::crc64_ecma)));
+}
+
+BOOST_AUTO_TEST_CASE(braided_engine_values)
+{
+	check_engines<3, 5>(std::uint_fast8_t{0x3u});
+	check_engines<5, 5>(std::uint_fast8_t{0x09u});
+	check_engines<8, 5>(std::uint_fast8_t{0x07u});
+	check_engines<12, 5>(std::uint_fast16_t{0x80Fu});
+	check_engines<16, 5>(polys::crc16_ccitt);
+	check_engines<16, 5>(polys::crc16_ibm);
+	check_engines<24, 5>(std::uint_fast32_t{0x864CFBu});
+	check_engines<32, 5>(polys::crc32);
+	check_engines<32, 5>(polys::crc32c);
+	check_engines<64, 5>(polys::crc64_ecma);
+	check_engines<64, 5>(polys::crc64_iso);
+	
+	check_engines<32, 1>(polys::crc32);
+	check_engines<32, 3>(polys::crc32);
+	check_engines<32, 8>(polys::crc32);
+	check_engines<64, 4>(polys::crc64_ecma);
+}
+
+BOOST_AUTO_TEST_CASE(braided_engine_calculate)
+{
+	auto const engine = indi::crc::braided_engine<32>{polys::crc32};
+	auto const check = std::string{"123456789"};
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(check, engine),
+		0xCBF43926u);
+	
+	auto const data = random_bytes(1000u);
+	auto const list = std::list<unsigned char>(data.begin(), data.end());
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(list, engine),
+		indi::crc::calculate<32>(data, polys::crc32));
+	
+	auto const mpeg2 = indi::crc::normal_braided_engine<32>{polys::crc32};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<32>(
+		std::uint_fast32_t{0xFFFFFFFFu}, check, mpeg2), 0x0376E6E7u);
+}
+
+#if __cplusplus >= 201703L
+// From C++17, std::array can be filled in at compile time, and so can
+// the engine.
+BOOST_AUTO_TEST_CASE(braided_engine_constexpr)
+{
+	static constexpr auto engine = indi::crc::braided_engine<32,
+		std::uint32_t>{polys::crc32};
+	static constexpr unsigned char check[] = {
+		'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	
+	static_assert((engine.update(0xFFFFFFFFu, check, check + 9) ^
+		0xFFFFFFFFu) == 0xCBF43926u, "");
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,232 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-async.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "indi/crc-braid.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// A minimal event loop: a queue of coroutines to resume.
+struct event_loop
+{
+	std::deque<std::coroutine_handle<>> ready;
+	std::size_t steps = 0u;
+	
+	// What a task awaits between steps: goes to the back of the queue.
+	auto yield()
+	{
+		struct awaiter
+		{
+			event_loop* loop;
+			
+			auto await_ready() noexcept { return false; }
+			auto await_suspend(std::coroutine_handle<> h)
+				{ loop->ready.push_back(h); }
+			auto await_resume() noexcept -> void {}
+		};
+		return awaiter{this};
+	}
+	
+	auto run() -> void
+	{
+		while (!ready.empty())
+		{
+			auto const next = ready.front();
+			ready.pop_front();
+			++steps;
+			next.resume();
+		}
+	}
+};
+
+// A coroutine on the event loop, which awaits a CRC task.
+struct request
+{
+	struct promise_type
+	{
+		auto get_return_object() noexcept { return request{}; }
+		auto initial_suspend() noexcept { return std::suspend_never{}; }
+		auto final_suspend() noexcept { return std::suspend_never{}; }
+		auto return_void() noexcept -> void {}
+		auto unhandled_exception() noexcept -> void { std::terminate(); }
+	};
+};
+
+auto checksum(indi::crc::crc_task<std::uint_fast32_t>& task,
+	std::optional<std::uint_fast32_t>& out) -> request
+{
+	out = co_await task;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_async_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T, typename Engine,
+//         typename Yield>
+//     auto async_calculate_raw<Bits>(T init, void const* data,
+//             std::size_t size, Engine const& engine,
+//             async_options options = {}, Yield yield = {}) ->
+//         crc_task<T>
+//     template <std::size_t Bits, typename Engine, typename Yield>
+//     auto async_calculate<Bits>(void const* data, std::size_t size,
+//             Engine const& engine, async_options options = {},
+//             Yield yield = {}) ->
+//         crc_task<typename Engine::crc_type>
+//     template <std::size_t Bits, typename Range, typename Engine,
+//         typename Yield>
+//     auto async_calculate<Bits>(Range const& range,
+//             Engine const& engine, async_options options = {},
+//             Yield yield = {}) ->
+//         crc_task<typename Engine::crc_type>
+BOOST_AUTO_TEST_CASE(async_calculate_signature)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const data = std::string{"123456789"};
+	
+	BOOST_CHECK((std::is_same<indi::crc::crc_task<std::uint_fast32_t>,
+		decltype(indi::crc::async_calculate_raw<32>(
+			std::uint_fast32_t{0u}, data.data(), data.size(),
+			engine))>::value));
+	BOOST_CHECK((std::is_same<indi::crc::crc_task<std::uint_fast32_t>,
+		decltype(indi::crc::async_calculate<32>(data.data(), data.size(),
+			engine))>::value));
+	BOOST_CHECK((std::is_same<indi::crc::crc_task<std::uint_fast32_t>,
+		decltype(indi::crc::async_calculate<32>(data, engine))>::value));
+}
+
+BOOST_AUTO_TEST_CASE(async_calculate_check_values)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const data = std::string{"123456789"};
+	
+	auto task = indi::crc::async_calculate<32>(data, engine);
+	BOOST_CHECK(!task.done());
+	BOOST_CHECK(!task.resume());
+	BOOST_CHECK(task.done());
+	BOOST_CHECK(task.result() == std::uint_fast32_t{0xCBF43926u});
+	
+	auto raw = indi::crc::async_calculate_raw<32>(std::uint_fast32_t{0u},
+		data.data(), data.size(), engine);
+	while (raw.resume())
+		;
+	BOOST_CHECK(raw.result() == indi::crc::calculate_raw<32>(
+		std::uint_fast32_t{0u}, data, engine));
+}
+
+// Each step does no more than the budget.
+BOOST_AUTO_TEST_CASE(async_calculate_steps)
+{
+	auto const engine = indi::crc::braided_engine<64>{polys::crc64_ecma};
+	auto const data = random_bytes(100000u);
+	
+	for (auto const budget : {std::size_t{1000u}, std::size_t{4096u},
+		std::size_t{99999u}, std::size_t{100000u}, std::size_t{0u}})
+	{
+		auto task = indi::crc::async_calculate<64>(data, engine,
+			{.budget = budget});
+		BOOST_CHECK_EQUAL(task.processed(), 0u);
+		
+		auto steps = std::size_t{0};
+		auto processed = std::size_t{0};
+		while (!task.done())
+		{
+			task.resume();
+			++steps;
+			BOOST_CHECK(budget == 0u ||
+				task.processed() - processed <= budget);
+			processed = task.processed();
+		}
+		
+		auto const expected_steps = budget == 0u ? 1u :
+			(data.size() + budget - 1u) / budget;
+		BOOST_CHECK_EQUAL(steps, expected_steps);
+		BOOST_CHECK_EQUAL(task.processed(), data.size());
+		BOOST_CHECK_EQUAL(task.size(), data.size());
+		BOOST_CHECK(task.result() ==
+			indi::crc::calculate<64>(data, engine));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(async_calculate_stop)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const data = random_bytes(100000u);
+	auto source = std::stop_source{};
+	
+	auto task = indi::crc::async_calculate<32>(data, engine,
+		{.budget = 1000u, .stop = source.get_token()});
+	for (auto step = 0; step < 10; ++step)
+		task.resume();
+	source.request_stop();
+	task.resume();
+	
+	BOOST_CHECK(task.done());
+	BOOST_CHECK_EQUAL(task.processed(), 10000u);
+	BOOST_CHECK(!task.result());
+}
+
+// Two tasks awaited from coroutines on an event loop take turns.
+BOOST_AUTO_TEST_CASE(async_calculate_event_loop)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const data = random_bytes(50000u);
+	auto loop = event_loop{};
+	auto const yield = [&loop] { return loop.yield(); };
+	
+	auto first = indi::crc::async_calculate<32>(data, engine,
+		{.budget = 5000u}, yield);
+	auto second = indi::crc::async_calculate<32>(data.data(), 20000u,
+		engine, {.budget = 5000u}, yield);
+	auto first_crc = std::optional<std::uint_fast32_t>{};
+	auto second_crc = std::optional<std::uint_fast32_t>{};
+	checksum(first, first_crc);
+	checksum(second, second_crc);
+	
+	BOOST_CHECK_EQUAL(first.processed(), 5000u);
+	BOOST_CHECK_EQUAL(second.processed(), 5000u);
+	loop.run();
+	
+	BOOST_CHECK_EQUAL(loop.steps, 9u + 3u);
+	BOOST_CHECK(first_crc == indi::crc::calculate<32>(data, engine));
+	BOOST_CHECK(second_crc == indi::crc::calculate<32>(data.data(),
+		data.data() + 20000u, engine));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
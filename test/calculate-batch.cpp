@@ -0,0 +1,210 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-simd.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::clmul_kernel;
+
+clmul_kernel const kernels[] = {
+	clmul_kernel::table,
+	clmul_kernel::pclmul,
+	clmul_kernel::vpclmul,
+	clmul_kernel::automatic
+};
+
+// Messages of every length up to a few hundred bytes, and from 1 KiB
+// to a few hundred bytes past it (which the 512-bit kernel works on
+// together), and some longer ones, shuffled, so that messages of very
+// different lengths end up side by side.
+auto random_messages()
+{
+	auto engine = std::mt19937{13579u};
+	
+	auto lengths = std::vector<std::size_t>{};
+	for (auto length = std::size_t{0}; length <= 300u; ++length)
+		lengths.push_back(length);
+	for (auto length = std::size_t{1024u}; length <= 1324u; ++length)
+		lengths.push_back(length);
+	for (auto length : {1000u, 4095u, 4096u, 5000u})
+		lengths.push_back(length);
+	std::shuffle(lengths.begin(), lengths.end(), engine);
+	
+	auto messages = std::vector<std::vector<unsigned char>>{};
+	for (auto length : lengths)
+		messages.push_back(indi::crc::test::random_bytes(length, engine()));
+	
+	return messages;
+}
+
+// Checks `update_batch` against `update`, for every kernel.
+template <std::size_t Bits, bool Reflected, typename T>
+auto check_update_batch(T polynomial)
+{
+	auto const messages = random_messages();
+	
+	auto firsts = std::vector<unsigned char const*>{};
+	auto lengths = std::vector<std::size_t>{};
+	for (auto const& message : messages)
+	{
+		firsts.push_back(message.data());
+		lengths.push_back(message.size());
+	}
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto kernel : kernels)
+	{
+		auto const engine = indi::crc::basic_clmul_engine<Bits, T,
+			Reflected>{polynomial, kernel};
+		auto const init = static_cast<T>(random() &
+			indi::crc::detail_::ones<Bits, T>());
+		
+		auto crcs = std::vector<T>(messages.size());
+		engine.update_batch(init, firsts.data(), lengths.data(),
+			messages.size(), crcs.data());
+		
+		for (auto n = std::size_t{0}; n < messages.size(); ++n)
+		{
+			if (crcs[n] != engine.update(init, firsts[n],
+					firsts[n] + lengths[n]))
+			{
+				BOOST_ERROR("Bits " << Bits << ", reflected " << Reflected <<
+					", kernel " << static_cast<int>(kernel) <<
+					", length " << lengths[n]);
+				return;
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_batch_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename InputIterator,
+//         typename Sentinel, typename OutputIterator, typename Engine>
+//     auto calculate_batch<Bits>(InputIterator first, Sentinel last,
+//             OutputIterator out, Engine const& engine) ->
+//         OutputIterator
+//     template <std::size_t Bits, typename Range,
+//         typename OutputIterator, typename Engine>
+//     auto calculate_batch<Bits>(Range const& range,
+//             OutputIterator out, Engine const& engine) ->
+//         OutputIterator
+BOOST_AUTO_TEST_CASE(calculate_batch_values)
+{
+	auto const messages = random_messages();
+	
+	for (auto kernel : kernels)
+	{
+		auto const engine = indi::crc::clmul_engine<32>{polys::crc32c,
+			kernel};
+		
+		auto crcs = std::vector<std::uint_fast32_t>{};
+		indi::crc::calculate_batch<32>(messages, std::back_inserter(crcs),
+			engine);
+		
+		BOOST_REQUIRE_EQUAL(crcs.size(), messages.size());
+		for (auto n = std::size_t{0}; n < messages.size(); ++n)
+			BOOST_CHECK_EQUAL(crcs[n],
+				indi::crc::calculate<32>(messages[n], polys::crc32c));
+	}
+	
+	auto const crc64 = indi::crc::clmul_engine<64>{polys::crc64_ecma};
+	auto crcs = std::vector<std::uint_fast64_t>(messages.size());
+	auto const end = indi::crc::calculate_batch<64>(messages.begin(),
+		messages.end(), crcs.begin(), crc64);
+	
+	BOOST_CHECK(end == crcs.end());
+	for (auto n = std::size_t{0}; n < messages.size(); ++n)
+		BOOST_CHECK_EQUAL(crcs[n],
+			indi::crc::calculate<64>(messages[n], polys::crc64_ecma));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_batch_ranges)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const check = 0xCBF43926u;
+	
+	// Strings, and arrays of them.
+	auto const strings = std::vector<std::string>(3u, "123456789");
+	std::uint_fast32_t crcs[3] = {};
+	indi::crc::calculate_batch<32>(strings, crcs, engine);
+	for (auto const crc : crcs)
+		BOOST_CHECK_EQUAL(crc, check);
+	
+	std::string const array[] = {"123456789", "123456789"};
+	auto out = std::vector<std::uint_fast32_t>{};
+	indi::crc::calculate_batch<32>(array, std::back_inserter(out), engine);
+	BOOST_CHECK_EQUAL(out.size(), 2u);
+	
+	// Messages that aren't contiguous are done one at a time.
+	auto const lists = std::list<std::list<unsigned char>>(4u,
+		std::list<unsigned char>(strings[0].begin(), strings[0].end()));
+	out.clear();
+	indi::crc::calculate_batch<32>(lists, std::back_inserter(out), engine);
+	BOOST_CHECK_EQUAL(out.size(), 4u);
+	for (auto const crc : out)
+		BOOST_CHECK_EQUAL(crc, check);
+	
+	// So are messages for engines that can't work on several at once.
+	auto const braided = indi::crc::braided_engine<32>{polys::crc32};
+	out.clear();
+	indi::crc::calculate_batch<32>(strings, std::back_inserter(out),
+		braided);
+	BOOST_CHECK_EQUAL(out.size(), 3u);
+	for (auto const crc : out)
+		BOOST_CHECK_EQUAL(crc, check);
+	
+	// No messages.
+	auto const none = std::vector<std::string>{};
+	BOOST_CHECK(indi::crc::calculate_batch<32>(none, crcs, engine) ==
+		crcs);
+}
+
+BOOST_AUTO_TEST_CASE(clmul_engine_update_batch)
+{
+	check_update_batch<5, true>(std::uint_fast8_t{0x09u});
+	check_update_batch<5, false>(std::uint_fast8_t{0x09u});
+	check_update_batch<16, true>(polys::crc16_ibm);
+	check_update_batch<16, false>(polys::crc16_ccitt);
+	check_update_batch<32, true>(polys::crc32c);
+	check_update_batch<32, false>(polys::crc32);
+	check_update_batch<64, true>(polys::crc64_ecma);
+	check_update_batch<64, false>(polys::crc64_ecma);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-execution.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <execution>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Every policy gives the same CRC as no policy, for sizes that are
+// split into pieces and sizes that aren't.
+template <std::size_t Bits, typename T, typename Policy>
+auto check_policy(Policy const& policy, T poly) -> void
+{
+	for (auto const size : {std::size_t{0u}, std::size_t{1000u},
+		std::size_t{3u} << 20, (std::size_t{9u} << 20) + 12345u})
+	{
+		auto const data = random_bytes(size);
+		auto const expected = indi::crc::calculate<Bits>(data.begin(),
+			data.end(), poly);
+		
+		BOOST_CHECK_EQUAL(indi::crc::calculate<Bits>(policy, data, poly),
+			expected);
+		BOOST_CHECK_EQUAL(indi::crc::calculate<Bits>(policy, data.data(),
+			data.data() + size, poly), expected);
+		BOOST_CHECK_EQUAL(indi::crc::calculate_raw<Bits>(policy, T{0x5Au},
+			data, poly), indi::crc::calculate_raw<Bits>(T{0x5Au},
+			data.begin(), data.end(), poly));
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_execution_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename Policy, typename T,
+//         typename RAIt>
+//     auto calculate_raw<Bits>(Policy&& policy, T init, RAIt first,
+//             RAIt last, T poly) ->
+//         T
+//     template <std::size_t Bits, typename Policy, typename T,
+//         typename Range>
+//     auto calculate_raw<Bits>(Policy&& policy, T init,
+//             Range const& range, T poly) ->
+//         T
+//     template <std::size_t Bits, typename Policy, typename RAIt,
+//         typename T>
+//     auto calculate<Bits>(Policy&& policy, RAIt first, RAIt last,
+//             T poly) ->
+//         T
+//     template <std::size_t Bits, typename Policy, typename Range,
+//         typename T>
+//     auto calculate<Bits>(Policy&& policy, Range const& range,
+//             T poly) ->
+//         T
+//     template <std::size_t Bits, typename Policy, typename RAIt>
+//     auto calculate<Bits>(Policy&& policy, RAIt first, RAIt last) ->
+//         crc_type_t<Bits>
+//     template <std::size_t Bits, typename Range>
+//     auto calculate<Bits>(Policy const& policy, Range const& range) ->
+//         crc_type_t<Bits>
+BOOST_AUTO_TEST_CASE(calculate_execution_signature)
+{
+	auto const data = std::string{"123456789"};
+	
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::calculate_raw<32>(std::execution::par,
+			std::uint_fast32_t{0u}, data.begin(), data.end(),
+			polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::calculate_raw<32>(std::execution::par,
+			std::uint_fast32_t{0u}, data, polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::calculate<32>(std::execution::par,
+			data.begin(), data.end(), polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::calculate<32>(std::execution::par, data,
+			polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast16_t,
+		decltype(indi::crc::calculate<16>(std::execution::par,
+			data.begin(), data.end()))>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::calculate<32>(std::execution::par,
+			data))>::value));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_execution_check_values)
+{
+	auto const data = std::string{"123456789"};
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::seq, data),
+		0xCBF43926u);
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par, data),
+		0xCBF43926u);
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par_unseq,
+		data), 0xCBF43926u);
+	BOOST_CHECK_EQUAL(indi::crc::calculate<16>(std::execution::par,
+		data.begin(), data.end()), indi::crc::calculate<16>(data));
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par, data,
+		polys::crc32c), 0xE3069283u);
+}
+
+BOOST_AUTO_TEST_CASE(calculate_execution_policies)
+{
+	check_policy<32>(std::execution::seq, polys::crc32);
+	check_policy<32>(std::execution::par, polys::crc32c);
+	check_policy<32>(std::execution::par_unseq, polys::crc32);
+	check_policy<64>(std::execution::par, polys::crc64_ecma);
+	check_policy<64>(std::execution::par_unseq, polys::crc64_ecma);
+	check_policy<16>(std::execution::par_unseq, polys::crc16_ccitt);
+#if __cpp_lib_execution >= 201902L
+	check_policy<32>(std::execution::unseq, polys::crc32c);
+#endif
+}
+
+// Each thread keeps the engine for the last polynomial it used, so
+// switching between polynomials has to build a new one each time.
+BOOST_AUTO_TEST_CASE(calculate_execution_polynomial_changes)
+{
+	auto const data = std::string{"123456789"};
+	
+	for (auto n = 0; n < 3; ++n)
+	{
+		BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par,
+			data, polys::crc32), 0xCBF43926u);
+		BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par,
+			data, polys::crc32c), 0xE3069283u);
+		BOOST_CHECK_EQUAL(indi::crc::calculate<32>(
+			std::execution::par_unseq, data, polys::crc32c), 0xE3069283u);
+	}
+}
+
+// Non-contiguous random access ranges are split too.
+BOOST_AUTO_TEST_CASE(calculate_execution_deque)
+{
+	auto const data = random_bytes((std::size_t{5u} << 20) + 7u);
+	auto const pieces = std::deque<unsigned char>(data.begin(),
+		data.end());
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::execution::par,
+		pieces), indi::crc::calculate<32>(data));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indi/crc-file.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+// Loads a file into memory the slow and obvious way.
+auto load_file(std::string const& path)
+{
+	auto in = std::ifstream{path, std::ios::binary};
+	return std::vector<unsigned char>{std::istreambuf_iterator<char>{in},
+		std::istreambuf_iterator<char>{}};
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_file_suite)
+
+BOOST_AUTO_TEST_CASE(calculate_file_whole)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const path = std::string{"data/table-crc64-ecma"};
+	auto const data = load_file(path);
+	BOOST_REQUIRE(!data.empty());
+	
+	auto bytes_read = std::uint_least64_t{0};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_file<32>(path, polys::crc32,
+		&bytes_read), indi::crc::calculate<32>(data, polys::crc32));
+	BOOST_CHECK_EQUAL(bytes_read, data.size());
+	
+	auto const table = indi::crc::generate_table<64>(polys::crc64_ecma);
+	BOOST_CHECK_EQUAL(indi::crc::calculate_file<64>(path, table),
+		indi::crc::calculate<64>(data, table));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_raw_file_pieces)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const path = std::string{"data/table-crc32"};
+	auto const data = load_file(path);
+	BOOST_REQUIRE(data.size() > 1000u);
+	
+	auto const table = indi::crc::generate_table<32>(polys::crc32);
+	auto const fd = indi::crc::open_file(path);
+	
+	BOOST_CHECK_EQUAL(indi::crc::file_size(fd.get()), data.size());
+	
+	// A piece in the middle.
+	auto bytes_read = std::uint_least64_t{0};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_raw_file<32>(0x1234uL,
+		fd.get(), 100u, 900u, table, &bytes_read),
+		indi::crc::calculate_raw<32>(0x1234uL, data.begin() + 100,
+			data.begin() + 1000, table));
+	BOOST_CHECK_EQUAL(bytes_read, 900u);
+	
+	// A piece running off the end of the file.
+	BOOST_CHECK_EQUAL(indi::crc::calculate_raw_file<32>(0uL, fd.get(),
+		1000u, UINT_LEAST64_MAX, table, &bytes_read),
+		indi::crc::calculate_raw<32>(0uL, data.begin() + 1000,
+			data.end(), table));
+	BOOST_CHECK_EQUAL(bytes_read, data.size() - 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(calculate_file_errors)
+{
+	BOOST_CHECK_THROW(indi::crc::calculate_file<32>(
+		std::string{"data/no-such-file"}, indi::crc::polynomials::crc32),
+		std::system_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-fixed.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+constexpr unsigned char check_data[] = {
+	'1', '2', '3', '4', '5', '6', '7', '8', '9'
+};
+
+// Something more varied than a check string, long enough for every
+// length tested.
+auto const data = []
+{
+	auto bytes = std::array<unsigned char, 100>{};
+	for (auto n = std::size_t{0}; n < bytes.size(); ++n)
+		bytes[n] = static_cast<unsigned char>(n * 37u + 11u);
+	return bytes;
+}();
+
+// Checks a length against `calculate`.
+template <std::size_t Bits, indi::crc::crc_type_t<Bits> Polynomial,
+	std::size_t Length>
+auto check_length()
+{
+	auto const table = indi::crc::generate_table<Bits>(Polynomial);
+	auto const p = data.data();
+	
+	BOOST_CHECK_MESSAGE(
+		(indi::crc::calculate_fixed<Bits, Polynomial, Length>(p)) ==
+			indi::crc::calculate<Bits>(p, p + Length, table),
+		"Bits " << Bits << ", length " << Length);
+	return 0;
+}
+
+template <std::size_t Bits, indi::crc::crc_type_t<Bits> Polynomial,
+	std::size_t... Lengths>
+auto check_lengths(std::index_sequence<Lengths...>)
+{
+	using expand = int[];
+	(void)expand{0, check_length<Bits, Polynomial, Lengths>()...};
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_fixed_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, crc_type_t<Bits> Polynomial,
+//         std::size_t N>
+//     constexpr auto calculate_fixed_raw(crc_type_t<Bits> crc,
+//             unsigned char const* p) noexcept ->
+//         crc_type_t<Bits>
+//     template <std::size_t Bits, crc_type_t<Bits> Polynomial,
+//         std::size_t N>
+//     constexpr auto calculate_fixed(unsigned char const* p) noexcept ->
+//         crc_type_t<Bits>
+//     template <std::size_t Bits, crc_type_t<Bits> Polynomial,
+//         std::size_t N>
+//     constexpr auto calculate_fixed(
+//             std::array<unsigned char, N> const& key) noexcept ->
+//         crc_type_t<Bits>
+BOOST_AUTO_TEST_CASE(calculate_fixed_signature)
+{
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(indi::crc::calculate_fixed<32, polys::crc32c, 9u>(
+			check_data))>::value));
+	BOOST_CHECK((std::is_same<
+		std::uint_fast16_t,
+		decltype(indi::crc::calculate_fixed_raw<16, polys::crc16, 9u>(
+			0u, check_data))>::value));
+	BOOST_CHECK((std::is_same<
+		std::uint_fast64_t,
+		decltype(indi::crc::calculate_fixed<64, polys::crc64_ecma>(
+			std::array<unsigned char, 8>{}))>::value));
+	
+	// Must be usable in constant expressions.
+	constexpr auto crc = indi::crc::calculate_fixed<32, polys::crc32c, 9u>(
+		check_data);
+	static_assert(crc == 0xE3069283u, "CRC-32C check value");
+	constexpr auto raw = indi::crc::calculate_fixed_raw<16, polys::crc16,
+		9u>(0u, check_data);
+	static_assert(raw == 0xBB3Du, "CRC-16/ARC check value");
+}
+
+BOOST_AUTO_TEST_CASE(calculate_fixed_check_values)
+{
+	BOOST_CHECK_EQUAL((indi::crc::calculate_fixed<32, polys::crc32, 9u>(
+		check_data)), 0xCBF43926u);
+	BOOST_CHECK_EQUAL((indi::crc::calculate_fixed<32, polys::crc32c, 9u>(
+		check_data)), 0xE3069283u);
+	BOOST_CHECK_EQUAL((indi::crc::calculate_fixed<64, polys::crc64_ecma,
+		9u>(check_data)), 0x995DC9BBDF1939FAu);
+}
+
+// Every length up to a few 16-byte blocks, and the usual key sizes, so
+// every mix of whole words, 16-byte blocks, 8-byte halves, and odd bytes
+// is covered.
+BOOST_AUTO_TEST_CASE(calculate_fixed_lengths)
+{
+	auto const lengths = std::make_index_sequence<50u>{};
+	check_lengths<32, polys::crc32c>(lengths);
+	check_lengths<32, polys::crc32>(lengths);
+	check_lengths<16, polys::crc16_ibm>(lengths);
+	check_lengths<64, polys::crc64_ecma>(lengths);
+	
+	auto const keys = std::index_sequence<64u, 71u, 96u, 100u>{};
+	check_lengths<32, polys::crc32c>(keys);
+	check_lengths<32, polys::crc32>(keys);
+	check_lengths<64, polys::crc64_iso>(keys);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
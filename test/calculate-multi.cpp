@@ -0,0 +1,134 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc.hpp"
+#include "indi/crc-nibble.hpp"
+#include "indi/crc-simd.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+// Several blocks' worth, plus a bit, so the last block is short.
+auto block_data()
+{
+	return indi::crc::test::random_bytes(3u * 4096u + 123u);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_multi_suite)
+
+// Testing for signatures:
+//     template <typename InputIterator, typename Sentinel,
+//         typename... Engines>
+//     auto calculate_multi(InputIterator first, Sentinel last,
+//             Engines const&... engines) ->
+//         std::tuple<typename Engines::crc_type...>
+//     template <typename Range, typename... Engines>
+//     auto calculate_multi(Range const& range,
+//             Engines const&... engines) ->
+//         std::tuple<typename Engines::crc_type...>
+BOOST_AUTO_TEST_CASE(calculate_multi_signature)
+{
+	auto const crc32 = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const crc64 = indi::crc::clmul_engine<64>{polys::crc64_ecma};
+	auto const data = std::string{"123456789"};
+	
+	BOOST_CHECK((std::is_same<
+		std::tuple<std::uint_fast32_t, std::uint_fast64_t>,
+		decltype(indi::crc::calculate_multi(data, crc32, crc64))>::value));
+	BOOST_CHECK((std::is_same<
+		std::tuple<std::uint_fast32_t>,
+		decltype(indi::crc::calculate_multi(data.begin(), data.end(),
+			crc32))>::value));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_multi_check_values)
+{
+	auto const crc32 = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const crc32c = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const crc64 = indi::crc::clmul_engine<64>{polys::crc64_ecma};
+	auto const data = std::string{"123456789"};
+	
+	auto const crcs = indi::crc::calculate_multi(data, crc32, crc32c,
+		crc64);
+	BOOST_CHECK_EQUAL(std::get<0>(crcs), 0xCBF43926u);
+	BOOST_CHECK_EQUAL(std::get<1>(crcs), 0xE3069283u);
+	BOOST_CHECK_EQUAL(std::get<2>(crcs), 0x995DC9BBDF1939FAu);
+}
+
+// Every combination must give the same CRCs as calculating them one
+// at a time, for contiguous and non-contiguous input.
+BOOST_AUTO_TEST_CASE(calculate_multi_matches_calculate)
+{
+	auto const data = block_data();
+	auto const list = std::list<unsigned char>(data.begin(), data.end());
+	
+	auto const crc16 = indi::crc::clmul_engine<16>{polys::crc16_ibm};
+	auto const crc32 = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const crc32k = indi::crc::nibble_engine<32>{polys::crc32k};
+	auto const crc64 = indi::crc::braided_engine<64>{polys::crc64_iso};
+	
+	auto const expected16 = indi::crc::calculate<16>(data, crc16);
+	auto const expected32 = indi::crc::calculate<32>(data, crc32);
+	auto const expected32k = indi::crc::calculate<32>(data, crc32k);
+	auto const expected64 = indi::crc::calculate<64>(data, crc64);
+	
+	for (auto const size : {std::size_t{0u}, std::size_t{1u},
+		std::size_t{4096u}, data.size()})
+	{
+		auto const first = data.data();
+		auto const crcs = indi::crc::calculate_multi(first, first + size,
+			crc16, crc32, crc32k, crc64);
+		BOOST_CHECK_EQUAL(std::get<0>(crcs),
+			indi::crc::calculate<16>(first, first + size, crc16));
+		BOOST_CHECK_EQUAL(std::get<1>(crcs),
+			indi::crc::calculate<32>(first, first + size, crc32));
+		BOOST_CHECK_EQUAL(std::get<2>(crcs),
+			indi::crc::calculate<32>(first, first + size, crc32k));
+		BOOST_CHECK_EQUAL(std::get<3>(crcs),
+			indi::crc::calculate<64>(first, first + size, crc64));
+	}
+	
+	auto const crcs = indi::crc::calculate_multi(list, crc64, crc16,
+		crc32k, crc32);
+	BOOST_CHECK_EQUAL(std::get<0>(crcs), expected64);
+	BOOST_CHECK_EQUAL(std::get<1>(crcs), expected16);
+	BOOST_CHECK_EQUAL(std::get<2>(crcs), expected32k);
+	BOOST_CHECK_EQUAL(std::get<3>(crcs), expected32);
+	
+	// The same engine more than once.
+	auto const twice = indi::crc::calculate_multi(data, crc32, crc32);
+	BOOST_CHECK_EQUAL(std::get<0>(twice), expected32);
+	BOOST_CHECK_EQUAL(std::get<1>(twice), expected32);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
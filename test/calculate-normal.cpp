@@ -0,0 +1,145 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+auto const check_string = std::string{"123456789"};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_normal_suite)
+
+// Testing for signature:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto generate_normal_table<Bits>(
+//             T polynomial) noexcept ->
+//         std::array<T, 256>
+BOOST_AUTO_TEST_CASE(generate_normal_table_values)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	BOOST_CHECK((std::is_same<
+		std::array<std::uint_fast32_t, 256>,
+		decltype(indi::crc::generate_normal_table<32>(polys::crc32))>::
+			value));
+	
+	auto const table16 = indi::crc::generate_normal_table<16>(
+		polys::crc16_ccitt);
+	
+	// The entry for 1 is x^Bits mod P, which is just the polynomial.
+	BOOST_CHECK_EQUAL(table16[0], 0u);
+	BOOST_CHECK_EQUAL(table16[1], polys::crc16_ccitt);
+	BOOST_CHECK_EQUAL(table16[0x80], 0x9188u);
+	
+	auto const table32 = indi::crc::generate_normal_table<32>(polys::crc32);
+	BOOST_CHECK_EQUAL(table32[1], polys::crc32);
+	BOOST_CHECK_EQUAL(table32[0xFF], 0xB1F740B4u);
+	
+	// Narrower than a byte.
+	auto const table5 = indi::crc::generate_normal_table<5>(
+		std::uint_fast8_t{0x09u});
+	BOOST_CHECK_EQUAL(table5[1], 0x09u);
+	for (auto const crc : table5)
+		BOOST_CHECK_LT(crc, 0x20u);
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T, typename InputIterator,
+//         typename Sentinel, typename Table>
+//     constexpr auto calculate_normal_raw<Bits>(
+//             T init,
+//             InputIterator first,
+//             Sentinel last,
+//             Table const& table) noexcept ->
+//         T
+//     template <std::size_t Bits, typename T, typename Range,
+//         typename Table>
+//     constexpr auto calculate_normal_raw<Bits>(
+//             T init,
+//             Range const& range,
+//             Table const& table) noexcept ->
+//         T
+// (and the same with a polynomial in place of the table)
+BOOST_AUTO_TEST_CASE(calculate_normal_raw_check_values)
+{
+	namespace polys = indi::crc::polynomials;
+	using indi::crc::calculate_normal_raw;
+	
+	// CRC-32/MPEG-2 and CRC-32/BZIP2.
+	auto const mpeg2 = calculate_normal_raw<32>(
+		std::uint_fast32_t{0xFFFFFFFFu}, check_string, polys::crc32);
+	BOOST_CHECK_EQUAL(mpeg2, 0x0376E6E7u);
+	BOOST_CHECK_EQUAL(mpeg2 ^ 0xFFFFFFFFu, 0xFC891918u);
+	
+	// CRC-16/XMODEM and CRC-16/IBM-3740.
+	BOOST_CHECK_EQUAL(calculate_normal_raw<16>(std::uint_fast16_t{0u},
+		check_string, polys::crc16_ccitt), 0x31C3u);
+	BOOST_CHECK_EQUAL(calculate_normal_raw<16>(std::uint_fast16_t{0xFFFFu},
+		check_string, polys::crc16_ccitt), 0x29B1u);
+	
+	// CRC-64/ECMA-182.
+	BOOST_CHECK_EQUAL(calculate_normal_raw<64>(std::uint_fast64_t{0u},
+		check_string, polys::crc64_ecma), 0x6C40DF5F0B497347uLL);
+	
+	// CRC-8/SMBUS, CRC-5/EPC-C1G2, and CRC-3/GSM (final XOR 7).
+	BOOST_CHECK_EQUAL(calculate_normal_raw<8>(std::uint_fast8_t{0u},
+		check_string, std::uint_fast8_t{0x07u}), 0xF4u);
+	BOOST_CHECK_EQUAL(calculate_normal_raw<5>(std::uint_fast8_t{0x09u},
+		check_string, std::uint_fast8_t{0x09u}), 0x00u);
+	BOOST_CHECK_EQUAL(calculate_normal_raw<3>(std::uint_fast8_t{0u},
+		check_string, std::uint_fast8_t{0x3u}) ^ 0x7u, 0x4u);
+}
+
+BOOST_AUTO_TEST_CASE(calculate_normal_raw_overloads)
+{
+	namespace polys = indi::crc::polynomials;
+	using indi::crc::calculate_normal_raw;
+	
+	auto const table = indi::crc::generate_normal_table<32>(polys::crc32);
+	auto const init = std::uint_fast32_t{0xFFFFFFFFu};
+	
+	// Iterators, non-random-access iterators, and arrays.
+	BOOST_CHECK_EQUAL(calculate_normal_raw<32>(init, check_string.begin(),
+		check_string.end(), table), 0x0376E6E7u);
+	auto const list = std::list<char>(check_string.begin(),
+		check_string.end());
+	BOOST_CHECK_EQUAL(calculate_normal_raw<32>(init, list, table),
+		0x0376E6E7u);
+	char const array[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	BOOST_CHECK_EQUAL(calculate_normal_raw<32>(init, array, table),
+		0x0376E6E7u);
+	
+	// Calculating in pieces gives the same result.
+	auto crc = init;
+	for (auto const c : check_string)
+		crc = indi::crc::calculate_next_normal<32>(crc,
+			static_cast<std::uint_fast8_t>(c), table);
+	BOOST_CHECK_EQUAL(crc, 0x0376E6E7u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
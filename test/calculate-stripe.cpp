@@ -0,0 +1,161 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-stripe.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "indi/crc-braid.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+auto random_blocks(std::size_t count, std::size_t size)
+{
+	auto blocks = std::vector<std::vector<unsigned char>>{};
+	for (auto n = 0u; n < count; ++n)
+		blocks.push_back(indi::crc::test::random_bytes(size, n));
+	return blocks;
+}
+
+// Checks the parity block and the CRCs against separate passes, for
+// every number of blocks up to 5 and sizes on both sides of a piece.
+template <std::size_t Bits, typename T, typename Engine>
+auto check_stripes(T polynomial, Engine const& engine) -> void
+{
+	for (auto const size : {std::size_t{0u}, std::size_t{1u},
+		std::size_t{63u}, std::size_t{100u}, std::size_t{4096u},
+		std::size_t{10000u}})
+	{
+		for (auto count = std::size_t{0}; count <= 5u; ++count)
+		{
+			auto const blocks = random_blocks(count, size);
+			auto pointers = std::vector<unsigned char const*>{};
+			for (auto const& block : blocks)
+				pointers.push_back(block.data());
+			
+			auto parity = std::vector<unsigned char>(size, 0xA5u);
+			auto crcs = std::vector<T>(count + 1u);
+			indi::crc::calculate_stripe<Bits>(pointers.data(), count, size,
+				parity.data(), crcs.data(), polynomial, engine);
+			
+			auto expected = std::vector<unsigned char>(size);
+			for (auto const& block : blocks)
+				for (auto n = std::size_t{0}; n < size; ++n)
+					expected[n] ^= block[n];
+			BOOST_CHECK(parity == expected);
+			
+			for (auto block = std::size_t{0}; block < count; ++block)
+				BOOST_CHECK_EQUAL(crcs[block], indi::crc::calculate<Bits>(
+					blocks[block].begin(), blocks[block].end(), engine));
+			BOOST_CHECK_EQUAL(crcs[count], indi::crc::calculate<Bits>(
+				expected.begin(), expected.end(), engine));
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(calculate_stripe_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T, typename Engine>
+//     auto calculate_stripe_raw<Bits>(T init,
+//             unsigned char const* const* blocks, std::size_t count,
+//             std::size_t size, unsigned char* parity, T* crcs,
+//             T polynomial, Engine const& engine) noexcept ->
+//         void
+//     template <std::size_t Bits, typename T, typename Engine>
+//     auto calculate_stripe<Bits>(unsigned char const* const* blocks,
+//             std::size_t count, std::size_t size,
+//             unsigned char* parity, T* crcs, T polynomial,
+//             Engine const& engine) noexcept ->
+//         void
+BOOST_AUTO_TEST_CASE(calculate_stripe_signature)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	unsigned char const* const* blocks = nullptr;
+	auto crcs = static_cast<std::uint_fast32_t*>(nullptr);
+	
+	BOOST_CHECK((std::is_same<void, decltype(
+		indi::crc::calculate_stripe<32>(blocks, 0u, 0u, nullptr, crcs,
+			polys::crc32c, engine))>::value));
+	BOOST_CHECK((std::is_same<void, decltype(
+		indi::crc::calculate_stripe_raw<32>(std::uint_fast32_t{0u},
+			blocks, 0u, 0u, nullptr, crcs, polys::crc32c,
+			engine))>::value));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_stripe_check_values)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const a = reinterpret_cast<unsigned char const*>("123456789");
+	auto const zeros = reinterpret_cast<unsigned char const*>(
+		"\0\0\0\0\0\0\0\0\0");
+	unsigned char const* const blocks[] = {a, zeros};
+	unsigned char parity[9] = {};
+	std::uint_fast32_t crcs[3] = {};
+	
+	indi::crc::calculate_stripe<32>(blocks, 2u, 9u, parity, crcs,
+		polys::crc32c, engine);
+	BOOST_CHECK_EQUAL(crcs[0], 0xE3069283u);
+	BOOST_CHECK_EQUAL(crcs[2], 0xE3069283u);
+	BOOST_CHECK(std::equal(parity, parity + 9, a));
+}
+
+BOOST_AUTO_TEST_CASE(calculate_stripe_engines)
+{
+	check_stripes<32>(polys::crc32c,
+		indi::crc::clmul_engine<32>{polys::crc32c});
+	check_stripes<32>(polys::crc32,
+		indi::crc::braided_engine<32>{polys::crc32});
+	check_stripes<64>(polys::crc64_ecma,
+		indi::crc::clmul_engine<64>{polys::crc64_ecma});
+	check_stripes<16>(polys::crc16_ccitt,
+		indi::crc::braided_engine<16>{polys::crc16_ccitt});
+}
+
+BOOST_AUTO_TEST_CASE(calculate_stripe_raw_init)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const blocks = random_blocks(4u, 5000u);
+	unsigned char const* const pointers[] = {blocks[0].data(),
+		blocks[1].data(), blocks[2].data(), blocks[3].data()};
+	auto parity = std::vector<unsigned char>(5000u);
+	std::uint_fast32_t crcs[5] = {};
+	
+	indi::crc::calculate_stripe_raw<32>(std::uint_fast32_t{0x12345678u},
+		pointers, 4u, 5000u, parity.data(), crcs, polys::crc32, engine);
+	for (auto block = 0u; block < 4u; ++block)
+		BOOST_CHECK_EQUAL(crcs[block], indi::crc::calculate_raw<32>(
+			std::uint_fast32_t{0x12345678u}, blocks[block].begin(),
+			blocks[block].end(), engine));
+	BOOST_CHECK_EQUAL(crcs[4], indi::crc::calculate_raw<32>(
+		std::uint_fast32_t{0x12345678u}, parity.begin(), parity.end(),
+		engine));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
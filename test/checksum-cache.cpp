@@ -0,0 +1,181 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indi/crc-cache.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "test.hpp"
+
+namespace {
+
+using indi::crc::test::stat_file;
+using indi::crc::test::write_file;
+
+// Removes the test files, even if a test fails.
+struct temp_files
+{
+	temp_files()
+	{
+		write_file(file, "123456789");
+	}
+	
+	std::string const file = "cache-test.tmp";
+	std::string const database = "cache-test.db";
+	indi::crc::test::temp_paths const cleanup{file, database};
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(checksum_cache_suite)
+
+BOOST_FIXTURE_TEST_CASE(checksum_cache_database, temp_files)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const table = indi::crc::generate_table<32>(polys::crc32);
+	
+	{
+		indi::crc::checksum_cache cache{database, false};
+		
+		auto bytes_read = std::uint_least64_t{0};
+		BOOST_CHECK_EQUAL(indi::crc::calculate_file<32>(file, table, cache,
+			"crc32", &bytes_read), 0xCBF43926uL);
+		BOOST_CHECK_EQUAL(bytes_read, 9u);
+		
+		auto crc = std::uintmax_t{0};
+		BOOST_CHECK(cache.find(file, stat_file(file), "crc32", crc));
+		BOOST_CHECK_EQUAL(crc, 0xCBF43926u);
+		BOOST_CHECK(!cache.find(file, stat_file(file), "crc32c", crc));
+		
+		cache.save();
+	}
+	
+	// The entry survives a reload.
+	indi::crc::checksum_cache cache{database, false};
+	auto crc = std::uintmax_t{0};
+	BOOST_CHECK(cache.find(file, stat_file(file), "crc32", crc));
+	BOOST_CHECK_EQUAL(crc, 0xCBF43926u);
+}
+
+BOOST_FIXTURE_TEST_CASE(checksum_cache_hit, temp_files)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const table = indi::crc::generate_table<32>(polys::crc32);
+	indi::crc::checksum_cache cache{database, false};
+	
+	// A stored value is returned without the file being read.
+	BOOST_REQUIRE(cache.store(file, stat_file(file), "crc32", 0x1234u));
+	BOOST_CHECK_EQUAL(indi::crc::calculate_file<32>(file, table, cache,
+		"crc32"), 0x1234u);
+}
+
+BOOST_FIXTURE_TEST_CASE(checksum_cache_invalidated, temp_files)
+{
+	indi::crc::checksum_cache cache{database, false};
+	
+	auto const before = stat_file(file);
+	BOOST_REQUIRE(cache.store(file, before, "crc32", 0x1234u));
+	
+	// Same size, different contents and modification time.
+	write_file(file, "987654321");
+	auto times = std::array<struct ::timespec, 2>{};
+	times[0].tv_nsec = UTIME_OMIT;
+	times[1] = before.st_mtim;
+	times[1].tv_sec += 10;
+	BOOST_REQUIRE(::utimensat(AT_FDCWD, file.c_str(), times.data(), 0)
+		== 0);
+	
+	auto crc = std::uintmax_t{0};
+	BOOST_CHECK(!cache.find(file, stat_file(file), "crc32", crc));
+	
+	// Setting the modification time back doesn't hide the change.
+	times[1] = before.st_mtim;
+	BOOST_REQUIRE(::utimensat(AT_FDCWD, file.c_str(), times.data(), 0)
+		== 0);
+	BOOST_CHECK(!cache.find(file, stat_file(file), "crc32", crc));
+	
+	// Nor is anything stored for a file that changed after it was read.
+	BOOST_CHECK(!cache.store(file, before, "crc32", 0x1234u));
+}
+
+BOOST_FIXTURE_TEST_CASE(checksum_cache_xattr, temp_files)
+{
+	indi::crc::checksum_cache cache{};
+	
+	// Without a database, storing only works where extended attributes
+	// are supported.
+	if (!cache.store(file, stat_file(file), "crc32", 0x1234u))
+	{
+		BOOST_TEST_MESSAGE("extended attributes are not supported");
+		return;
+	}
+	
+	auto crc = std::uintmax_t{0};
+	BOOST_CHECK(cache.find(file, stat_file(file), "crc32", crc));
+	BOOST_CHECK_EQUAL(crc, 0x1234u);
+	
+	// A fresh cache finds it too.
+	indi::crc::checksum_cache other{};
+	BOOST_CHECK(other.find(file, stat_file(file), "crc32", crc));
+	
+	// But not once the file has been written.
+	auto times = std::array<struct ::timespec, 2>{};
+	times[0].tv_nsec = UTIME_OMIT;
+	times[1] = stat_file(file).st_mtim;
+	times[1].tv_sec += 10;
+	write_file(file, "987654321");
+	BOOST_REQUIRE(::utimensat(AT_FDCWD, file.c_str(), times.data(), 0)
+		== 0);
+	BOOST_CHECK(!other.find(file, stat_file(file), "crc32", crc));
+}
+
+BOOST_FIXTURE_TEST_CASE(checksum_cache_xattr_ctime, temp_files)
+{
+	indi::crc::checksum_cache cache{};
+	
+	auto const before = stat_file(file);
+	if (!cache.store(file, before, "crc32", 0x1234u))
+	{
+		BOOST_TEST_MESSAGE("extended attributes are not supported");
+		return;
+	}
+	
+	// Setting the modification time back doesn't hide a write, once
+	// the deadline for setting the attribute has passed.
+	std::this_thread::sleep_for(std::chrono::milliseconds{50});
+	write_file(file, "987654321");
+	auto times = std::array<struct ::timespec, 2>{};
+	times[0].tv_nsec = UTIME_OMIT;
+	times[1] = before.st_mtim;
+	BOOST_REQUIRE(::utimensat(AT_FDCWD, file.c_str(), times.data(), 0)
+		== 0);
+	
+	auto crc = std::uintmax_t{0};
+	BOOST_CHECK(!cache.find(file, stat_file(file), "crc32", crc));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,175 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-chorba.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+namespace multiples = indi::crc::chorba_multiples;
+
+using indi::crc::test::random_bytes;
+
+// Checks both kinds of engine against 256-element tables, at lengths
+// either side of where the engine starts reducing the input, plus some
+// larger ones, at a few alignments, with random initial values.
+template <std::size_t Bits, typename T>
+auto check_engines(T polynomial, indi::crc::chorba_multiple multiple)
+{
+	BOOST_REQUIRE(indi::crc::is_chorba_multiple<Bits>(polynomial,
+		multiple));
+	
+	auto const data = random_bytes(100000u);
+	auto const table = indi::crc::generate_table<Bits>(polynomial);
+	auto const normal_table = indi::crc::generate_normal_table<Bits>(
+		polynomial);
+	auto const mask = indi::crc::detail_::ones<Bits, T>();
+	
+	auto const reflected = indi::crc::chorba_engine<Bits, T>{polynomial,
+		multiple};
+	auto const normal = indi::crc::normal_chorba_engine<Bits, T>{
+		polynomial, multiple};
+	
+	// The engine only reduces inputs of 4 * degree words or more.
+	auto const threshold = std::size_t{32u} * multiple.degree;
+	auto lengths = std::vector<std::size_t>{0u, 1u, 7u, 8u, 9u};
+	for (auto length = threshold - 9u; length <= threshold + 24u; ++length)
+		lengths.push_back(length);
+	for (auto length : {2u * threshold + 5u, std::size_t{20000u},
+		std::size_t{99997u}})
+		lengths.push_back(length);
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto offset = std::size_t{0}; offset < 3u; ++offset)
+	{
+		for (auto length : lengths)
+		{
+			auto const init = static_cast<T>(random() & mask);
+			auto const first = data.data() + offset;
+			auto const last = first + length;
+			
+			if (reflected.update(init, first, last) !=
+					indi::crc::calculate_raw<Bits>(init, first, last, table) ||
+				normal.update(init, first, last) !=
+					indi::crc::calculate_normal_raw<Bits>(init, first, last,
+						normal_table))
+			{
+				BOOST_ERROR("Bits " << Bits << ", degree " <<
+					multiple.degree << ", offset " << offset <<
+					", length " << length);
+				return;
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(chorba_engine_suite)
+
+// Testing for signature:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto is_chorba_multiple<Bits>(T polynomial,
+//             chorba_multiple const& multiple) noexcept -> bool
+BOOST_AUTO_TEST_CASE(is_chorba_multiple_values)
+{
+	static_assert(indi::crc::is_chorba_multiple<32>(polys::crc32,
+		multiples::crc32), "");
+	
+	BOOST_CHECK(indi::crc::is_chorba_multiple<32>(polys::crc32_ansi,
+		multiples::crc32_ansi));
+	BOOST_CHECK(indi::crc::is_chorba_multiple<32>(polys::crc32_ieee,
+		multiples::crc32_ieee));
+	BOOST_CHECK(indi::crc::is_chorba_multiple<32>(polys::crc32c,
+		multiples::crc32c));
+	BOOST_CHECK(indi::crc::is_chorba_multiple<32>(polys::crc32k,
+		multiples::crc32k));
+	BOOST_CHECK(indi::crc::is_chorba_multiple<32>(polys::crc32q,
+		multiples::crc32q));
+	
+	BOOST_CHECK(!indi::crc::is_chorba_multiple<32>(polys::crc32c,
+		multiples::crc32));
+	BOOST_CHECK(!indi::crc::is_chorba_multiple<32>(polys::crc32,
+		indi::crc::chorba_multiple{204u, {{187u, 124u, 86u, 80u}}}));
+	
+	// x^3 + x + 1 has order 7, so x^(64 * 7) = 1.
+	BOOST_CHECK(indi::crc::is_chorba_multiple<3>(std::uint_fast8_t{0x3u},
+		indi::crc::chorba_multiple{7u, {{0u, 0u, 0u, 0u}}}));
+	BOOST_CHECK(!indi::crc::is_chorba_multiple<3>(std::uint_fast8_t{0x3u},
+		indi::crc::chorba_multiple{0u, {{0u, 0u, 0u, 0u}}}));
+	BOOST_CHECK(!indi::crc::is_chorba_multiple<3>(std::uint_fast8_t{0x3u},
+		indi::crc::chorba_multiple{7u, {{7u, 7u, 0u, 0u}}}));
+}
+
+BOOST_AUTO_TEST_CASE(chorba_engine_values)
+{
+	check_engines<32>(polys::crc32, multiples::crc32);
+	check_engines<32>(polys::crc32c, multiples::crc32c);
+	check_engines<32>(polys::crc32k, multiples::crc32k);
+	check_engines<32>(polys::crc32q, multiples::crc32q);
+	
+	// Multiples with fewer terms.
+	check_engines<32>(polys::crc32,
+		indi::crc::chorba_multiple{300u, {{155u, 117u, 89u, 0u}}});
+	check_engines<16>(polys::crc16_ccitt,
+		indi::crc::chorba_multiple{16u, {{0u, 12u, 0u, 5u}}});
+	check_engines<5>(std::uint_fast8_t{0x09u},
+		indi::crc::chorba_multiple{5u, {{3u, 0u, 0u, 0u}}});
+	check_engines<3>(std::uint_fast8_t{0x3u},
+		indi::crc::chorba_multiple{7u, {{0u, 0u, 0u, 0u}}});
+}
+
+BOOST_AUTO_TEST_CASE(chorba_engine_calculate)
+{
+	auto const engine = indi::crc::chorba_engine<32>{polys::crc32,
+		multiples::crc32};
+	auto const check = std::string{"123456789"};
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(check, engine),
+		0xCBF43926u);
+	
+	auto const data = random_bytes(20000u);
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(data, engine),
+		indi::crc::calculate<32>(data, polys::crc32));
+	
+	auto const list = std::list<unsigned char>(data.begin(), data.end());
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(list, engine),
+		indi::crc::calculate<32>(data, polys::crc32));
+	
+	auto const mpeg2 = indi::crc::normal_chorba_engine<32>{polys::crc32,
+		multiples::crc32};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<32>(
+		std::uint_fast32_t{0xFFFFFFFFu}, data, mpeg2),
+		indi::crc::calculate_normal_raw<32>(
+			std::uint_fast32_t{0xFFFFFFFFu}, data,
+			indi::crc::generate_normal_table<32>(polys::crc32)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
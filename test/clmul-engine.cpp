@@ -0,0 +1,303 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-simd.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::clmul_kernel;
+using indi::crc::test::random_bytes;
+
+// The kernels that can be asked for (unsupported ones fall back, so
+// asking for each one is always valid).
+clmul_kernel const kernels[] = {
+	clmul_kernel::table,
+	clmul_kernel::pclmul,
+	clmul_kernel::vpclmul,
+	clmul_kernel::pshufb,
+	clmul_kernel::vpshufb,
+	clmul_kernel::automatic
+};
+
+template <std::size_t Bits, typename T, typename Table>
+auto table_crc(T init, unsigned char const* first,
+	unsigned char const* last, Table const& table, std::true_type)
+{
+	return indi::crc::calculate_raw<Bits>(init, first, last, table);
+}
+
+template <std::size_t Bits, typename T, typename Table>
+auto table_crc(T init, unsigned char const* first,
+	unsigned char const* last, Table const& table, std::false_type)
+{
+	return indi::crc::calculate_normal_raw<Bits>(init, first, last, table);
+}
+
+// Checks an engine against a lookup table, over every length up to a
+// few hundred bytes (to cover every tail and every number of folds),
+// plus some larger ones, at a few alignments, with random initial
+// values.
+template <std::size_t Bits, bool Reflected, typename T>
+auto check_engine(T polynomial)
+{
+	using reflected = std::integral_constant<bool, Reflected>;
+	
+	auto const data = random_bytes(70000u);
+	auto const table = Reflected ?
+		indi::crc::generate_table<Bits>(polynomial) :
+		indi::crc::generate_normal_table<Bits>(polynomial);
+	auto const mask = indi::crc::detail_::ones<Bits, T>();
+	
+	auto lengths = std::vector<std::size_t>{};
+	for (auto length = std::size_t{0}; length <= 600u; ++length)
+		lengths.push_back(length);
+	for (auto length : {1023u, 2047u, 2048u, 2063u, 3000u, 4095u, 4096u,
+		4111u, 8191u, 8192u, 8207u, 16383u, 16384u, 16399u, 40000u,
+		65536u + 13u})
+		lengths.push_back(length);
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto kernel : kernels)
+	{
+		// A low threshold, so the 512-bit kernel runs for short inputs.
+		auto const engine = indi::crc::basic_clmul_engine<Bits, T,
+			Reflected>{polynomial, kernel, 256u};
+		
+		for (auto offset = std::size_t{0}; offset < 4u; ++offset)
+		{
+			for (auto length : lengths)
+			{
+				auto const init = static_cast<T>(random() & mask);
+				auto const first = data.data() + offset;
+				auto const expected = table_crc<Bits>(init, first,
+					first + length, table, reflected{});
+				auto const actual = engine.update(init, first,
+					first + length);
+				if (actual != expected)
+				{
+					BOOST_ERROR("Bits " << Bits << ", reflected " <<
+						Reflected << ", kernel " <<
+						static_cast<int>(engine.kernel()) << ", offset " <<
+						offset << ", length " << length);
+					return;
+				}
+			}
+		}
+	}
+}
+
+// Engines can be made from constants worked out beforehand, and then
+// match engines made from the polynomial, with every kernel.
+template <typename Constants32, typename Constants64>
+auto check_precomputed(Constants32 const& k32, Constants64 const& k64)
+{
+	auto const data = random_bytes(5000u);
+	
+	for (auto kernel : kernels)
+	{
+		auto const from_constants = indi::crc::clmul_engine<32>{k32, kernel};
+		auto const from_polynomial = indi::crc::clmul_engine<32>{
+			polys::crc32c, kernel};
+		BOOST_CHECK(from_constants.kernel() == from_polynomial.kernel());
+		BOOST_CHECK_EQUAL(indi::crc::calculate<32>(data, from_constants),
+			indi::crc::calculate<32>(data, from_polynomial));
+		
+		auto const normal = indi::crc::normal_clmul_engine<64>{k64,
+			kernel};
+		auto const init = ~std::uint_fast64_t{0};
+		BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<64>(init, data,
+			normal), indi::crc::calculate_normal_raw<64>(init, data,
+			polys::crc64_ecma));
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(clmul_engine_suite)
+
+BOOST_AUTO_TEST_CASE(clmul_engine_kernels)
+{
+	check_engine<16, true>(polys::crc16_ibm);
+	check_engine<16, true>(polys::crc16_t10_dif);
+	check_engine<32, true>(polys::crc32);
+	check_engine<32, true>(polys::crc32c);
+	check_engine<64, true>(polys::crc64_ecma);
+	check_engine<64, true>(polys::crc64_iso);
+	check_engine<5, true>(std::uint_fast8_t{0x09u});
+	check_engine<8, true>(std::uint_fast8_t{0x07u});
+	check_engine<24, true>(std::uint_fast32_t{0x00065Bu});
+}
+
+BOOST_AUTO_TEST_CASE(normal_clmul_engine_kernels)
+{
+	check_engine<16, false>(polys::crc16_ccitt);
+	check_engine<16, false>(polys::crc16_t10_dif);
+	check_engine<32, false>(polys::crc32);
+	check_engine<32, false>(polys::crc32c);
+	check_engine<64, false>(polys::crc64_ecma);
+	check_engine<64, false>(polys::crc64_iso);
+	check_engine<8, false>(std::uint_fast8_t{0x07u});
+	check_engine<5, false>(std::uint_fast8_t{0x09u});
+	check_engine<12, false>(std::uint_fast16_t{0x80Fu});
+	check_engine<24, false>(std::uint_fast32_t{0x864CFBu});
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T, typename Range,
+//         typename Engine>
+//     auto calculate_normal_raw<Bits>(
+//             T init,
+//             Range const& range,
+//             Engine const& engine) noexcept ->
+//         T
+BOOST_AUTO_TEST_CASE(normal_clmul_engine_calculate)
+{
+	auto const mpeg2 = indi::crc::normal_clmul_engine<32>{polys::crc32};
+	auto const init = std::uint_fast32_t{0xFFFFFFFFu};
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<32>(init,
+		std::string{"123456789"}, mpeg2), 0x0376E6E7u);
+	
+	auto const data = random_bytes(5000u);
+	auto const expected = indi::crc::calculate_normal_raw<32>(init, data,
+		polys::crc32);
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<32>(init, data,
+		mpeg2), expected);
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<32>(init,
+		data.begin(), data.end(), mpeg2), expected);
+	
+	auto const xmodem = indi::crc::normal_clmul_engine<16>{
+		polys::crc16_ccitt};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<16>(
+		std::uint_fast16_t{0u}, data, xmodem),
+		indi::crc::calculate_normal_raw<16>(std::uint_fast16_t{0u}, data,
+			polys::crc16_ccitt));
+}
+
+// The folding constants only depend on the polynomial, so they can be
+// worked out at compile time.
+BOOST_AUTO_TEST_CASE(clmul_engine_constants)
+{
+	constexpr auto reflected = indi::crc::detail_::make_clmul_constants<32>(
+		polys::crc32k);
+	constexpr auto normal =
+		indi::crc::detail_::make_normal_clmul_constants<16>(
+			polys::crc16_t10_dif);
+	
+	// P' is P * x^32, in reflected form (without its x^64 term).
+	static_assert(reflected.polynomial ==
+		polys::reversed<32>(polys::crc32k), "");
+	BOOST_CHECK_EQUAL(normal.polynomial,
+		std::uint64_t{polys::crc16_t10_dif} << 48);
+}
+
+// The constants can be worked out once and shared between engines.
+BOOST_AUTO_TEST_CASE(clmul_engine_precomputed)
+{
+	auto const k32 = indi::crc::clmul_engine<32>::make_constants(
+		polys::crc32c);
+	auto const k64 = indi::crc::normal_clmul_engine<64>::make_constants(
+		polys::crc64_ecma);
+	check_precomputed(k32, k64);
+}
+
+#if __cplusplus >= 201703L
+// From C++17, the constants can be worked out at compile time.
+BOOST_AUTO_TEST_CASE(clmul_engine_precomputed_constexpr)
+{
+	static constexpr auto k32 = indi::crc::clmul_engine<32>::
+		make_constants(polys::crc32c);
+	static constexpr auto k64 = indi::crc::normal_clmul_engine<64>::
+		make_constants(polys::crc64_ecma);
+	check_precomputed(k32, k64);
+}
+#endif
+
+// A kernel the CPU doesn't support must fall back to one it does.
+BOOST_AUTO_TEST_CASE(clmul_engine_fallback)
+{
+	auto const table_engine = indi::crc::clmul_engine<32>{polys::crc32,
+		clmul_kernel::table};
+	BOOST_CHECK(table_engine.kernel() == clmul_kernel::table);
+	
+	// PSHUFB is no faster than the table, so it's never picked.
+	auto const automatic = indi::crc::clmul_engine<32>{polys::crc32};
+	BOOST_CHECK(automatic.kernel() != clmul_kernel::automatic);
+	BOOST_CHECK(automatic.kernel() != clmul_kernel::pshufb);
+	
+	// The shuffle kernels only do CRCs of up to 32 bits.
+	auto const wide = indi::crc::clmul_engine<64>{polys::crc64_ecma,
+		clmul_kernel::vpshufb};
+	BOOST_CHECK(wide.kernel() == clmul_kernel::table);
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename Range, typename Engine>
+//     auto calculate<Bits>(
+//             Range const& range,
+//             Engine const& engine) ->
+//         typename Engine::crc_type
+//     template <std::size_t Bits, typename InIt, typename Sen,
+//         typename Engine>
+//     auto calculate<Bits>(
+//             InIt first,
+//             Sen last,
+//             Engine const& engine) ->
+//         typename Engine::crc_type
+BOOST_AUTO_TEST_CASE(clmul_engine_calculate)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(indi::crc::calculate<32>(std::string{}, engine))>::value));
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(std::string{"123456789"},
+		engine), 0xE3069283u);
+	
+	auto const data = random_bytes(5000u);
+	auto const expected = indi::crc::calculate<32>(data, polys::crc32c);
+	
+	// Contiguous ranges and pointers.
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(data, engine), expected);
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(data.data(),
+		data.data() + data.size(), engine), expected);
+	
+	// Other iterators use the engine's table.
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(data.begin(), data.end(),
+		engine), expected);
+	auto const chars = std::string(data.begin(), data.end());
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(chars, engine), expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
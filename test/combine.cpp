@@ -0,0 +1,126 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indi/crc.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(combine_suite)
+
+// Testing for signature:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto combine<Bits>(
+//             T crc1,
+//             T crc2,
+//             std::uintmax_t length2,
+//             T polynomial) noexcept ->
+//         T
+BOOST_AUTO_TEST_CASE(combine_signature)
+{
+	BOOST_CHECK((std::is_same<
+		unsigned char,
+		decltype(indi::crc::combine<5>(static_cast<unsigned char>(0u),
+			static_cast<unsigned char>(0u), 0u,
+			static_cast<unsigned char>(0x15u)))>::value));
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(indi::crc::combine<32>(std::uint_fast32_t{},
+			std::uint_fast32_t{}, 0u, indi::crc::polynomials::crc32))>::
+				value));
+	
+	// Must be usable in constant expressions.
+	constexpr auto crc = indi::crc::combine<16>(std::uint_fast16_t{1u},
+		std::uint_fast16_t{2u}, 1000u, indi::crc::polynomials::crc16);
+	static_cast<void>(crc);
+}
+
+// Combining the CRCs of every split of a sequence must give the CRC of
+// the whole sequence.
+BOOST_AUTO_TEST_CASE(combine_splits)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const data = std::string{"The quick brown fox jumps over the "
+		"lazy dog"};
+	
+	auto const whole16 = indi::crc::calculate<16>(data, polys::crc16);
+	auto const whole32 = indi::crc::calculate<32>(data, polys::crc32c);
+	auto const whole64 = indi::crc::calculate<64>(data,
+		polys::crc64_ecma);
+	auto const poly5 = std::uint_fast8_t{0x09u};
+	auto const whole5 = indi::crc::calculate<5>(data, poly5);
+	
+	for (auto split = std::size_t{0}; split <= data.size(); ++split)
+	{
+		auto const a = data.substr(0, split);
+		auto const b = data.substr(split);
+		
+		BOOST_CHECK_EQUAL(indi::crc::combine<16>(
+			indi::crc::calculate<16>(a, polys::crc16),
+			indi::crc::calculate<16>(b, polys::crc16),
+			b.size(), polys::crc16), whole16);
+		BOOST_CHECK_EQUAL(indi::crc::combine<32>(
+			indi::crc::calculate<32>(a, polys::crc32c),
+			indi::crc::calculate<32>(b, polys::crc32c),
+			b.size(), polys::crc32c), whole32);
+		BOOST_CHECK_EQUAL(indi::crc::combine<64>(
+			indi::crc::calculate<64>(a, polys::crc64_ecma),
+			indi::crc::calculate<64>(b, polys::crc64_ecma),
+			b.size(), polys::crc64_ecma), whole64);
+		BOOST_CHECK_EQUAL(indi::crc::combine<5>(
+			indi::crc::calculate<5>(a, poly5),
+			indi::crc::calculate<5>(b, poly5),
+			b.size(), poly5), whole5);
+	}
+}
+
+// Raw CRCs combine too, if the second one starts from 0.
+BOOST_AUTO_TEST_CASE(combine_raw)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const data = std::vector<unsigned char>(100000u, 0xA5u);
+	auto const middle = data.begin() + 31337;
+	
+	auto const whole = indi::crc::calculate_raw<32>(0x12345678uL,
+		data.begin(), data.end(), polys::crc32);
+	auto const a = indi::crc::calculate_raw<32>(0x12345678uL,
+		data.begin(), middle, polys::crc32);
+	auto const b = indi::crc::calculate_raw<32>(0uL, middle, data.end(),
+		polys::crc32);
+	
+	BOOST_CHECK_EQUAL(indi::crc::combine<32>(a, b,
+		static_cast<std::uintmax_t>(data.end() - middle), polys::crc32),
+		whole);
+}
+
+// Combining with an empty sequence changes nothing.
+BOOST_AUTO_TEST_CASE(combine_empty)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	auto const empty = indi::crc::calculate<32>(std::string{},
+		polys::crc32);
+	
+	BOOST_CHECK_EQUAL(indi::crc::combine<32>(0xCBF43926uL, empty, 0u,
+		polys::crc32), 0xCBF43926uL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
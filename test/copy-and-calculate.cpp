@@ -0,0 +1,106 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-copy.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(copy_and_calculate_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T, typename Engine>
+//     auto copy_and_calculate_raw<Bits>(T init, void* dst,
+//             void const* src, std::size_t size,
+//             Engine const& engine) noexcept ->
+//         T
+//     template <std::size_t Bits, typename Engine>
+//     auto copy_and_calculate<Bits>(void* dst, void const* src,
+//             std::size_t size, Engine const& engine) noexcept ->
+//         typename Engine::crc_type
+BOOST_AUTO_TEST_CASE(copy_and_calculate_signature)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	unsigned char dst[1] = {};
+	
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(indi::crc::copy_and_calculate<32>(dst, "", 0u,
+			engine))>::value));
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(indi::crc::copy_and_calculate_raw<32>(
+			std::uint_fast32_t{0u}, dst, "", 0u, engine))>::value));
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_calculate_check_values)
+{
+	auto const crc32 = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const crc32c = indi::crc::braided_engine<32>{polys::crc32c};
+	char dst[10] = {};
+	
+	BOOST_CHECK_EQUAL(indi::crc::copy_and_calculate<32>(dst, "123456789",
+		9u, crc32), 0xCBF43926u);
+	BOOST_CHECK_EQUAL(dst, "123456789");
+	BOOST_CHECK_EQUAL(indi::crc::copy_and_calculate<32>(dst, "123456789",
+		9u, crc32c), 0xE3069283u);
+}
+
+// Sizes on both sides of the block size and the non-temporal store
+// threshold, at destinations with every alignment to a cache line.
+BOOST_AUTO_TEST_CASE(copy_and_calculate_sizes)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const src = random_bytes((std::size_t{1u} << 20) + 10000u);
+	auto dst = std::vector<unsigned char>(src.size() + 64u);
+	
+	for (auto const size : {std::size_t{0u}, std::size_t{1u},
+		std::size_t{4095u}, std::size_t{4096u}, std::size_t{10000u},
+		std::size_t{1u} << 20, src.size()})
+	{
+		for (auto const offset : {0u, 1u, 17u, 63u})
+		{
+			std::fill(dst.begin(), dst.end(), 0xA5u);
+			auto const crc = indi::crc::copy_and_calculate<32>(
+				dst.data() + offset, src.data(), size, engine);
+			
+			BOOST_CHECK_EQUAL(crc, indi::crc::calculate<32>(src.data(),
+				src.data() + size, engine));
+			BOOST_CHECK(std::equal(src.begin(), src.begin() + size,
+				dst.begin() + offset));
+			BOOST_CHECK(dst[offset + size] == 0xA5u);
+			BOOST_CHECK(offset == 0u || dst[offset - 1u] == 0xA5u);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
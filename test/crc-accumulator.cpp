@@ -0,0 +1,246 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-accumulator.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "indi/crc-braid.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Splits an object into chunks of random sizes, in a random order.
+auto random_chunks(std::size_t size, std::size_t most, unsigned seed)
+{
+	auto engine = std::mt19937{seed};
+	auto dist = std::uniform_int_distribution<std::size_t>{1u, most};
+	auto chunks = std::vector<std::pair<std::size_t, std::size_t>>{};
+	for (auto offset = std::size_t{0}; offset < size; )
+	{
+		auto const length = std::min(dist(engine), size - offset);
+		chunks.emplace_back(offset, length);
+		offset += length;
+	}
+	std::shuffle(chunks.begin(), chunks.end(), engine);
+	return chunks;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(crc_accumulator_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename Engine>
+//     class crc_accumulator
+//     {
+//     public:
+//         using crc_type = typename Engine::crc_type;
+//         crc_accumulator(std::uintmax_t size, std::size_t chunks,
+//             crc_type polynomial, Engine const& engine);
+//         auto add(std::uintmax_t offset, void const* data,
+//             std::size_t length) -> bool;
+//         auto done() const noexcept -> bool;
+//         auto crc() const noexcept -> crc_type;
+//         auto size() const noexcept -> std::uintmax_t;
+//     };
+BOOST_AUTO_TEST_CASE(crc_accumulator_signature)
+{
+	using accumulator = indi::crc::crc_accumulator<32,
+		indi::crc::clmul_engine<32>>;
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	accumulator acc{9u, 1u, polys::crc32, engine};
+	
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		accumulator::crc_type>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(acc.add(0u, "", 0u))>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(acc.done())>::value));
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(acc.crc())>::value));
+	BOOST_CHECK((std::is_same<std::uintmax_t,
+		decltype(acc.size())>::value));
+}
+
+BOOST_AUTO_TEST_CASE(crc_accumulator_check_values)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	indi::crc::crc_accumulator<32, decltype(engine)> acc{9u, 3u,
+		polys::crc32, engine};
+	
+	BOOST_CHECK(!acc.add(6u, "789", 3u));
+	BOOST_CHECK(!acc.add(0u, "123", 3u));
+	BOOST_CHECK(!acc.done());
+	BOOST_CHECK(acc.add(3u, "456", 3u));
+	BOOST_CHECK(acc.done());
+	BOOST_CHECK_EQUAL(acc.crc(), 0xCBF43926u);
+}
+
+BOOST_AUTO_TEST_CASE(crc_accumulator_empty)
+{
+	auto const engine = indi::crc::braided_engine<32>{polys::crc32c};
+	indi::crc::crc_accumulator<32, decltype(engine)> acc{0u, 0u,
+		polys::crc32c, engine};
+	
+	BOOST_CHECK(acc.done());
+	BOOST_CHECK_EQUAL(acc.crc(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(crc_accumulator_errors)
+{
+	auto const engine = indi::crc::braided_engine<32>{polys::crc32c};
+	indi::crc::crc_accumulator<32, decltype(engine)> acc{10u, 1u,
+		polys::crc32c, engine};
+	
+	BOOST_CHECK_THROW(acc.add(8u, "abc", 3u), std::out_of_range);
+	BOOST_CHECK_THROW(acc.add(11u, "", 0u), std::out_of_range);
+	BOOST_CHECK(!acc.add(0u, "abcde", 5u));
+	BOOST_CHECK_THROW(acc.add(5u, "fghij", 5u), std::length_error);
+}
+
+// A chunk added again, before and after the object is complete, is
+// ignored, even when another chunk of the same length is missing.
+BOOST_AUTO_TEST_CASE(crc_accumulator_duplicates)
+{
+	auto const engine = indi::crc::braided_engine<32>{polys::crc32};
+	indi::crc::crc_accumulator<32, decltype(engine)> acc{9u, 3u,
+		polys::crc32, engine};
+	
+	BOOST_CHECK(!acc.add(0u, "123", 3u));
+	BOOST_CHECK(!acc.add(0u, "123", 3u));
+	BOOST_CHECK(!acc.add(6u, "789", 3u));
+	BOOST_CHECK(!acc.add(6u, "789", 3u));
+	BOOST_CHECK(!acc.done());
+	BOOST_CHECK(acc.add(3u, "456", 3u));
+	BOOST_CHECK(!acc.add(3u, "456", 3u));
+	BOOST_CHECK(acc.done());
+	BOOST_CHECK_EQUAL(acc.crc(), 0xCBF43926u);
+}
+
+// Chunks of random sizes, in random orders, one thread.
+BOOST_AUTO_TEST_CASE(crc_accumulator_orders)
+{
+	auto const engine = indi::crc::braided_engine<64>{polys::crc64_ecma};
+	auto const data = random_bytes(20000u, 1u);
+	auto const expected = indi::crc::calculate<64>(data, engine);
+	
+	for (auto seed = 0u; seed < 20u; ++seed)
+	{
+		auto const chunks = random_chunks(data.size(), 1 + seed * 100u,
+			seed);
+		indi::crc::crc_accumulator<64, decltype(engine)> acc{
+			data.size(), chunks.size(), polys::crc64_ecma, engine};
+		
+		auto completed = 0u;
+		for (auto const& chunk : chunks)
+			completed += acc.add(chunk.first, data.data() + chunk.first,
+				chunk.second);
+		
+		BOOST_CHECK_EQUAL(completed, 1u);
+		BOOST_CHECK(acc.done());
+		BOOST_CHECK_EQUAL(acc.crc(), expected);
+	}
+}
+
+// The add that completes the object costs about as much as any other,
+// whatever order the chunks came in: here, in order, but with the first
+// one last. (The time of one add is too noisy to check on its own, so
+// it is checked against that of all of them, over up to three tries.)
+BOOST_AUTO_TEST_CASE(crc_accumulator_last_add)
+{
+	using clock = std::chrono::steady_clock;
+	
+	auto const engine = indi::crc::braided_engine<32>{polys::crc32c};
+	auto const chunks = std::size_t{20000u};
+	auto const data = random_bytes(16u * chunks, 3u);
+	auto const expected = indi::crc::calculate<32>(data, engine);
+	
+	auto quick = false;
+	for (auto run = 0; run < 3 && !quick; ++run)
+	{
+		indi::crc::crc_accumulator<32, decltype(engine)> acc{data.size(),
+			chunks, polys::crc32c, engine};
+		
+		auto const start = clock::now();
+		for (auto n = std::size_t{1}; n < chunks; ++n)
+			acc.add(16u * n, data.data() + 16u * n, 16u);
+		auto const last = clock::now();
+		BOOST_CHECK(acc.add(0u, data.data(), 16u));
+		auto const stop = clock::now();
+		
+		BOOST_CHECK_EQUAL(acc.crc(), expected);
+		quick = 100 * (stop - last) < stop - start;
+	}
+	
+	BOOST_CHECK(quick);
+}
+
+// Chunks added from several threads at once.
+BOOST_AUTO_TEST_CASE(crc_accumulator_threads)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	auto const data = random_bytes(1u << 20, 2u);
+	auto const expected = indi::crc::calculate<32>(data, engine);
+	
+	for (auto seed = 0u; seed < 10u; ++seed)
+	{
+		auto const chunks = random_chunks(data.size(), 5000u, seed);
+		indi::crc::crc_accumulator<32, decltype(engine)> acc{
+			data.size(), chunks.size(), polys::crc32c, engine};
+		
+		std::atomic<std::size_t> next{0u};
+		std::atomic<unsigned> completed{0u};
+		auto threads = std::vector<std::thread>{};
+		for (auto n = 0; n < 8; ++n)
+			threads.emplace_back([&]
+			{
+				for (auto i = next++; i < chunks.size(); i = next++)
+				{
+					auto const& chunk = chunks[i];
+					if (acc.add(chunk.first, data.data() + chunk.first,
+						chunk.second))
+						++completed;
+				}
+			});
+		for (auto& thread : threads)
+			thread.join();
+		
+		BOOST_CHECK_EQUAL(completed.load(), 1u);
+		BOOST_CHECK(acc.done());
+		BOOST_CHECK_EQUAL(acc.crc(), expected);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
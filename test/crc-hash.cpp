@@ -0,0 +1,159 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-hash.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct point
+{
+	std::int32_t x;
+	std::int32_t y;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(crc_hash_suite)
+
+BOOST_AUTO_TEST_CASE(hash_key_types)
+{
+	auto const text = std::string{"The quick brown fox"};
+	auto const bytes = std::vector<unsigned char>(text.begin(), text.end());
+	
+	// The same bytes hash the same, whatever holds them.
+	auto const h = indi::crc::hash<std::string>{}(text);
+	BOOST_CHECK_EQUAL(h, indi::crc::hash<std::vector<unsigned char>>{}(
+		bytes));
+	BOOST_CHECK_EQUAL(h, indi::crc::hash_bytes(text.data(), text.size()));
+	
+	// Ranges of wider elements hash their bytes.
+	auto const words = std::vector<std::uint32_t>{1u, 2u, 3u};
+	BOOST_CHECK_EQUAL(indi::crc::hash<std::vector<std::uint32_t>>{}(words),
+		indi::crc::hash_bytes(words.data(), 12u));
+	
+	// So do trivially copyable keys.
+	auto const p = point{3, -4};
+	BOOST_CHECK_EQUAL(indi::crc::hash<point>{}(p),
+		indi::crc::hash_bytes(&p, sizeof(p)));
+	auto const id = std::uint64_t{0x0123456789ABCDEFu};
+	BOOST_CHECK_EQUAL(indi::crc::hash<std::uint64_t>{}(id),
+		indi::crc::hash_bytes(&id, sizeof(id)));
+	
+	// Fixed-size arrays are ranges.
+	auto const key = std::array<unsigned char, 3>{{'a', 'b', 'c'}};
+	BOOST_CHECK_EQUAL((indi::crc::hash<std::array<unsigned char, 3>>{}(
+		key)), indi::crc::hash_bytes("abc", 3u));
+}
+
+BOOST_AUTO_TEST_CASE(hash_seeds)
+{
+	auto const key = std::string{"shard-key-000042"};
+	auto const unseeded = indi::crc::hash<std::string>{};
+	auto const seeded = indi::crc::hash<std::string>{0x1234u};
+	auto const high = indi::crc::hash<std::string>{
+		std::uint64_t{0x1234u} << 32};
+	
+	BOOST_CHECK_EQUAL(unseeded.seed(), 0u);
+	BOOST_CHECK_EQUAL(seeded.seed(), 0x1234u);
+	BOOST_CHECK_NE(unseeded(key), seeded(key));
+	BOOST_CHECK_NE(seeded(key), high(key));
+	BOOST_CHECK_EQUAL(seeded(key), indi::crc::hash<std::string>{0x1234u}(
+		key));
+}
+
+// Hashes stay the same from one version to the next.
+BOOST_AUTO_TEST_CASE(hash_check_values)
+{
+	BOOST_CHECK_EQUAL(indi::crc::hash_bytes("", 0u),
+		std::uint64_t{0x70E5E91EC8D7B13Fu});
+	BOOST_CHECK_EQUAL(indi::crc::hash_bytes("123456789", 9u),
+		std::uint64_t{0xF79A54BC356081B6u});
+	BOOST_CHECK_EQUAL(indi::crc::hash_bytes("123456789", 9u, 0x1234u),
+		std::uint64_t{0x3BE8B6F492730C92u});
+}
+
+// Keys that differ only in length or trailing zeros hash differently.
+BOOST_AUTO_TEST_CASE(hash_lengths)
+{
+	auto const zeros = std::vector<unsigned char>(40u);
+	auto hashes = std::unordered_set<std::uint64_t>{};
+	for (auto length = std::size_t{0}; length <= zeros.size(); ++length)
+		hashes.insert(indi::crc::hash_bytes(zeros.data(), length));
+	BOOST_CHECK_EQUAL(hashes.size(), zeros.size() + 1u);
+}
+
+// The CRC32 instruction and the table give the same hashes.
+BOOST_AUTO_TEST_CASE(hash_table_matches_instruction)
+{
+	auto data = std::vector<unsigned char>(64u);
+	for (auto n = std::size_t{0}; n < data.size(); ++n)
+		data[n] = static_cast<unsigned char>(n * 29u + 7u);
+	
+	auto a1 = std::uint32_t{0x01234567u};
+	auto b1 = std::uint32_t{0x89ABCDEFu};
+	indi::crc::detail_::hash_table(a1, b1, data.data(), 8u);
+	
+	// The first CRC is CRC-32C, raw.
+	BOOST_CHECK_EQUAL(a1, indi::crc::calculate_raw<32>(
+		std::uint_fast32_t{0x01234567u}, data.data(),
+		data.data() + data.size(),
+		indi::crc::generate_table<32>(indi::crc::polynomials::crc32c)));
+	
+#if INDI_CRC_HAVE_HASH_SSE42
+	if (indi::crc::detail_::cpu().sse42)
+	{
+		auto a2 = std::uint32_t{0x01234567u};
+		auto b2 = std::uint32_t{0x89ABCDEFu};
+		indi::crc::detail_::hash_sse42(a2, b2, data.data(), 8u);
+		BOOST_CHECK_EQUAL(a1, a2);
+		BOOST_CHECK_EQUAL(b1, b2);
+		
+		// Including the zero-padded last word.
+		for (auto length = std::size_t{0}; length <= data.size(); ++length)
+			BOOST_CHECK_EQUAL(
+				indi::crc::detail_::hash_bytes_table(data.data(), length,
+					0x01234567u, 0x89ABCDEFu),
+				indi::crc::detail_::hash_bytes_sse42(data.data(), length,
+					0x01234567u, 0x89ABCDEFu));
+	}
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(hash_unordered_map)
+{
+	auto map = std::unordered_map<std::string, int,
+		indi::crc::hash<std::string>>{};
+	for (auto n = 0; n < 1000; ++n)
+		map[std::to_string(n)] = n;
+	
+	BOOST_CHECK_EQUAL(map.size(), 1000u);
+	for (auto n = 0; n < 1000; ++n)
+		BOOST_CHECK_EQUAL(map.at(std::to_string(n)), n);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
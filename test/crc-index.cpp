@@ -0,0 +1,167 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indi/crc-index.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto load_file(std::string const& path)
+{
+	auto in = std::ifstream{path, std::ios::binary};
+	return std::vector<unsigned char>{std::istreambuf_iterator<char>{in},
+		std::istreambuf_iterator<char>{}};
+}
+
+auto save_file(std::string const& path,
+	std::vector<unsigned char> const& data)
+{
+	auto out = std::ofstream{path, std::ios::binary | std::ios::trunc};
+	out.write(reinterpret_cast<char const*>(data.data()),
+		static_cast<std::streamsize>(data.size()));
+}
+
+// A copy of a test data file, and its index, removed afterwards.
+struct index_files
+{
+	index_files() :
+		data(load_file("data/table-crc32"))
+	{
+		save_file(file, data);
+	}
+	
+	~index_files()
+	{
+		std::remove(file.c_str());
+		std::remove(index.c_str());
+	}
+	
+	std::vector<unsigned char> const data;
+	std::string const file = "index-test.tmp";
+	std::string const index = "index-test.idx";
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(crc_index_suite)
+
+BOOST_FIXTURE_TEST_CASE(crc_index_build, index_files)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	BOOST_REQUIRE_EQUAL(data.size(), 2816u);
+	
+	// 2816 bytes in 100-byte blocks: 28 full blocks and a short one.
+	auto const file_crc = indi::crc::build_index<32>(file, index,
+		polys::crc32, 100u, 4u);
+	BOOST_CHECK_EQUAL(file_crc, indi::crc::calculate<32>(data,
+		polys::crc32));
+	
+	auto const idx = indi::crc::crc_index{index};
+	BOOST_CHECK_EQUAL(idx.header().bits, 32u);
+	BOOST_CHECK_EQUAL(idx.header().polynomial, polys::crc32);
+	BOOST_CHECK_EQUAL(idx.header().file_size, data.size());
+	BOOST_CHECK_EQUAL(idx.header().file_crc, file_crc);
+	BOOST_REQUIRE_EQUAL(idx.block_count(), 29u);
+	BOOST_CHECK_EQUAL(idx.block_length(28), 16u);
+	
+	for (auto n = std::size_t{0}; n < 29u; ++n)
+	{
+		auto const first = data.begin() + static_cast<long>(n * 100u);
+		auto const last = data.begin() + static_cast<long>(
+			std::min<std::size_t>((n + 1u) * 100u, data.size()));
+		BOOST_CHECK_EQUAL(idx.block_crcs()[n], indi::crc::calculate<32>(
+			first, last, polys::crc32));
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(crc_index_verify, index_files)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	indi::crc::build_index<64>(file, index, polys::crc64_ecma, 100u);
+	auto const idx = indi::crc::crc_index{index};
+	
+	{
+		auto const fd = indi::crc::open_file(file);
+		BOOST_CHECK(indi::crc::verify_blocks<64>(fd.get(), idx, 0u,
+			UINT64_MAX).empty());
+	}
+	
+	// Corrupt blocks 3 and 17.
+	auto corrupt = data;
+	corrupt[350] ^= 0x01u;
+	corrupt[1799] ^= 0x80u;
+	save_file(file, corrupt);
+	
+	auto const fd = indi::crc::open_file(file);
+	
+	auto const all = indi::crc::verify_blocks<64>(fd.get(), idx, 0u,
+		UINT64_MAX, 3u);
+	BOOST_CHECK((all == std::vector<std::uint64_t>{3u, 17u}));
+	
+	// Resuming past the first bad block.
+	auto const rest = indi::crc::verify_blocks<64>(fd.get(), idx, 4u,
+		UINT64_MAX);
+	BOOST_CHECK((rest == std::vector<std::uint64_t>{17u}));
+	
+	// Only the blocks the range touches are checked.
+	BOOST_CHECK(indi::crc::verify_range<64>(fd.get(), idx, 0u, 300u)
+		.empty());
+	auto const range = indi::crc::verify_range<64>(fd.get(), idx, 299u,
+		2u);
+	BOOST_CHECK((range == std::vector<std::uint64_t>{3u}));
+	BOOST_CHECK(indi::crc::verify_range<64>(fd.get(), idx, 5000u, 10u)
+		.empty());
+	
+	BOOST_CHECK_THROW(indi::crc::verify_blocks<32>(fd.get(), idx, 0u, 1u),
+		std::invalid_argument);
+}
+
+BOOST_FIXTURE_TEST_CASE(crc_index_truncated, index_files)
+{
+	namespace polys = indi::crc::polynomials;
+	
+	indi::crc::build_index<32>(file, index, polys::crc32c, 1024u);
+	auto const idx = indi::crc::crc_index{index};
+	
+	save_file(file, std::vector<unsigned char>(data.begin(),
+		data.begin() + 2000));
+	
+	auto const fd = indi::crc::open_file(file);
+	auto const bad = indi::crc::verify_blocks<32>(fd.get(), idx, 0u,
+		UINT64_MAX);
+	BOOST_CHECK((bad == std::vector<std::uint64_t>{1u, 2u}));
+}
+
+BOOST_FIXTURE_TEST_CASE(crc_index_invalid, index_files)
+{
+	BOOST_CHECK_THROW(indi::crc::crc_index{file}, std::runtime_error);
+	BOOST_CHECK_THROW(indi::crc::crc_index{"no-such-index"},
+		std::system_error);
+	BOOST_CHECK_THROW(indi::crc::build_index<32>(file, index, 0x04C11DB7u,
+		0u), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-slot.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(key_slot_suite)
+
+// Values from Redis (CLUSTER KEYSLOT).
+BOOST_AUTO_TEST_CASE(key_slot_values)
+{
+	BOOST_CHECK_EQUAL(indi::crc::key_slot(std::string{"foo"}), 12182u);
+	BOOST_CHECK_EQUAL(indi::crc::key_slot(std::string{"bar"}), 5061u);
+	BOOST_CHECK_EQUAL(indi::crc::key_slot(std::string{"hello"}), 866u);
+	BOOST_CHECK_EQUAL(indi::crc::key_slot(std::string{}), 0u);
+	
+	// CRC-16/XMODEM check value 0x31C3, modulo 16384.
+	BOOST_CHECK_EQUAL(indi::crc::key_slot("123456789", 9u), 0x31C3u);
+	
+	// The same as the generic non-reflected CRC.
+	auto const key = std::string{"user:1000:followers"};
+	auto const table = indi::crc::generate_normal_table<16>(
+		indi::crc::polynomials::crc16_ccitt);
+	BOOST_CHECK_EQUAL(indi::crc::key_slot(key),
+		indi::crc::calculate_normal_raw<16>(std::uint_fast16_t{0u}, key,
+			table) % indi::crc::key_slot_count);
+}
+
+// Hash tag rules, from the Redis cluster specification.
+BOOST_AUTO_TEST_CASE(key_slot_hash_tags)
+{
+	auto const slot = [](char const* key)
+	{
+		return indi::crc::key_slot(std::string{key});
+	};
+	
+	BOOST_CHECK_EQUAL(slot("{user1000}.following"), slot("user1000"));
+	BOOST_CHECK_EQUAL(slot("{user1000}.followers"), slot("user1000"));
+	BOOST_CHECK_EQUAL(slot("foo{bar}{zap}"), slot("bar"));
+	BOOST_CHECK_EQUAL(slot("foo{{bar}}zap"), slot("{bar"));
+	
+	// An empty tag, or none, means the whole key.
+	BOOST_CHECK_EQUAL(slot("foo{}{bar}"),
+		indi::crc::key_slot("foo{}{bar}", 10u));
+	BOOST_CHECK_NE(slot("foo{}{bar}"), slot("bar"));
+	BOOST_CHECK_NE(slot("foo{bar"), slot("bar"));
+	BOOST_CHECK_NE(slot("foo}bar{"), slot("bar"));
+}
+
+BOOST_AUTO_TEST_CASE(key_slots_batch)
+{
+	auto keys = std::vector<std::string>{};
+	for (auto n = 0; n < 103; ++n)
+	{
+		auto key = "key:" + std::to_string(n * 7919) + std::string(
+			static_cast<std::size_t>(n % 13), 'x');
+		if (n % 5 == 0)
+			key = "{tag" + std::to_string(n % 3) + "}" + key;
+		keys.push_back(key);
+	}
+	keys.push_back("");
+	
+	auto pointers = std::vector<char const*>{};
+	auto lengths = std::vector<std::size_t>{};
+	for (auto const& key : keys)
+	{
+		pointers.push_back(key.data());
+		lengths.push_back(key.size());
+	}
+	
+	auto slots = std::vector<std::uint_fast16_t>(keys.size());
+	indi::crc::key_slots(pointers.data(), lengths.data(), keys.size(),
+		slots.data());
+	
+	for (auto n = std::size_t{0}; n < keys.size(); ++n)
+		BOOST_CHECK_EQUAL(slots[n], indi::crc::key_slot(keys[n]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-nibble.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Checks both kinds of engine against 256-element tables.
+template <std::size_t Bits, typename T>
+auto check_engines(T polynomial)
+{
+	auto const data = random_bytes(1000u);
+	auto const init = T(0x5A5A5A5A5A5A5A5AuLL & indi::crc::detail_::ones<
+		Bits, T>());
+	
+	auto const reflected = indi::crc::nibble_engine<Bits, T>{polynomial};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_raw<Bits>(init, data,
+		reflected), indi::crc::calculate_raw<Bits>(init, data,
+		polynomial));
+	
+	auto const normal = indi::crc::normal_nibble_engine<Bits, T>{
+		polynomial};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<Bits>(init, data,
+		normal), indi::crc::calculate_normal_raw<Bits>(init, data,
+		polynomial));
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(nibble_engine_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto generate_nibble_table<Bits>(
+//             T polynomial) noexcept ->
+//         std::array<T, 16>
+//     template <std::size_t Bits, typename T>
+//     constexpr auto generate_normal_nibble_table<Bits>(
+//             T polynomial) noexcept ->
+//         std::array<T, 16>
+BOOST_AUTO_TEST_CASE(generate_nibble_table_values)
+{
+	BOOST_CHECK((std::is_same<
+		std::array<std::uint_fast32_t, 16>,
+		decltype(indi::crc::generate_nibble_table<32>(polys::crc32))>::
+			value));
+	
+	// A nibble at the top of a byte shifts straight through the first
+	// four steps of a byte lookup, so the entries match those of the
+	// full tables.
+	auto const table = indi::crc::generate_table<32>(polys::crc32);
+	auto const nibble_table = indi::crc::generate_nibble_table<32>(
+		polys::crc32);
+	auto const normal_table = indi::crc::generate_normal_table<32>(
+		polys::crc32);
+	auto const normal_nibble_table =
+		indi::crc::generate_normal_nibble_table<32>(polys::crc32);
+	
+	for (auto n = std::size_t{0}; n < 16u; ++n)
+	{
+		BOOST_CHECK_EQUAL(nibble_table[n], table[n << 4]);
+		BOOST_CHECK_EQUAL(normal_nibble_table[n], normal_table[n]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(nibble_engine_sizes)
+{
+	// The table is packed, so it fits in a cache line up to 32 bits.
+	BOOST_CHECK_EQUAL(sizeof(indi::crc::nibble_engine<8>::table_type),
+		16u);
+	BOOST_CHECK_EQUAL(sizeof(indi::crc::nibble_engine<16>::table_type),
+		32u);
+	BOOST_CHECK_EQUAL(sizeof(indi::crc::nibble_engine<32>::table_type),
+		64u);
+	BOOST_CHECK_EQUAL(sizeof(indi::crc::nibble_engine<64>::table_type),
+		128u);
+}
+
+BOOST_AUTO_TEST_CASE(nibble_engine_values)
+{
+	check_engines<3>(std::uint_fast8_t{0x3u});
+	check_engines<4>(std::uint_fast8_t{0x3u});
+	check_engines<5>(std::uint_fast8_t{0x09u});
+	check_engines<8>(std::uint_fast8_t{0x07u});
+	check_engines<12>(std::uint_fast16_t{0x80Fu});
+	check_engines<16>(polys::crc16_ccitt);
+	check_engines<16>(polys::crc16_ibm);
+	check_engines<32>(polys::crc32);
+	check_engines<32>(polys::crc32c);
+	check_engines<64>(polys::crc64_ecma);
+}
+
+BOOST_AUTO_TEST_CASE(nibble_engine_calculate)
+{
+	auto const engine = indi::crc::nibble_engine<32>{polys::crc32};
+	auto const check = std::string{"123456789"};
+	
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(check, engine),
+		0xCBF43926u);
+	
+	// Sequences that aren't contiguous bytes, longer than the buffer
+	// they're copied to.
+	auto const data = random_bytes(1000u);
+	auto const list = std::list<unsigned char>(data.begin(), data.end());
+	BOOST_CHECK_EQUAL(indi::crc::calculate<32>(list, engine),
+		indi::crc::calculate<32>(data, polys::crc32));
+	
+	auto const xmodem = indi::crc::normal_nibble_engine<16>{
+		polys::crc16_ccitt};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<16>(
+		std::uint_fast16_t{0u}, check, xmodem), 0x31C3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
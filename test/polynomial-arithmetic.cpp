@@ -0,0 +1,133 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+BOOST_AUTO_TEST_SUITE(polynomial_arithmetic_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto x_pow_mod<Bits>(
+//             std::uintmax_t n,
+//             T polynomial) noexcept ->
+//         T
+//     template <std::size_t Bits, typename T>
+//     constexpr auto x_pow_mod_normal<Bits>(
+//             std::uintmax_t n,
+//             T polynomial) noexcept ->
+//         T
+BOOST_AUTO_TEST_CASE(x_pow_mod_values)
+{
+	namespace polys = indi::crc::polynomials;
+	using indi::crc::x_pow_mod;
+	using indi::crc::x_pow_mod_normal;
+	
+	BOOST_CHECK((std::is_same<
+		std::uint_fast32_t,
+		decltype(x_pow_mod<32>(0u, polys::crc32))>::value));
+	
+	// Must be usable in constant expressions.
+	constexpr auto k1 = x_pow_mod_normal<32>(4u * 128u + 64u,
+		polys::crc32);
+	static_assert(k1 == 0x8833794Cu, "x^576 mod P");
+	
+	// The folding constants for CRC-32 from Intel's white paper
+	// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ".
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(4u * 128u, polys::crc32),
+		0xE6228B11u);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(128u + 64u, polys::crc32),
+		0xC5B9CD4Cu);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(128u, polys::crc32),
+		0xE8A45605u);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(96u, polys::crc32),
+		0xF200AA66u);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(64u, polys::crc32),
+		0x490D678Du);
+	
+	// Small powers don't need reducing, or reduce to the polynomial.
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(0u, polys::crc32), 1u);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(31u, polys::crc32),
+		0x80000000u);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(32u, polys::crc32),
+		polys::crc32);
+	BOOST_CHECK_EQUAL(x_pow_mod<32>(0u, polys::crc32), 0x80000000u);
+	BOOST_CHECK_EQUAL(x_pow_mod<32>(31u, polys::crc32), 1u);
+	BOOST_CHECK_EQUAL(x_pow_mod<32>(32u, polys::crc32),
+		polys::reversed<32>(polys::crc32));
+	
+	// Other polynomials and widths.
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<32>(1000u, polys::crc32k),
+		0xB1D84704u);
+	BOOST_CHECK_EQUAL(x_pow_mod<32>(1000u, polys::crc32k), 0x20E21B8Du);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<16>(1000u, polys::crc16_t10_dif),
+		0x74C6u);
+	BOOST_CHECK_EQUAL(x_pow_mod<16>(1000u, polys::crc16_t10_dif),
+		0x632Eu);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<64>(1000u, polys::crc64_ecma),
+		0xB0CFACA967115E09uLL);
+	BOOST_CHECK_EQUAL(x_pow_mod<64>(1000u, polys::crc64_ecma),
+		0x907A88E69535F30DuLL);
+	BOOST_CHECK_EQUAL(x_pow_mod_normal<5>(1000u, std::uint_fast8_t{0x09u}),
+		0x1Au);
+	BOOST_CHECK_EQUAL(x_pow_mod<5>(1000u, std::uint_fast8_t{0x09u}),
+		0x0Bu);
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto barrett_mu<Bits>(
+//             T polynomial) noexcept ->
+//         T
+//     template <std::size_t Bits, typename T>
+//     constexpr auto barrett_mu_normal<Bits>(
+//             T polynomial) noexcept ->
+//         T
+BOOST_AUTO_TEST_CASE(barrett_mu_values)
+{
+	namespace polys = indi::crc::polynomials;
+	using indi::crc::barrett_mu;
+	using indi::crc::barrett_mu_normal;
+	
+	// Must be usable in constant expressions.
+	constexpr auto mu = barrett_mu_normal<32>(polys::crc32);
+	static_assert(mu == 0x04D101DFu, "floor(x^64 / P) - x^32");
+	
+	// The Intel white paper gives these with the x^32 term, as
+	// 0x104D101DF, and reflected over 33 bits, as 0x1F7011641.
+	BOOST_CHECK_EQUAL(barrett_mu<32>(polys::crc32), 0xFB808B20u);
+	
+	BOOST_CHECK_EQUAL(barrett_mu_normal<32>(polys::crc32k), 0x669897D0u);
+	BOOST_CHECK_EQUAL(barrett_mu<32>(polys::crc32k), 0x0BE91966u);
+	BOOST_CHECK_EQUAL(barrett_mu_normal<16>(polys::crc16_t10_dif),
+		0xF65Au);
+	BOOST_CHECK_EQUAL(barrett_mu<16>(polys::crc16_t10_dif), 0x5A6Fu);
+	BOOST_CHECK_EQUAL(barrett_mu_normal<64>(polys::crc64_ecma),
+		0x578D29D06CC4F872uLL);
+	BOOST_CHECK_EQUAL(barrett_mu<64>(polys::crc64_ecma),
+		0x4E1F23360B94B1EAuLL);
+	BOOST_CHECK_EQUAL(barrett_mu_normal<5>(std::uint_fast8_t{0x09u}),
+		0x0Bu);
+	BOOST_CHECK_EQUAL(barrett_mu<5>(std::uint_fast8_t{0x09u}), 0x1Au);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
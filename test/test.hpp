@@ -0,0 +1,101 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TEST_TEST_
+#define INDI_INC_CRC_TEST_TEST_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace indi {
+namespace crc {
+namespace test {
+
+//! Fills a buffer with pseudo-random bytes (the same ones every run for
+//! the same seed).
+inline auto random_bytes(std::size_t size, unsigned seed = 12345u)
+{
+	auto engine = std::mt19937{seed};
+	auto dist = std::uniform_int_distribution<unsigned>{0u, 255u};
+	auto data = std::vector<unsigned char>(size);
+	for (auto& b : data)
+		b = static_cast<unsigned char>(dist(engine));
+	return data;
+}
+
+//! Writes a file, replacing anything already there.
+inline auto write_file(std::string const& path, std::string const& contents)
+{
+	auto out = std::ofstream{path, std::ios::binary | std::ios::trunc};
+	out << contents;
+}
+
+//! Reads a whole file.
+inline auto read_file(std::string const& path)
+{
+	auto in = std::ifstream{path, std::ios::binary};
+	auto s = std::ostringstream{};
+	s << in.rdbuf();
+	return s.str();
+}
+
+//! Gets a file's status.
+//! 
+//! \throws std::system_error if there is none.
+inline auto stat_file(std::string const& path)
+{
+	struct ::stat st;
+	if (::stat(path.c_str(), &st) != 0)
+		throw std::system_error{errno, std::generic_category(), path};
+	return st;
+}
+
+//! Removes files, and empty directories, when it goes out of scope, in
+//! the order they are given (so a directory goes after what's in it),
+//! so that tests clean up after themselves even when they fail.
+struct temp_paths
+{
+	temp_paths(std::initializer_list<std::string> paths) :
+		paths(paths)
+	{}
+	
+	temp_paths(temp_paths const&) = delete;
+	auto operator=(temp_paths const&) -> temp_paths& = delete;
+	
+	~temp_paths()
+	{
+		for (auto const& path : paths)
+			std::remove(path.c_str());
+	}
+	
+	std::vector<std::string> const paths;
+};
+
+} // namespace test
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,188 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tool/manifest.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "test.hpp"
+
+namespace {
+
+using namespace indi::crc::tool;
+using indi::crc::test::write_file;
+
+// Writes a manifest, and removes it again, even if a test fails.
+struct temp_manifest
+{
+	temp_manifest(std::string const& name, std::string const& contents) :
+		path{name}
+	{
+		write_file(path, contents);
+	}
+	
+	std::string const path;
+	indi::crc::test::temp_paths const cleanup{path};
+};
+
+auto read(std::string const& name, std::string const& contents,
+	format f, char const* default_model = "crc32")
+{
+	temp_manifest const file{name, contents};
+	manifest m;
+	read_manifest(file.path, f, *find_model(default_model), m);
+	return m;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(tool_manifest_suite)
+
+// Testing for signatures:
+//     auto read_manifest(std::string const& path, format f,
+//         model const& default_model, manifest& m) -> void;
+
+BOOST_AUTO_TEST_CASE(cksum_test)
+{
+	auto const m = read("manifest-test.txt",
+		"3421780262 9 check.txt\n"
+		"\n"
+		"0 0 a file with spaces\r\n", format::cksum, "crc32c");
+	
+	BOOST_REQUIRE(m.entries.size() == 2u);
+	BOOST_TEST(m.entries[0].path == std::string{"check.txt"});
+	BOOST_TEST(m.entries[0].size == 9u);
+	BOOST_TEST(m.entries[0].crc == 0xCBF43926u);
+	BOOST_TEST(m.entries[0].crc_model == find_model("crc32c"));
+	BOOST_TEST(m.entries[1].path == std::string{"a file with spaces"});
+	BOOST_TEST(m.entries[1].size == 0u);
+	BOOST_TEST(m.entries[1].crc == 0u);
+	
+	BOOST_CHECK_THROW(read("manifest-test.txt", "1 2\n", format::cksum),
+		std::runtime_error);
+	BOOST_CHECK_THROW(read("manifest-test.txt", "1 x a\n", format::cksum),
+		std::runtime_error);
+	BOOST_CHECK_THROW(read("manifest-test.txt", "1 2 \n", format::cksum),
+		std::runtime_error);
+	BOOST_CHECK_THROW(read("manifest-test.txt",
+		"99999999999999999999 2 a\n", format::cksum), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(sfv_test)
+{
+	auto const m = read("manifest-test.sfv",
+		"; a comment\n"
+		"check.txt CBF43926\n"
+		"a file with spaces 00000000\n", format::sfv);
+	
+	BOOST_REQUIRE(m.entries.size() == 2u);
+	BOOST_TEST(m.entries[0].path == std::string{"check.txt"});
+	BOOST_TEST(m.entries[0].size == unknown_size);
+	BOOST_TEST(m.entries[0].crc == 0xCBF43926u);
+	BOOST_TEST(m.entries[0].crc_model == find_model("crc32"));
+	BOOST_TEST(m.entries[1].path == std::string{"a file with spaces"});
+	BOOST_TEST(m.entries[1].crc == 0u);
+	
+	BOOST_CHECK_THROW(read("manifest-test.sfv", "CBF43926\n", format::sfv),
+		std::runtime_error);
+	BOOST_CHECK_THROW(read("manifest-test.sfv", "a CBF4392G\n",
+		format::sfv), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(json_test)
+{
+	auto const m = read("manifest-test.json",
+		"[\n"
+		"  {\"path\": \"check.txt\", \"size\": 9, \"model\": \"crc32c\", "
+			"\"crc\": \"e3069283\"},\n"
+		"  {\"crc\": \"cbf43926\", \"extra\": [1, {\"x\": null}], "
+			"\"path\": \"a\\\"b\\\\c\\u00e9\"}\n"
+		"]\n", format::json);
+	
+	BOOST_REQUIRE(m.entries.size() == 2u);
+	BOOST_TEST(m.entries[0].path == std::string{"check.txt"});
+	BOOST_TEST(m.entries[0].size == 9u);
+	BOOST_TEST(m.entries[0].crc == 0xE3069283u);
+	BOOST_TEST(m.entries[0].crc_model == find_model("crc32c"));
+	BOOST_TEST(m.entries[1].path == std::string{"a\"b\\c\xC3\xA9"});
+	BOOST_TEST(m.entries[1].size == unknown_size);
+	BOOST_TEST(m.entries[1].crc == 0xCBF43926u);
+	BOOST_TEST(m.entries[1].crc_model == find_model("crc32"));
+	
+	BOOST_TEST(read("manifest-test.json", "[]", format::json)
+		.entries.empty());
+	
+	for (auto const bad : {
+		"",
+		"[",
+		"[{\"path\": \"a\"}]",
+		"[{\"path\": \"a\", \"crc\": \"xyz\"}]",
+		"[{\"path\": \"a\", \"crc\": \"1\", \"model\": \"crc99\"}]",
+		"[{\"path\": \"a\", \"crc\": \"1\"}] x"})
+	{
+		BOOST_CHECK_THROW(read("manifest-test.json", bad, format::json),
+			std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(appending_test)
+{
+	temp_manifest const first{"manifest-test.txt", "0 0 a\n"};
+	temp_manifest const second{"manifest-test.sfv", "b 00000001\n"};
+	
+	manifest m;
+	read_manifest(first.path, format::cksum, *find_model("crc32"), m);
+	read_manifest(second.path, format::sfv, *find_model("crc32"), m);
+	
+	BOOST_REQUIRE(m.entries.size() == 2u);
+	BOOST_TEST(m.entries[0].path == std::string{"a"});
+	BOOST_TEST(m.entries[1].path == std::string{"b"});
+	
+	BOOST_CHECK_THROW(read_manifest("manifest-test.missing", format::sfv,
+		*find_model("crc32"), m), std::system_error);
+}
+
+// Testing for signatures:
+//     auto detect_format(std::string const& path) -> format;
+
+BOOST_AUTO_TEST_CASE(detect_format_test)
+{
+	auto const detect = [](std::string const& name,
+		std::string const& contents)
+	{
+		temp_manifest const file{name, contents};
+		return detect_format(file.path);
+	};
+	
+	// By extension first.
+	BOOST_TEST((detect("manifest-test.sfv", "1 2 a\n") == format::sfv));
+	BOOST_TEST((detect("manifest-test.json", "1 2 a\n") == format::json));
+	
+	// Then by contents.
+	BOOST_TEST((detect("manifest-test.txt", "  [\n") == format::json));
+	BOOST_TEST((detect("manifest-test.txt", "1 2 a\n") == format::cksum));
+	BOOST_TEST((detect("manifest-test.txt", "a 1\n") == format::sfv));
+	
+	BOOST_CHECK_THROW(detect_format("manifest-test.missing"),
+		std::system_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,203 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tool/options.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace indi::crc::tool;
+
+// Parses a command line given as a list of arguments (without the
+// program name).
+auto parse(std::initializer_list<char const*> args)
+{
+	auto argv = std::vector<char const*>{"indi-crc"};
+	argv.insert(argv.end(), args);
+	argv.push_back(nullptr);
+	return parse_command_line(static_cast<int>(argv.size() - 1),
+		argv.data());
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(tool_options_suite)
+
+// Testing for signatures:
+//     auto parse_number(std::string const& s, std::uint_least64_t& value,
+//         std::string& suffix) -> bool;
+//     auto parse_size(std::string const& s, std::uint_least64_t& size)
+//         -> bool;
+
+BOOST_AUTO_TEST_CASE(parse_number_test)
+{
+	auto value = std::uint_least64_t{};
+	auto suffix = std::string{};
+	
+	BOOST_TEST(parse_number("42", value, suffix));
+	BOOST_TEST(value == 42u);
+	BOOST_TEST(suffix == "");
+	
+	BOOST_TEST(parse_number("50%", value, suffix));
+	BOOST_TEST(value == 50u);
+	BOOST_TEST(suffix == "%");
+	
+	BOOST_TEST(parse_number("18446744073709551615", value, suffix));
+	BOOST_TEST(value == 18446744073709551615u);
+	
+	BOOST_TEST(!parse_number("", value, suffix));
+	BOOST_TEST(!parse_number("-1", value, suffix));
+	BOOST_TEST(!parse_number("+1", value, suffix));
+	BOOST_TEST(!parse_number(" 1", value, suffix));
+	BOOST_TEST(!parse_number("18446744073709551616", value, suffix));
+}
+
+BOOST_AUTO_TEST_CASE(parse_size_test)
+{
+	auto size = std::uint_least64_t{};
+	
+	BOOST_TEST(parse_size("0", size));
+	BOOST_TEST(size == 0u);
+	BOOST_TEST(parse_size("3K", size));
+	BOOST_TEST(size == 3u << 10);
+	BOOST_TEST(parse_size("3m", size));
+	BOOST_TEST(size == 3u << 20);
+	BOOST_TEST(parse_size("3G", size));
+	BOOST_TEST(size == std::uint_least64_t{3u} << 30);
+	
+	// The largest sizes that fit, and the smallest that don't.
+	BOOST_TEST(parse_size("17179869183G", size));
+	BOOST_TEST(size == std::uint_least64_t{17179869183u} << 30);
+	BOOST_TEST(!parse_size("17179869184G", size));
+	BOOST_TEST(!parse_size("18014398509481984K", size));
+	BOOST_TEST(!parse_size("99999999999999999999", size));
+	
+	BOOST_TEST(!parse_size("3T", size));
+	BOOST_TEST(!parse_size("3KB", size));
+	BOOST_TEST(!parse_size("K", size));
+}
+
+// Testing for signatures:
+//     auto parse_command_line(int argc, char const* const argv[])
+//         -> command_line;
+
+BOOST_AUTO_TEST_CASE(defaults_test)
+{
+	auto const line = parse({});
+	BOOST_TEST((line.what == action::checksum));
+	BOOST_TEST(line.options.crc_model == find_model("crc32"));
+	BOOST_TEST((line.options.output_format == format::cksum));
+	BOOST_TEST(line.options.jobs == 0u);
+	BOOST_TEST(line.options.split_size == 64u << 20);
+	BOOST_TEST(!line.use_cache);
+	BOOST_TEST(line.paths == std::vector<std::string>{"-"});
+}
+
+BOOST_AUTO_TEST_CASE(option_forms_test)
+{
+	// Separate, inline, and long forms all work the same.
+	for (auto const& line : {
+		parse({"-m", "crc64_ecma", "-f", "sfv", "-j", "4", "-s", "1M",
+			"a"}),
+		parse({"-mcrc64_ecma", "-fsfv", "-j4", "-s1M", "a"}),
+		parse({"--model", "crc64_ecma", "--format=sfv", "--jobs=4",
+			"--split-size", "1M", "a"})})
+	{
+		BOOST_TEST((line.what == action::checksum));
+		BOOST_TEST(line.options.crc_model == find_model("crc64_ecma"));
+		BOOST_TEST((line.options.output_format == format::sfv));
+		BOOST_TEST(line.options.jobs == 4u);
+		BOOST_TEST(line.options.split_size == 1u << 20);
+		BOOST_TEST(line.paths == std::vector<std::string>{"a"});
+	}
+	
+	// Anything after "--" is a path, as is "-" itself.
+	auto const line = parse({"--", "-c", "-"});
+	BOOST_TEST((line.what == action::checksum));
+	BOOST_TEST((line.paths == std::vector<std::string>{"-c", "-"}));
+}
+
+BOOST_AUTO_TEST_CASE(actions_test)
+{
+	BOOST_TEST((parse({"-h"}).what == action::help));
+	BOOST_TEST((parse({"a", "--help", "--bogus"}).what == action::help));
+	BOOST_TEST((parse({"--list-models"}).what == action::list_models));
+	
+	auto const check = parse({"-c", "-q", "--fail-fast", "-m",
+		"crc64_ecma", "-j", "2", "--checkpoint", "cp", "list.sfv"});
+	BOOST_TEST((check.what == action::check));
+	BOOST_TEST(check.check_options.crc_model == find_model("crc64_ecma"));
+	BOOST_TEST(check.check_options.jobs == 2u);
+	BOOST_TEST(check.check_options.quiet);
+	BOOST_TEST(check.check_options.fail_fast);
+	BOOST_TEST(check.check_options.detect_format);
+	BOOST_TEST(check.check_options.checkpoint == "cp");
+	BOOST_TEST(check.paths == std::vector<std::string>{"list.sfv"});
+	
+	BOOST_TEST(!parse({"-c", "-f", "json", "a"}).check_options
+		.detect_format);
+	
+	auto const scrub = parse({"--scrub", "--rate", "2M", "--cpu", "25%",
+		"--state=st", "--repeat", "--cache=db", "dir"});
+	BOOST_TEST((scrub.what == action::scrub));
+	BOOST_TEST(scrub.scrub_opts.crc_model == find_model("crc32"));
+	BOOST_TEST(scrub.scrub_opts.rate == 2u << 20);
+	BOOST_TEST(scrub.scrub_opts.cpu_share == 0.25);
+	BOOST_TEST(scrub.scrub_opts.state == "st");
+	BOOST_TEST(scrub.scrub_opts.repeat);
+	BOOST_TEST(scrub.use_cache);
+	BOOST_TEST(scrub.cache_database == "db");
+	
+	auto const cached = parse({"--cache", "a"});
+	BOOST_TEST(cached.use_cache);
+	BOOST_TEST(cached.cache_database == "");
+	BOOST_TEST(cached.paths == std::vector<std::string>{"a"});
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test)
+{
+	// Options without an argument don't take trailing characters.
+	BOOST_CHECK_THROW(parse({"-cq", "a"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-qc", "a"}), usage_error);
+	BOOST_CHECK_THROW(parse({"--check=yes", "a"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-hx"}), usage_error);
+	
+	BOOST_CHECK_THROW(parse({"-x"}), usage_error);
+	BOOST_CHECK_THROW(parse({"--bogus"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-m"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-m", "crc99"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-f", "xml"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-j", "0"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-j", "4097"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-j", "4x"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-s", "1T"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-s", "99999999999G"}), usage_error);
+	BOOST_CHECK_THROW(parse({"--cpu", "0"}), usage_error);
+	BOOST_CHECK_THROW(parse({"--cpu", "101%"}), usage_error);
+	
+	BOOST_CHECK_THROW(parse({"-c"}), usage_error);
+	BOOST_CHECK_THROW(parse({"--scrub"}), usage_error);
+	BOOST_CHECK_THROW(parse({"-c", "--scrub", "a"}), usage_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tool/output.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+
+namespace {
+
+using namespace indi::crc::tool;
+
+// Writes the given entries in a format, and returns the output.
+template <typename Entries>
+auto write_list(format f, char const* model_name, Entries const& entries)
+{
+	auto const m = find_model(model_name);
+	BOOST_REQUIRE(m);
+	
+	auto const file = std::tmpfile();
+	BOOST_REQUIRE(file);
+	
+	auto w = writer{file, f, *m};
+	w.begin();
+	for (auto const& e : entries)
+		w.write(e.path, e.size, e.crc);
+	w.end();
+	
+	auto result = std::string{};
+	std::rewind(file);
+	for (int c; (c = std::fgetc(file)) != EOF; )
+		result += static_cast<char>(c);
+	std::fclose(file);
+	
+	return result;
+}
+
+struct entry
+{
+	std::string path;
+	std::uint_least64_t size;
+	model::crc_t crc;
+};
+
+entry const entries[] = {
+	{"check.txt", 9u, 0xCBF43926u},
+	{"empty", 0u, 0u}
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(tool_output_suite)
+
+// Testing for signatures:
+//     auto parse_format(std::string const& name, format& f) -> bool;
+
+BOOST_AUTO_TEST_CASE(parse_format_test)
+{
+	auto f = format::sfv;
+	BOOST_TEST(parse_format("cksum", f));
+	BOOST_TEST((f == format::cksum));
+	BOOST_TEST(parse_format("sfv", f));
+	BOOST_TEST((f == format::sfv));
+	BOOST_TEST(parse_format("json", f));
+	BOOST_TEST((f == format::json));
+	
+	BOOST_TEST(!parse_format("JSON", f));
+	BOOST_TEST(!parse_format("", f));
+	BOOST_TEST((f == format::json));
+}
+
+// Testing for signatures:
+//     writer(std::FILE* out, format f, model const& m);
+//     auto begin() -> void;
+//     auto write(std::string const& path, std::uint_least64_t size,
+//         model::crc_t crc) -> void;
+//     auto end() -> void;
+
+BOOST_AUTO_TEST_CASE(cksum_format_test)
+{
+	BOOST_TEST(write_list(format::cksum, "crc32", entries) ==
+		"3421780262 9 check.txt\n"
+		"0 0 empty\n");
+	
+	// The name is left out for standard input.
+	entry const from_stdin[] = {{"-", 9u, 0xCBF43926u}};
+	BOOST_TEST(write_list(format::cksum, "crc32", from_stdin) ==
+		"3421780262 9\n");
+}
+
+BOOST_AUTO_TEST_CASE(sfv_format_test)
+{
+	BOOST_TEST(write_list(format::sfv, "crc32", entries) ==
+		"check.txt CBF43926\n"
+		"empty 00000000\n");
+	
+	// The CRC is padded to the width of the model.
+	entry const short_crc[] = {{"a", 1u, 0x31C3u}};
+	BOOST_TEST(write_list(format::sfv, "crc16", short_crc) ==
+		"a 31C3\n");
+}
+
+BOOST_AUTO_TEST_CASE(json_format_test)
+{
+	BOOST_TEST(write_list(format::json, "crc32", entries) ==
+		"[\n"
+		"  {\"path\": \"check.txt\", \"size\": 9, \"model\": \"crc32\", "
+			"\"crc\": \"cbf43926\"},\n"
+		"  {\"path\": \"empty\", \"size\": 0, \"model\": \"crc32\", "
+			"\"crc\": \"00000000\"}\n"
+		"]\n");
+	
+	auto const none = std::initializer_list<entry>{};
+	BOOST_TEST(write_list(format::json, "crc32", none) == "[]\n");
+}
+
+// Testing for signatures:
+//     auto json_escape(std::string const& s) -> std::string;
+
+BOOST_AUTO_TEST_CASE(json_escape_test)
+{
+	BOOST_TEST(json_escape("plain/path.txt") == "plain/path.txt");
+	BOOST_TEST(json_escape("a\"b\\c") == "a\\\"b\\\\c");
+	BOOST_TEST(json_escape("\b\f\n\r\t") == "\\b\\f\\n\\r\\t");
+	BOOST_TEST(json_escape(std::string{"\x01\x1f", 2}) == "\\u0001\\u001f");
+	
+	// Non-ASCII bytes are passed through.
+	BOOST_TEST(json_escape("caf\xC3\xA9") == "caf\xC3\xA9");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
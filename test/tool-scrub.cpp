@@ -0,0 +1,164 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tool/scrub.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "test.hpp"
+
+namespace {
+
+using namespace indi::crc::tool;
+using indi::crc::test::read_file;
+using indi::crc::test::stat_file;
+using indi::crc::test::write_file;
+
+// A directory of three files, plus a state file and a database, all
+// removed again even if a test fails.
+struct temp_tree
+{
+	temp_tree()
+	{
+		::mkdir(dir.c_str(), 0777);
+		write_file(a, "123456789");
+		write_file(b, "abc");
+		write_file(c, "");
+	}
+	
+	// Scrubs the directory, and returns what was printed.
+	auto run(indi::crc::checksum_cache& cache, bool& ok) -> std::string
+	{
+		auto options = scrub_options{};
+		options.crc_model = find_model("crc32");
+		options.cache = &cache;
+		options.state = state;
+		
+		auto const out = std::tmpfile();
+		BOOST_REQUIRE(out);
+		ok = scrub({dir}, options, out);
+		
+		auto result = std::string{};
+		std::rewind(out);
+		for (int ch; (ch = std::fgetc(out)) != EOF; )
+			result += static_cast<char>(ch);
+		std::fclose(out);
+		
+		return result;
+	}
+	
+	// Looks up a file's cached CRC.
+	auto cached(indi::crc::checksum_cache& cache, std::string const& path)
+		-> std::uintmax_t
+	{
+		auto crc = std::uintmax_t{0};
+		if (!cache.find(path, stat_file(path), "crc32", crc))
+			return ~std::uintmax_t{0};
+		return crc;
+	}
+	
+	std::string const dir = "scrub-test.dir";
+	std::string const a = dir + "/a";
+	std::string const b = dir + "/b";
+	std::string const c = dir + "/c";
+	std::string const state = "scrub-test.state";
+	std::string const database = "scrub-test.db";
+	indi::crc::test::temp_paths const cleanup{a, b, c, dir, state,
+		database};
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(tool_scrub_suite)
+
+// Testing for signatures:
+//     auto scrub(std::vector<std::string> const& paths,
+//         scrub_options const& options, std::FILE* out) -> bool;
+
+BOOST_FIXTURE_TEST_CASE(record_and_verify_test, temp_tree)
+{
+	indi::crc::checksum_cache cache{database, false};
+	auto ok = false;
+	
+	// The first pass records every file.
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(ok);
+	BOOST_TEST(cached(cache, a) == 0xCBF43926u);
+	BOOST_TEST(cached(cache, b) == 0x352441C2u);
+	BOOST_TEST(cached(cache, c) == 0u);
+	
+	// The second verifies them.
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(ok);
+	
+	// A file that doesn't match its checksum, though it looks
+	// unchanged, is reported.
+	BOOST_REQUIRE(cache.store(b, stat_file(b), "crc32", 0x1234u));
+	BOOST_TEST(run(cache, ok) == "scrub-test.dir/b: FAILED\n");
+	BOOST_TEST(!ok);
+	
+	// Whereas a file that has been changed is just recorded again.
+	write_file(a, "987654321");
+	BOOST_REQUIRE(cache.store(b, stat_file(b), "crc32", 0x352441C2u));
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(ok);
+	BOOST_TEST(cached(cache, a) == 0x015F0201u);
+	
+	// A finished pass leaves the state at the start.
+	BOOST_TEST(read_file(state) == "indi-crc-scrub 1 0\n");
+}
+
+BOOST_FIXTURE_TEST_CASE(resume_test, temp_tree)
+{
+	indi::crc::checksum_cache cache{database, false};
+	auto ok = false;
+	
+	// Carry on after the last file a previous run finished.
+	write_file(state, "indi-crc-scrub 1 0\n" + b);
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(ok);
+	BOOST_TEST(cached(cache, a) == ~std::uintmax_t{0});
+	BOOST_TEST(cached(cache, b) == ~std::uintmax_t{0});
+	BOOST_TEST(cached(cache, c) == 0u);
+	
+	// The next pass starts from the beginning.
+	BOOST_TEST(read_file(state) == "indi-crc-scrub 1 0\n");
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(cached(cache, a) == 0xCBF43926u);
+	
+	// A state file that can't be parsed starts from scratch too.
+	write_file(state, "something else");
+	BOOST_TEST(run(cache, ok) == "");
+	BOOST_TEST(ok);
+}
+
+BOOST_FIXTURE_TEST_CASE(cannot_record_test, temp_tree)
+{
+	// Without extended attributes or a database, nothing can be stored,
+	// so scrubbing would never check anything.
+	indi::crc::checksum_cache cache{{}, false};
+	auto ok = false;
+	BOOST_CHECK_THROW(run(cache, ok), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
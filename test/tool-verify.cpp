@@ -0,0 +1,180 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tool/verify.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+using namespace indi::crc::tool;
+using indi::crc::test::write_file;
+
+auto exists(std::string const& path)
+{
+	return std::ifstream{path}.good();
+}
+
+// Writes three files and a checkpoint path, and removes them all again,
+// even if a test fails.
+struct temp_files
+{
+	temp_files()
+	{
+		write_file("verify-test-1.tmp", "123456789");
+		write_file("verify-test-2.tmp", "");
+		write_file("verify-test-3.tmp", "abc");
+	}
+	
+	indi::crc::test::temp_paths const cleanup{"verify-test-1.tmp",
+		"verify-test-2.tmp", "verify-test-3.tmp", "verify-test.txt",
+		"verify-test.cp"};
+};
+
+// The manifest, with a wrong CRC for the third file unless `fixed`.
+auto manifest_text(bool fixed)
+{
+	return std::string{
+		"3421780262 9 verify-test-1.tmp\n"
+		"0 0 verify-test-2.tmp\n"} +
+		(fixed ? "891568578" : "891568579") + " 3 verify-test-3.tmp\n";
+}
+
+// Runs a check of the test manifest, and returns whether it passed and
+// the lines it printed, sorted (since results are printed as they come
+// in).
+auto run_check(std::vector<std::string>& output)
+{
+	auto options = verify_options{};
+	options.crc_model = find_model("crc32");
+	options.jobs = 1u;
+	options.checkpoint = "verify-test.cp";
+	
+	auto const out = std::tmpfile();
+	BOOST_REQUIRE(out);
+	auto const ok = verify({"verify-test.txt"}, options, out);
+	
+	output.clear();
+	std::rewind(out);
+	auto line = std::string{};
+	for (int c; (c = std::fgetc(out)) != EOF; )
+	{
+		if (c != '\n')
+		{
+			line += static_cast<char>(c);
+			continue;
+		}
+		output.push_back(line);
+		line.clear();
+	}
+	std::fclose(out);
+	
+	std::sort(output.begin(), output.end());
+	
+	return ok;
+}
+
+auto const all_ok = std::vector<std::string>{
+	"verify-test-1.tmp: OK",
+	"verify-test-2.tmp: OK",
+	"verify-test-3.tmp: OK"};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(tool_verify_suite)
+
+// Testing for signatures:
+//     auto verify(std::vector<std::string> const& manifests,
+//         verify_options const& options, std::FILE* out) -> bool;
+
+BOOST_AUTO_TEST_CASE(verify_test)
+{
+	temp_files const files;
+	write_file("verify-test.txt", manifest_text(true));
+	
+	auto options = verify_options{};
+	options.crc_model = find_model("crc32");
+	options.quiet = true;
+	
+	BOOST_TEST(verify({"verify-test.txt"}, options, stdout));
+	
+	write_file("verify-test.txt", manifest_text(false));
+	BOOST_TEST(!verify({"verify-test.txt"}, options, stdout));
+	
+	write_file("verify-test.txt", "9 9 verify-test-missing.tmp\n");
+	BOOST_TEST(!verify({"verify-test.txt"}, options, stdout));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_resume_test)
+{
+	temp_files const files;
+	write_file("verify-test.txt", manifest_text(false));
+	
+	auto output = std::vector<std::string>{};
+	
+	// The first run records the two files that verify.
+	BOOST_TEST(!run_check(output));
+	BOOST_TEST((output == std::vector<std::string>{
+		"verify-test-1.tmp: OK",
+		"verify-test-2.tmp: OK",
+		"verify-test-3.tmp: FAILED"}));
+	BOOST_TEST(exists("verify-test.cp"));
+	
+	// A second run only checks the one that failed.
+	BOOST_TEST(!run_check(output));
+	BOOST_TEST((output == std::vector<std::string>{
+		"verify-test-3.tmp: FAILED"}));
+	
+	// Changing the manifest, even without changing the number of
+	// entries, makes the checkpoint stale, so everything is checked
+	// again; and once everything verifies, the checkpoint is removed.
+	write_file("verify-test.txt", manifest_text(true));
+	BOOST_TEST(run_check(output));
+	BOOST_TEST((output == all_ok));
+	BOOST_TEST(!exists("verify-test.cp"));
+}
+
+BOOST_AUTO_TEST_CASE(stale_checkpoint_test)
+{
+	temp_files const files;
+	write_file("verify-test.txt", manifest_text(true));
+	
+	// A checkpoint from an older version, or for another manifest with
+	// the same number of entries, is not trusted.
+	for (auto const stale : {
+		"indi-crc-checkpoint 1 3\n0\n1\n2\n",
+		"indi-crc-checkpoint 2 3 0123456789abcdef\n0\n1\n2\n"})
+	{
+		write_file("verify-test.cp", stale);
+		
+		auto output = std::vector<std::string>{};
+		BOOST_TEST(run_check(output));
+		BOOST_TEST((output == all_ok));
+	}
+	
+	BOOST_TEST(!exists("verify-test.cp"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
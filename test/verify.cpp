@@ -0,0 +1,193 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "indi/crc-braid.hpp"
+#include "indi/crc-simd.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Appends the CRC of a message to it, least significant byte first.
+template <std::size_t Bits, typename T>
+auto frame(std::vector<unsigned char> message, T poly)
+{
+	auto crc = indi::crc::calculate<Bits>(message, poly);
+	for (auto n = std::size_t{0}; n < Bits / 8u; ++n, crc >>= 8)
+		message.push_back(static_cast<unsigned char>(crc & 0xFFu));
+	return message;
+}
+
+// Every frame verifies, and flipping any one bit of a frame makes it
+// fail.
+template <std::size_t Bits, typename T, typename Engine>
+auto check_frames(T poly, Engine const& engine) -> void
+{
+	for (auto const size : {0u, 1u, 7u, 64u, 1000u})
+	{
+		auto data = frame<Bits>(random_bytes(size, size), poly);
+		BOOST_CHECK(indi::crc::verify<Bits>(data, poly));
+		BOOST_CHECK(indi::crc::verify<Bits>(data, poly, engine));
+		
+		for (auto bit = std::size_t{0}; bit < data.size() * 8u;
+			bit += 13u)
+		{
+			data[bit / 8u] ^= static_cast<unsigned char>(1u << (bit % 8u));
+			BOOST_CHECK(!indi::crc::verify<Bits>(data, poly, engine));
+			data[bit / 8u] ^= static_cast<unsigned char>(1u << (bit % 8u));
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(verify_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     constexpr auto residue<Bits>(T polynomial) noexcept ->
+//         T
+//     template <std::size_t Bits, typename InIt, typename Sen, typename T>
+//     constexpr auto verify<Bits>(InIt first, Sen last, T poly) ->
+//         bool
+//     template <std::size_t Bits, typename InIt, typename Sen, typename T,
+//         typename Engine>
+//     auto verify<Bits>(InIt first, Sen last, T poly,
+//             Engine const& engine) ->
+//         bool
+//     template <std::size_t Bits, typename Range, typename T>
+//     constexpr auto verify<Bits>(Range const& range, T poly) ->
+//         bool
+//     template <std::size_t Bits, typename Range, typename T,
+//         typename Engine>
+//     auto verify<Bits>(Range const& range, T poly,
+//             Engine const& engine) ->
+//         bool
+BOOST_AUTO_TEST_CASE(verify_signature)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32};
+	auto const data = std::vector<unsigned char>(4u);
+	
+	BOOST_CHECK((std::is_same<std::uint_fast32_t,
+		decltype(indi::crc::residue<32>(polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(indi::crc::verify<32>(
+		data.begin(), data.end(), polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(indi::crc::verify<32>(
+		data.begin(), data.end(), polys::crc32, engine))>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(indi::crc::verify<32>(
+		data, polys::crc32))>::value));
+	BOOST_CHECK((std::is_same<bool, decltype(indi::crc::verify<32>(
+		data, polys::crc32, engine))>::value));
+}
+
+// The residues of the well known CRCs (after the final xor), worked out
+// at compile time.
+BOOST_AUTO_TEST_CASE(residue_check_values)
+{
+	constexpr auto crc32 = indi::crc::residue<32>(polys::crc32);
+	constexpr auto crc32c = indi::crc::residue<32>(polys::crc32c);
+	constexpr auto crc64 = indi::crc::residue<64>(polys::crc64_ecma);
+	
+	BOOST_CHECK_EQUAL(crc32, 0x2144DF1Cu);
+	BOOST_CHECK_EQUAL(crc32c, 0x48674BC7u);
+	BOOST_CHECK_EQUAL(crc64, 0xB66A73654282CAC0uLL);
+}
+
+BOOST_AUTO_TEST_CASE(verify_check_values)
+{
+	// "123456789" followed by its CRC-32, 0xCBF43926.
+	constexpr auto data = std::array<unsigned char, 13>{{'1', '2', '3',
+		'4', '5', '6', '7', '8', '9', 0x26u, 0x39u, 0xF4u, 0xCBu}};
+	constexpr auto bad = std::array<unsigned char, 13>{{'1', '2', '3',
+		'4', '5', '6', '7', '8', '9', 0x26u, 0x39u, 0xF4u, 0xCAu}};
+	
+	BOOST_CHECK(indi::crc::verify<32>(data, polys::crc32));
+	BOOST_CHECK(!indi::crc::verify<32>(bad, polys::crc32));
+	BOOST_CHECK(indi::crc::verify<32>(data.begin(), data.end(),
+		polys::crc32, indi::crc::braided_engine<32>{polys::crc32}));
+}
+
+BOOST_AUTO_TEST_CASE(verify_models)
+{
+	check_frames<32>(polys::crc32,
+		indi::crc::clmul_engine<32>{polys::crc32});
+	check_frames<32>(polys::crc32c,
+		indi::crc::clmul_engine<32>{polys::crc32c});
+	check_frames<32>(polys::crc32k,
+		indi::crc::braided_engine<32>{polys::crc32k});
+	check_frames<64>(polys::crc64_ecma,
+		indi::crc::clmul_engine<64>{polys::crc64_ecma});
+	check_frames<16>(polys::crc16_ccitt,
+		indi::crc::braided_engine<16>{polys::crc16_ccitt});
+	check_frames<8>(std::uint_fast8_t{0x07u},
+		indi::crc::braided_engine<8>{std::uint_fast8_t{0x07u}});
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename InIt, typename Sen,
+//         typename OutIt, typename T, typename Engine>
+//     auto verify_batch<Bits>(InIt first, Sen last, OutIt out, T poly,
+//             Engine const& engine) ->
+//         OutIt
+//     template <std::size_t Bits, typename Range, typename OutIt,
+//         typename T, typename Engine>
+//     auto verify_batch<Bits>(Range const& range, OutIt out, T poly,
+//             Engine const& engine) ->
+//         OutIt
+BOOST_AUTO_TEST_CASE(verify_batch_frames)
+{
+	auto const engine = indi::crc::clmul_engine<32>{polys::crc32c};
+	
+	auto frames = std::vector<std::vector<unsigned char>>{};
+	auto expected = std::vector<bool>{};
+	for (auto n = 0u; n < 600u; ++n)
+	{
+		frames.push_back(frame<32>(random_bytes(n * 7u % 2000u, n),
+			polys::crc32c));
+		if (n % 3u == 0u)
+			frames.back()[n % frames.back().size()] ^= 0x10u;
+		expected.push_back(n % 3u != 0u);
+	}
+	
+	auto results = std::vector<bool>(frames.size());
+	auto const end = indi::crc::verify_batch<32>(frames, results.begin(),
+		polys::crc32c, engine);
+	BOOST_CHECK(end == results.end());
+	BOOST_CHECK(results == expected);
+	
+	auto more = std::vector<bool>{};
+	indi::crc::verify_batch<32>(frames.begin(), frames.end(),
+		std::back_inserter(more), polys::crc32c, engine);
+	BOOST_CHECK(more == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "indi/crc-wide.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+namespace {
+
+namespace polys = indi::crc::polynomials;
+
+using indi::crc::test::random_bytes;
+
+// Checks both kinds of engine against 256-element tables, over even
+// and odd lengths, at a few alignments, with random initial values.
+template <std::size_t Bits, typename T>
+auto check_engines(T polynomial)
+{
+	auto const data = random_bytes(1000u);
+	auto const table = indi::crc::generate_table<Bits>(polynomial);
+	auto const normal_table = indi::crc::generate_normal_table<Bits>(
+		polynomial);
+	auto const mask = indi::crc::detail_::ones<Bits, T>();
+	
+	auto const reflected = indi::crc::wide_engine<Bits, T>{polynomial};
+	auto const normal = indi::crc::normal_wide_engine<Bits, T>{
+		polynomial};
+	
+	auto random = std::mt19937_64{Bits};
+	
+	for (auto offset = std::size_t{0}; offset < 2u; ++offset)
+	{
+		for (auto length : {0u, 1u, 2u, 3u, 4u, 17u, 64u, 997u})
+		{
+			auto const init = static_cast<T>(random() & mask);
+			auto const first = data.data() + offset;
+			auto const last = first + length;
+			
+			if (reflected.update(init, first, last) !=
+					indi::crc::calculate_raw<Bits>(init, first, last, table) ||
+				normal.update(init, first, last) !=
+					indi::crc::calculate_normal_raw<Bits>(init, first, last,
+						normal_table))
+			{
+				BOOST_ERROR("Bits " << Bits << ", offset " << offset <<
+					", length " << length);
+				return;
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(wide_engine_suite)
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     auto generate_wide_table<Bits>(T polynomial,
+//             wide_table<Bits>& table) noexcept -> void
+//     template <std::size_t Bits, typename T>
+//     auto generate_normal_wide_table<Bits>(T polynomial,
+//             wide_table<Bits>& table) noexcept -> void
+BOOST_AUTO_TEST_CASE(generate_wide_table_values)
+{
+	auto const table = indi::crc::generate_table<16>(polys::crc16_ibm);
+	auto const normal_table = indi::crc::generate_normal_table<16>(
+		polys::crc16_ccitt);
+	
+	auto const wide = std::make_unique<indi::crc::wide_table<16>>();
+	auto const normal_wide = std::make_unique<indi::crc::wide_table<16>>();
+	indi::crc::generate_wide_table<16>(polys::crc16_ibm, *wide);
+	indi::crc::generate_normal_wide_table<16>(polys::crc16_ccitt,
+		*normal_wide);
+	
+	// Entries for a single byte followed by a zero.
+	for (auto n = 0u; n < 256u; ++n)
+	{
+		unsigned char const bytes[] = {static_cast<unsigned char>(n), 0u};
+		BOOST_CHECK_EQUAL((*wide)[n], indi::crc::calculate_raw<16>(
+			std::uint_fast16_t{0u}, bytes, bytes + 2, table));
+		BOOST_CHECK_EQUAL((*normal_wide)[n << 8],
+			indi::crc::calculate_normal_raw<16>(std::uint_fast16_t{0u},
+				bytes, bytes + 2, normal_table));
+	}
+	
+	BOOST_CHECK_EQUAL((*wide)[0x3412u], indi::crc::calculate_next(
+		indi::crc::calculate_next(std::uint_fast16_t{0u}, 0x12u, table),
+		0x34u, table));
+	BOOST_CHECK_EQUAL((*normal_wide)[0x1234u],
+		indi::crc::calculate_next_normal<16>(
+			indi::crc::calculate_next_normal<16>(std::uint_fast16_t{0u},
+				0x12u, normal_table), 0x34u, normal_table));
+}
+
+BOOST_AUTO_TEST_CASE(wide_engine_values)
+{
+	check_engines<3>(std::uint_fast8_t{0x3u});
+	check_engines<5>(std::uint_fast8_t{0x09u});
+	check_engines<7>(std::uint_fast8_t{0x09u});
+	check_engines<8>(std::uint_fast8_t{0x07u});
+	check_engines<8>(std::uint_fast8_t{0x31u});
+	check_engines<12>(std::uint_fast16_t{0x80Fu});
+	check_engines<16>(polys::crc16_ibm);
+	check_engines<16>(polys::crc16_ccitt);
+	check_engines<16>(polys::crc16_dnp);
+}
+
+BOOST_AUTO_TEST_CASE(wide_engine_calculate)
+{
+	auto const check = std::string{"123456789"};
+	
+	// CRC-16/MODBUS.
+	auto const modbus = indi::crc::wide_engine<16>{polys::crc16_ibm};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_raw<16>(
+		std::uint_fast16_t{0xFFFFu}, check, modbus), 0x4B37u);
+	
+	auto const list = std::list<unsigned char>(check.begin(), check.end());
+	BOOST_CHECK_EQUAL(indi::crc::calculate_raw<16>(
+		std::uint_fast16_t{0xFFFFu}, list, modbus), 0x4B37u);
+	
+	// CRC-16/XMODEM and CRC-8/SMBUS.
+	auto const xmodem = indi::crc::normal_wide_engine<16>{
+		polys::crc16_ccitt};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<16>(
+		std::uint_fast16_t{0u}, check, xmodem), 0x31C3u);
+	
+	auto const smbus = indi::crc::normal_wide_engine<8>{
+		std::uint_fast8_t{0x07u}};
+	BOOST_CHECK_EQUAL(indi::crc::calculate_normal_raw<8>(
+		std::uint_fast8_t{0u}, check, smbus), 0xF4u);
+}
+
+// Testing for signatures:
+//     template <std::size_t Bits, typename T>
+//     auto shared_wide_table<Bits>(T polynomial) ->
+//         std::shared_ptr<wide_table<Bits> const>
+//     template <std::size_t Bits, typename T>
+//     auto shared_normal_wide_table<Bits>(T polynomial) ->
+//         std::shared_ptr<wide_table<Bits> const>
+BOOST_AUTO_TEST_CASE(shared_wide_table_sharing)
+{
+	auto const ibm = indi::crc::shared_wide_table<16>(polys::crc16_ibm);
+	auto const normal_ibm = indi::crc::shared_normal_wide_table<16>(
+		polys::crc16_ibm);
+	auto const ccitt = indi::crc::shared_wide_table<16>(
+		polys::crc16_ccitt);
+	
+	BOOST_CHECK(ibm != normal_ibm);
+	BOOST_CHECK(ibm != ccitt);
+	BOOST_CHECK(ibm == indi::crc::shared_wide_table<16>(polys::crc16_ibm));
+	
+	// Engines share the tables too, and so do their copies.
+	auto const engine = indi::crc::wide_engine<16>{polys::crc16_ibm};
+	auto const copy = engine;
+	BOOST_CHECK_EQUAL(&engine.table(), ibm.get());
+	BOOST_CHECK_EQUAL(&copy.table(), ibm.get());
+	BOOST_CHECK_EQUAL(&indi::crc::normal_wide_engine<16>{
+		polys::crc16_ibm}.table(), normal_ibm.get());
+	
+	for (auto const& table : {ibm, normal_ibm, ccitt})
+		BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(table.get()) %
+			indi::crc::wide_table_alignment, 0u);
+	
+	// Once every reference is gone, the table is freed, and made again
+	// when it's next needed.
+	auto weak = std::weak_ptr<indi::crc::wide_table<8> const>{
+		indi::crc::shared_wide_table<8>(std::uint_fast8_t{0x07u})};
+	BOOST_CHECK(weak.expired());
+	BOOST_CHECK(indi::crc::shared_wide_table<8>(std::uint_fast8_t{0x07u}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,245 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checksum.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "indi/crc-file.hpp"
+
+#include "file-task.hpp"
+#include "thread-pool.hpp"
+#include "walk.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+// The result of checksumming one file.
+struct job
+{
+	explicit job(std::string p) :
+		path(std::move(p))
+	{}
+	
+	std::string path;
+	std::uint_least64_t size = 0;
+	model::crc_t crc = 0;
+	std::string error;
+	bool done = false;
+};
+
+// All the jobs, in output order.
+//
+// Jobs are only ever appended, and std::deque never moves its
+// elements when appending, so workers can hold on to references to
+// their jobs while the list grows.
+class job_list
+{
+public:
+	auto add(std::string path) -> job&
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		jobs_.emplace_back(std::move(path));
+		return jobs_.back();
+	}
+	
+	auto finish(job& j) -> void
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			j.done = true;
+		}
+		done_.notify_all();
+	}
+	
+	auto size() -> std::size_t
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return jobs_.size();
+	}
+	
+	auto wait(std::size_t index) -> job&
+	{
+		std::unique_lock<std::mutex> lock{mutex_};
+		auto& j = jobs_[index];
+		done_.wait(lock, [&j] { return j.done; });
+		return j;
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable done_;
+	std::deque<job> jobs_;
+};
+
+class checksummer
+{
+public:
+	checksummer(checksum_options const& options) :
+		model_(*options.crc_model),
+		split_size_(options.split_size),
+		cache_(options.cache),
+		pool_(options.jobs)
+	{}
+	
+	auto add(std::string const& path) -> void
+	{
+		auto& j = jobs_.add(path);
+		pool_.submit([this, &j] { run(j); });
+	}
+	
+	auto add_error(std::string const& path, int error) -> void
+	{
+		auto& j = jobs_.add(path);
+		j.error = error_message(path,
+			std::system_error{error, std::generic_category()});
+		jobs_.finish(j);
+	}
+	
+	auto write(writer& w) -> bool
+	{
+		auto ok = true;
+		
+		w.begin();
+		
+		auto const count = jobs_.size();
+		for (auto n = std::size_t{0}; n < count; ++n)
+		{
+			auto& j = jobs_.wait(n);
+			
+			if (j.error.empty())
+			{
+				w.write(j.path, j.size, j.crc);
+			}
+			else
+			{
+				std::fprintf(stderr, "indi-crc: %s\n", j.error.c_str());
+				ok = false;
+			}
+			
+			// Free the memory as soon as it's no longer needed.
+			j.path = std::string{};
+			j.error = std::string{};
+		}
+		
+		w.end();
+		
+		return ok;
+	}
+
+private:
+	auto run(job& j) -> void
+	{
+		if (j.path == "-")
+		{
+			try
+			{
+				j.crc = model_.calculate(STDIN_FILENO, &j.size);
+			}
+			catch (std::exception const& e)
+			{
+				j.error = error_message(j.path, e);
+			}
+			
+			jobs_.finish(j);
+			return;
+		}
+		
+		// With a cache, an unchanged file only costs a stat.
+		struct ::stat st;
+		auto const cacheable = cache_ && ::stat(j.path.c_str(), &st) == 0 &&
+			S_ISREG(st.st_mode);
+		
+		auto cached = std::uintmax_t{};
+		if (cacheable && cache_->find(j.path, st, model_.name(), cached))
+		{
+			j.size = static_cast<std::uint_least64_t>(st.st_size);
+			j.crc = static_cast<model::crc_t>(cached);
+			jobs_.finish(j);
+			return;
+		}
+		
+		auto fd = file_descriptor{};
+		try
+		{
+			fd = open_file(j.path);
+		}
+		catch (std::exception const& e)
+		{
+			j.error = error_message(j.path, e);
+			jobs_.finish(j);
+			return;
+		}
+		
+		checksum_file(pool_, model_, j.path, std::move(fd), split_size_,
+			[this, &j, cacheable, st](file_result&& result)
+			{
+				if (cacheable && result.error.empty() &&
+						result.size == static_cast<std::uint_least64_t>(
+							st.st_size))
+					cache_->store(j.path, st, model_.name(), result.crc);
+				
+				j.size = result.size;
+				j.crc = result.crc;
+				j.error = std::move(result.error);
+				jobs_.finish(j);
+			});
+	}
+	
+	model const& model_;
+	std::uint_least64_t split_size_;
+	checksum_cache* cache_;
+	job_list jobs_;
+	thread_pool pool_;
+};
+
+} // anonymous namespace
+
+auto checksum(std::vector<std::string> const& paths,
+	checksum_options const& options, std::FILE* out) -> bool
+{
+	checksummer c{options};
+	
+	for (auto const& path : paths)
+	{
+		if (path == "-")
+		{
+			c.add(path);
+			continue;
+		}
+		
+		walk(path,
+			[&c](std::string const& p) { c.add(p); },
+			[&c](std::string const& p, int e) { c.add_error(p, e); });
+	}
+	
+	auto w = writer{out, options.output_format, *options.crc_model};
+	return c.write(w);
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,72 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_CHECKSUM_
+#define INDI_INC_CRC_TOOL_CHECKSUM_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "indi/crc-cache.hpp"
+
+#include "models.hpp"
+#include "output.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+struct checksum_options
+{
+	//! The CRC model to calculate.
+	model const* crc_model = nullptr;
+	
+	//! The output format.
+	format output_format = format::cksum;
+	
+	//! The number of worker threads (0 means one per hardware thread).
+	std::size_t jobs = 0;
+	
+	//! Files larger than this are split into pieces of this size,
+	//! which are calculated in parallel and then combined. 0 means
+	//! never split files.
+	std::uint_least64_t split_size = 0;
+	
+	//! If not null, checksums are looked up in and saved to this cache.
+	checksum_cache* cache = nullptr;
+};
+
+//! Checksums files and directory trees.
+//! 
+//! Every path is walked (see `walk`), and every file found is
+//! checksummed on a work-stealing thread pool. Results are written to
+//! `out` in the order the files were found, as soon as all the files
+//! before them are done. Errors are written to `stderr`.
+//! 
+//! The path `-` means standard input.
+//! 
+//! \returns True if every file was checksummed without error.
+auto checksum(std::vector<std::string> const& paths,
+	checksum_options const& options, std::FILE* out) -> bool;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,172 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file-task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+// The shared state of a file that is being checksummed in pieces.
+struct split_file
+{
+	split_file(model const& m, std::string const& p, file_descriptor fd,
+			std::uint_least64_t s, std::uint_least64_t ps,
+			std::function<void(file_result&&)> d) :
+		crc_model(m),
+		path(p),
+		file(std::move(fd)),
+		size(s),
+		piece_size(ps),
+		crcs(static_cast<std::size_t>((s + ps - 1u) / ps)),
+		remaining(crcs.size()),
+		done(std::move(d))
+	{}
+	
+	auto piece_length(std::size_t n) const
+	{
+		return std::min(piece_size, size - n * piece_size);
+	}
+	
+	auto run_piece(std::size_t n) -> void;
+	
+	model const& crc_model;
+	std::string const path;
+	file_descriptor const file;
+	std::uint_least64_t const size;
+	std::uint_least64_t const piece_size;
+	
+	std::vector<model::crc_t> crcs;
+	std::atomic<std::size_t> remaining;
+	std::function<void(file_result&&)> done;
+	
+	std::mutex error_mutex;
+	std::string error;
+};
+
+auto split_file::run_piece(std::size_t n) -> void
+{
+	auto const length = piece_length(n);
+	
+	try
+	{
+		auto bytes_read = std::uint_least64_t{0};
+		crcs[n] = crc_model.calculate(file.get(), n * piece_size, length,
+			&bytes_read);
+		
+		if (bytes_read != length)
+			throw std::runtime_error{"file changed while reading"};
+	}
+	catch (std::exception const& e)
+	{
+		std::lock_guard<std::mutex> lock{error_mutex};
+		if (error.empty())
+			error = error_message(path, e);
+	}
+	
+	// The last piece to finish puts the whole thing together.
+	if (--remaining != 0)
+		return;
+	
+	auto result = file_result{};
+	result.size = size;
+	
+	if (error.empty())
+	{
+		result.crc = crcs[0];
+		for (auto i = std::size_t{1}; i < crcs.size(); ++i)
+			result.crc = crc_model.combine(result.crc, crcs[i],
+				piece_length(i));
+	}
+	else
+	{
+		result.error = std::move(error);
+	}
+	
+	done(std::move(result));
+}
+
+} // anonymous namespace
+
+auto checksum_file(thread_pool& pool, model const& m,
+	std::string const& path, file_descriptor fd,
+	std::uint_least64_t split_size,
+	std::function<void(file_result&&)> done) -> void
+{
+	auto result = file_result{};
+	
+	try
+	{
+		struct ::stat st;
+		if (::fstat(fd.get(), &st) != 0)
+			detail_::throw_errno(path);
+		
+		auto const size = static_cast<std::uint_least64_t>(st.st_size);
+		
+		if (!S_ISREG(st.st_mode))
+		{
+			result.crc = m.calculate(fd.get(), &result.size);
+		}
+		else if (split_size == 0 || size <= split_size)
+		{
+			result.crc = m.calculate(fd.get(), 0, UINT_LEAST64_MAX,
+				&result.size);
+		}
+		else
+		{
+			auto const s = std::make_shared<split_file>(m, path,
+				std::move(fd), size, split_size, std::move(done));
+			
+			for (auto n = std::size_t{1}; n < s->crcs.size(); ++n)
+				pool.submit([s, n] { s->run_piece(n); });
+			
+			s->run_piece(0);
+			return;
+		}
+	}
+	catch (std::exception const& e)
+	{
+		result.error = error_message(path, e);
+	}
+	
+	done(std::move(result));
+}
+
+auto error_message(std::string const& path, std::exception const& e)
+	-> std::string
+{
+	if (auto const se = dynamic_cast<std::system_error const*>(&e))
+		return path + ": " + se->code().message();
+	
+	return path + ": " + e.what();
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,79 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_FILE_TASK_
+#define INDI_INC_CRC_TOOL_FILE_TASK_
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+
+#include "indi/crc-file.hpp"
+
+#include "models.hpp"
+#include "thread-pool.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! The result of checksumming a file.
+struct file_result
+{
+	//! The number of bytes checksummed.
+	std::uint_least64_t size = 0;
+	
+	//! The CRC (if there was no error).
+	model::crc_t crc = 0;
+	
+	//! The error message, or empty if there was no error.
+	std::string error;
+};
+
+//! Checksums an open file, splitting it into pieces if it is large.
+//! 
+//! Regular files larger than `split_size` are cut into pieces of
+//! `split_size` bytes. Every piece but the first is queued on the
+//! current worker, where idle workers can steal it, and the first is
+//! calculated straight away. The piece CRCs are then combined by
+//! whichever worker finishes last. Anything else is checksummed
+//! sequentially, right away.
+//! 
+//! `done` is called exactly once, on whichever thread finishes the
+//! work, which may be before this function returns.
+//! 
+//! \param pool  The pool to queue pieces on. This should be called
+//!     from a task running on it.
+//! \param m  The CRC model.
+//! \param path  The file's path (only used in error messages).
+//! \param fd  The open file.
+//! \param split_size  The piece size, or 0 to never split.
+//! \param done  Called with the result.
+auto checksum_file(thread_pool& pool, model const& m,
+	std::string const& path, file_descriptor fd,
+	std::uint_least64_t split_size,
+	std::function<void(file_result&&)> done) -> void;
+
+//! Formats an error message for a path.
+auto error_message(std::string const& path, std::exception const& e)
+	-> std::string;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
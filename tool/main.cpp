@@ -0,0 +1,144 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// indi-crc: checksum files and directory trees in parallel.
+
+#include <cstdio>
+#include <exception>
+
+#include "checksum.hpp"
+#include "models.hpp"
+#include "options.hpp"
+#include "output.hpp"
+#include "scrub.hpp"
+#include "verify.hpp"
+
+namespace {
+
+using namespace indi::crc::tool;
+
+constexpr auto usage =
+	"Usage: indi-crc [OPTION]... [FILE]...\n"
+	"  or:  indi-crc -c [OPTION]... MANIFEST...\n"
+	"  or:  indi-crc --scrub [OPTION]... PATH...\n"
+	"Print the CRC and size of each FILE. Directories are walked\n"
+	"recursively. With no FILE, or when FILE is -, read standard input.\n"
+	"\n"
+	"  -c, --check            verify the files listed in each MANIFEST\n"
+	"      --scrub            check the files under each PATH against\n"
+	"                         their cached checksums (see --cache), and\n"
+	"                         cache checksums for new files\n"
+	"  -m, --model NAME       CRC model to calculate (default: crc32)\n"
+	"  -f, --format FORMAT    output format: cksum (default), sfv, or json\n"
+	"  -j, --jobs N           number of worker threads (default: one per\n"
+	"                         hardware thread)\n"
+	"  -s, --split-size SIZE  split files larger than SIZE into pieces\n"
+	"                         that are checksummed in parallel (default:\n"
+	"                         64M; 0 disables splitting)\n"
+	"      --cache[=FILE]     reuse the checksums of unchanged files, kept\n"
+	"                         in extended attributes, or in FILE where\n"
+	"                         those aren't available (not used with\n"
+	"                         --check, which always reads the files)\n"
+	"      --list-models      list the available CRC models and exit\n"
+	"  -h, --help             display this help and exit\n"
+	"\n"
+	"When checking:\n"
+	"      --fail-fast        stop at the first file that fails\n"
+	"      --checkpoint FILE  record verified files in FILE, and skip the\n"
+	"                         files it lists, so an interrupted check can\n"
+	"                         be resumed\n"
+	"  -q, --quiet            don't print OK for each file that matches\n"
+	"\n"
+	"When scrubbing:\n"
+	"      --rate SIZE        read at most SIZE bytes per second\n"
+	"      --cpu PERCENT      use at most PERCENT of one CPU\n"
+	"      --state FILE       keep the position in FILE, and carry on from\n"
+	"                         there after a restart\n"
+	"      --repeat           start again after each pass, forever\n"
+	"\n"
+	"The manifest format is guessed unless -f is given, and -m sets the\n"
+	"model for manifests that don't name one.\n"
+	"\n"
+	"SIZE may have a K, M, or G suffix (powers of 1024).\n";
+
+auto list_models() -> void
+{
+	for (auto const& m : models())
+		std::printf("%-18s %2u bits  polynomial 0x%0*llX\n", m.name(),
+			static_cast<unsigned>(m.bits()),
+			static_cast<int>(m.hex_digits()),
+			static_cast<unsigned long long>(m.polynomial()));
+}
+
+} // anonymous namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+	auto line = command_line{};
+	try
+	{
+		line = parse_command_line(argc, argv);
+	}
+	catch (usage_error const& e)
+	{
+		std::fprintf(stderr, "indi-crc: %s\n"
+			"Try 'indi-crc --help' for more information.\n", e.what());
+		return 2;
+	}
+	
+	try
+	{
+		switch (line.what)
+		{
+		case action::help:
+			std::fputs(usage, stdout);
+			return 0;
+		
+		case action::list_models:
+			list_models();
+			return 0;
+		
+		case action::check:
+			return verify(line.paths, line.check_options, stdout) ? 0 : 1;
+		
+		case action::scrub:
+		{
+			indi::crc::checksum_cache cache{line.cache_database};
+			line.scrub_opts.cache = &cache;
+			auto const ok = scrub(line.paths, line.scrub_opts, stdout);
+			cache.save();
+			return ok ? 0 : 1;
+		}
+		
+		case action::checksum:
+			break;
+		}
+		
+		if (!line.use_cache)
+			return checksum(line.paths, line.options, stdout) ? 0 : 1;
+		
+		indi::crc::checksum_cache cache{line.cache_database};
+		line.options.cache = &cache;
+		auto const ok = checksum(line.paths, line.options, stdout);
+		cache.save();
+		return ok ? 0 : 1;
+	}
+	catch (std::exception const& e)
+	{
+		std::fprintf(stderr, "indi-crc: %s\n", e.what());
+		return 1;
+	}
+}
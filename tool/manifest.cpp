@@ -0,0 +1,543 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "manifest.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+struct file_closer
+{
+	auto operator()(std::FILE* f) const noexcept { std::fclose(f); }
+};
+
+using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+
+auto open(std::string const& path)
+{
+	auto f = file_ptr{std::fopen(path.c_str(), "rb")};
+	if (!f)
+		throw std::system_error{errno, std::generic_category(), path};
+	return f;
+}
+
+auto ends_with(std::string const& s, char const* suffix)
+{
+	auto const n = std::string::traits_type::length(suffix);
+	return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+auto is_digit(char c) { return c >= '0' && c <= '9'; }
+
+auto is_hex_digit(char c)
+{
+	return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Parses a whole string as an unsigned number.
+auto parse_number(std::string const& s, int base, std::uint_least64_t& n)
+{
+	if (s.empty() || s.size() > 20u)
+		return false;
+	
+	for (auto const c : s)
+	{
+		if (base == 16 ? !is_hex_digit(c) : !is_digit(c))
+			return false;
+	}
+	
+	errno = 0;
+	n = std::strtoull(s.c_str(), nullptr, base);
+	return errno == 0;
+}
+
+// Reads a manifest one line at a time.
+class line_reader
+{
+public:
+	line_reader(std::string const& path) :
+		path_(path),
+		file_(open(path))
+	{}
+	
+	~line_reader() { std::free(buffer_); }
+	
+	auto next(std::string& line) -> bool
+	{
+		auto const length = ::getline(&buffer_, &capacity_, file_.get());
+		if (length < 0)
+		{
+			if (std::ferror(file_.get()))
+				throw std::system_error{errno, std::generic_category(),
+					path_};
+			return false;
+		}
+		
+		++line_number_;
+		
+		line.assign(buffer_, static_cast<std::size_t>(length));
+		while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+			line.pop_back();
+		
+		return true;
+	}
+	
+	[[noreturn]] auto error(char const* message) const -> void
+	{
+		throw std::runtime_error{path_ + ":" +
+			std::to_string(line_number_) + ": " + message};
+	}
+
+private:
+	std::string const& path_;
+	file_ptr file_;
+	char* buffer_ = nullptr;
+	std::size_t capacity_ = 0;
+	std::size_t line_number_ = 0;
+};
+
+auto add(manifest& m, std::string const& path, std::uint_least64_t size,
+	model::crc_t crc, model const& crc_model)
+{
+	m.entries.push_back(manifest_entry{
+		m.paths.add(path.data(), path.size()), size, crc, &crc_model});
+}
+
+// "CRC SIZE PATH"
+auto read_cksum(std::string const& path, model const& crc_model,
+	manifest& m)
+{
+	line_reader reader{path};
+	auto line = std::string{};
+	
+	while (reader.next(line))
+	{
+		if (line.empty())
+			continue;
+		
+		auto const first = line.find(' ');
+		auto const second = (first == std::string::npos) ?
+			std::string::npos : line.find(' ', first + 1);
+		
+		auto crc = std::uint_least64_t{};
+		auto size = std::uint_least64_t{};
+		
+		if (second == std::string::npos ||
+				!parse_number(line.substr(0, first), 10, crc) ||
+				!parse_number(line.substr(first + 1, second - first - 1), 10,
+					size) ||
+				second + 1 == line.size())
+			reader.error("malformed cksum line");
+		
+		add(m, line.substr(second + 1), size, crc, crc_model);
+	}
+}
+
+// "PATH CRC", with ";" comments.
+auto read_sfv(std::string const& path, model const& crc_model,
+	manifest& m)
+{
+	line_reader reader{path};
+	auto line = std::string{};
+	
+	while (reader.next(line))
+	{
+		if (line.empty() || line[0] == ';')
+			continue;
+		
+		auto const space = line.rfind(' ');
+		
+		auto crc = std::uint_least64_t{};
+		
+		if (space == std::string::npos || space == 0 ||
+				!parse_number(line.substr(space + 1), 16, crc))
+			reader.error("malformed SFV line");
+		
+		add(m, line.substr(0, space), unknown_size, crc, crc_model);
+	}
+}
+
+// A parser for the subset of JSON that indi-crc writes: an array of
+// flat objects.
+class json_reader
+{
+public:
+	json_reader(std::string const& path) :
+		path_(path),
+		file_(open(path))
+	{
+		advance();
+	}
+	
+	auto read(model const& default_model, manifest& m) -> void
+	{
+		expect('[');
+		
+		if (peek() == ']')
+		{
+			advance();
+		}
+		else
+		{
+			do
+			{
+				read_entry(default_model, m);
+			} while (accept(','));
+			
+			expect(']');
+		}
+		
+		if (peek() != EOF)
+			error("unexpected data after the end of the array");
+	}
+
+private:
+	auto read_entry(model const& default_model, manifest& m) -> void
+	{
+		auto path = std::string{};
+		auto have_path = false;
+		auto size = unknown_size;
+		auto crc = std::uint_least64_t{};
+		auto have_crc = false;
+		auto crc_model = &default_model;
+		
+		expect('{');
+		
+		if (!accept('}'))
+		{
+			do
+			{
+				auto const key = read_string();
+				expect(':');
+				
+				if (key == "path")
+				{
+					path = read_string();
+					have_path = true;
+				}
+				else if (key == "size")
+				{
+					if (!parse_number(read_number(), 10, size))
+						error("invalid size");
+				}
+				else if (key == "crc")
+				{
+					if (!parse_number(read_string(), 16, crc))
+						error("invalid CRC");
+					have_crc = true;
+				}
+				else if (key == "model")
+				{
+					crc_model = find_model(read_string());
+					if (!crc_model)
+						error("unknown model");
+				}
+				else
+				{
+					skip_value();
+				}
+			} while (accept(','));
+			
+			expect('}');
+		}
+		
+		if (!have_path || !have_crc)
+			error("entry without a path or CRC");
+		
+		add(m, path, size, crc, *crc_model);
+	}
+	
+	auto read_string() -> std::string
+	{
+		expect('"');
+		
+		auto s = std::string{};
+		
+		for (;;)
+		{
+			auto c = current_;
+			advance();
+			
+			if (c == EOF || c == '\n')
+				error("unterminated string");
+			
+			if (c == '"')
+				return s;
+			
+			if (c != '\\')
+			{
+				s += static_cast<char>(c);
+				continue;
+			}
+			
+			c = current_;
+			advance();
+			
+			switch (c)
+			{
+			case '"': case '\\': case '/': s += static_cast<char>(c); break;
+			case 'b': s += '\b'; break;
+			case 'f': s += '\f'; break;
+			case 'n': s += '\n'; break;
+			case 'r': s += '\r'; break;
+			case 't': s += '\t'; break;
+			case 'u': append_utf8(s, read_code_point()); break;
+			default: error("invalid escape sequence");
+			}
+		}
+	}
+	
+	auto read_code_point() -> unsigned long
+	{
+		auto code = read_hex4();
+		
+		// Combine surrogate pairs.
+		if (code >= 0xD800u && code < 0xDC00u && current_ == '\\')
+		{
+			advance();
+			if (current_ != 'u')
+				error("invalid escape sequence");
+			advance();
+			
+			auto const low = read_hex4();
+			if (low < 0xDC00u || low >= 0xE000u)
+				error("invalid surrogate pair");
+			
+			code = 0x10000uL + ((code - 0xD800u) << 10) + (low - 0xDC00u);
+		}
+		
+		return code;
+	}
+	
+	auto read_hex4() -> unsigned long
+	{
+		auto digits = std::string{};
+		for (auto n = 0; n < 4; ++n)
+		{
+			digits += static_cast<char>(current_);
+			advance();
+		}
+		
+		auto value = std::uint_least64_t{};
+		if (!parse_number(digits, 16, value))
+			error("invalid escape sequence");
+		
+		return static_cast<unsigned long>(value);
+	}
+	
+	static auto append_utf8(std::string& s, unsigned long code) -> void
+	{
+		if (code < 0x80u)
+		{
+			s += static_cast<char>(code);
+		}
+		else if (code < 0x800u)
+		{
+			s += static_cast<char>(0xC0u | (code >> 6));
+			s += static_cast<char>(0x80u | (code & 0x3Fu));
+		}
+		else if (code < 0x10000u)
+		{
+			s += static_cast<char>(0xE0u | (code >> 12));
+			s += static_cast<char>(0x80u | ((code >> 6) & 0x3Fu));
+			s += static_cast<char>(0x80u | (code & 0x3Fu));
+		}
+		else
+		{
+			s += static_cast<char>(0xF0u | (code >> 18));
+			s += static_cast<char>(0x80u | ((code >> 12) & 0x3Fu));
+			s += static_cast<char>(0x80u | ((code >> 6) & 0x3Fu));
+			s += static_cast<char>(0x80u | (code & 0x3Fu));
+		}
+	}
+	
+	auto read_number() -> std::string
+	{
+		skip_space();
+		
+		auto s = std::string{};
+		while (is_digit(static_cast<char>(current_)) || current_ == '-' ||
+				current_ == '+' || current_ == '.' || current_ == 'e' ||
+				current_ == 'E')
+		{
+			s += static_cast<char>(current_);
+			advance();
+		}
+		
+		return s;
+	}
+	
+	auto skip_value() -> void
+	{
+		switch (peek())
+		{
+		case '"':
+			read_string();
+			break;
+		case '{':
+			advance();
+			if (!accept('}'))
+			{
+				do
+				{
+					read_string();
+					expect(':');
+					skip_value();
+				} while (accept(','));
+				expect('}');
+			}
+			break;
+		case '[':
+			advance();
+			if (!accept(']'))
+			{
+				do
+				{
+					skip_value();
+				} while (accept(','));
+				expect(']');
+			}
+			break;
+		default:
+			// Numbers, true, false, and null.
+			while (current_ != EOF && current_ != ',' && current_ != '}' &&
+					current_ != ']' && current_ != ' ' && current_ != '\n')
+				advance();
+			break;
+		}
+	}
+	
+	auto advance() -> void
+	{
+		if (current_ == '\n')
+			++line_number_;
+		current_ = std::getc(file_.get());
+		if (current_ == EOF && std::ferror(file_.get()))
+			throw std::system_error{errno, std::generic_category(), path_};
+	}
+	
+	auto skip_space() -> void
+	{
+		while (current_ == ' ' || current_ == '\t' || current_ == '\n' ||
+				current_ == '\r')
+			advance();
+	}
+	
+	auto peek() -> int
+	{
+		skip_space();
+		return current_;
+	}
+	
+	auto accept(char c) -> bool
+	{
+		if (peek() != c)
+			return false;
+		advance();
+		return true;
+	}
+	
+	auto expect(char c) -> void
+	{
+		if (!accept(c))
+		{
+			char const message[] = {'e', 'x', 'p', 'e', 'c', 't', 'e', 'd',
+				' ', '\'', c, '\'', '\0'};
+			error(message);
+		}
+	}
+	
+	[[noreturn]] auto error(char const* message) const -> void
+	{
+		throw std::runtime_error{path_ + ":" +
+			std::to_string(line_number_) + ": " + message};
+	}
+	
+	std::string const& path_;
+	file_ptr file_;
+	int current_ = '\0';
+	std::size_t line_number_ = 1;
+};
+
+} // anonymous namespace
+
+auto detect_format(std::string const& path) -> format
+{
+	if (ends_with(path, ".sfv") || ends_with(path, ".SFV"))
+		return format::sfv;
+	if (ends_with(path, ".json") || ends_with(path, ".JSON"))
+		return format::json;
+	
+	auto const file = open(path);
+	
+	char buffer[64] = {};
+	auto const length = std::fread(buffer, 1, sizeof(buffer) - 1u,
+		file.get());
+	
+	auto p = buffer;
+	auto const end = buffer + length;
+	
+	while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+		++p;
+	
+	if (p != end && *p == '[')
+		return format::json;
+	
+	// cksum lines start with "DIGITS DIGITS ".
+	for (auto field = 0; field < 2; ++field)
+	{
+		if (p == end || !is_digit(*p))
+			return format::sfv;
+		while (p != end && is_digit(*p))
+			++p;
+		if (p == end || *p != ' ')
+			return format::sfv;
+		++p;
+	}
+	
+	return format::cksum;
+}
+
+auto read_manifest(std::string const& path, format f,
+	model const& default_model, manifest& m) -> void
+{
+	switch (f)
+	{
+	case format::cksum:
+		read_cksum(path, default_model, m);
+		break;
+	case format::sfv:
+		read_sfv(path, default_model, m);
+		break;
+	case format::json:
+		json_reader{path}.read(default_model, m);
+		break;
+	}
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
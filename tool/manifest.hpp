@@ -0,0 +1,89 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_MANIFEST_
+#define INDI_INC_CRC_TOOL_MANIFEST_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models.hpp"
+#include "output.hpp"
+#include "string-pool.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Size value for manifest entries that don't list a size.
+constexpr auto unknown_size = UINT_LEAST64_MAX;
+
+//! A single file listed in a manifest.
+struct manifest_entry
+{
+	//! The path, stored in the manifest's string pool.
+	char const* path;
+	
+	//! The expected size, or `unknown_size`.
+	std::uint_least64_t size;
+	
+	//! The expected CRC.
+	model::crc_t crc;
+	
+	//! The model the CRC was calculated with.
+	model const* crc_model;
+};
+
+//! The contents of one or more manifest files.
+//! 
+//! All the paths are kept in a single string pool, so memory use stays
+//! proportional to the total length of the paths, even for manifests
+//! with tens of millions of entries.
+struct manifest
+{
+	string_pool paths;
+	std::vector<manifest_entry> entries;
+};
+
+//! Guesses a manifest's format.
+//! 
+//! Files ending in `.sfv` or `.json` are taken to be in those formats.
+//! Otherwise, files starting with `[` are taken to be JSON, files whose
+//! first line starts with two numbers are taken to be cksum format,
+//! and anything else is taken to be SFV.
+//! 
+//! \throws std::system_error if the file could not be read.
+auto detect_format(std::string const& path) -> format;
+
+//! Reads a manifest, in any of the formats `indi-crc` writes, and
+//! appends its entries to `m`.
+//! 
+//! SFV and cksum manifests don't say which model was used, so
+//! `default_model` is used for them. (SFV manifests don't list sizes
+//! either.) JSON manifests name the model in every entry.
+//! 
+//! \throws std::system_error if the file could not be read.
+//! \throws std::runtime_error if the file is malformed; the message
+//!     includes the file name and line number.
+auto read_manifest(std::string const& path, format f,
+	model const& default_model, manifest& m) -> void;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,136 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "models.hpp"
+
+#include <utility>
+
+#include "indi/crc.hpp"
+#include "indi/crc-file.hpp"
+#include "indi/crc-simd.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+// The operations that depend on the bit-size at compile time.
+struct model::operations
+{
+	crc_t (*calculate)(model const&, int, std::uint_least64_t,
+		std::uint_least64_t, std::uint_least64_t*);
+	crc_t (*calculate_stream)(model const&, int, std::uint_least64_t*);
+	crc_t (*combine)(model const&, crc_t, crc_t, std::uint_least64_t);
+};
+
+template <std::size_t Bits>
+auto model::make(char const* name, std::uint_fast64_t polynomial) -> model
+{
+	using engine = clmul_engine<Bits, crc_t>;
+	
+	static auto const ops = operations{
+		[](model const& m, int fd, std::uint_least64_t offset,
+			std::uint_least64_t length, std::uint_least64_t* bytes_read)
+		{
+			constexpr auto ones = detail_::ones<Bits, crc_t>();
+			return crc_t(ones ^ calculate_raw_file<Bits>(ones, fd,
+				offset, length, m.engine<engine>(), bytes_read));
+		},
+		[](model const& m, int fd, std::uint_least64_t* bytes_read)
+		{
+			return calculate_stream<Bits, engine, crc_t>(fd,
+				m.engine<engine>(), bytes_read);
+		},
+		[](model const& m, crc_t crc1, crc_t crc2,
+			std::uint_least64_t length2)
+		{
+			return crc::combine<Bits>(crc1, crc2, length2,
+				m.polynomial_);
+		}
+	};
+	
+	return model{name, Bits, polynomial, ops,
+		std::make_shared<engine const>(polynomial)};
+}
+
+model::model(char const* name, std::size_t bits,
+		std::uint_fast64_t polynomial, operations const& ops,
+		std::shared_ptr<void const> engine) :
+	name_{name},
+	bits_{bits},
+	polynomial_{polynomial},
+	ops_{&ops},
+	engine_{std::move(engine)}
+{}
+
+auto model::calculate(int fd, std::uint_least64_t offset,
+		std::uint_least64_t length,
+		std::uint_least64_t* bytes_read) const -> crc_t
+{
+	return ops_->calculate(*this, fd, offset, length, bytes_read);
+}
+
+auto model::calculate(int fd, std::uint_least64_t* bytes_read) const
+	-> crc_t
+{
+	return ops_->calculate_stream(*this, fd, bytes_read);
+}
+
+auto model::combine(crc_t crc1, crc_t crc2, std::uint_least64_t length2)
+	const noexcept -> crc_t
+{
+	return ops_->combine(*this, crc1, crc2, length2);
+}
+
+auto models() -> std::vector<model> const&
+{
+	namespace polys = polynomials;
+	
+	static auto const all = std::vector<model>{
+		model::make<16>("crc16",             polys::crc16),
+		model::make<16>("crc16_ibm",         polys::crc16_ibm),
+		model::make<16>("crc16_ccitt",       polys::crc16_ccitt),
+		model::make<16>("crc16_t10_dif",     polys::crc16_t10_dif),
+		model::make<16>("crc16_dnp",         polys::crc16_dnp),
+		model::make<16>("crc16_dect",        polys::crc16_dect),
+		model::make<16>("crc16_arinc",       polys::crc16_arinc),
+		model::make<16>("crc16_chakravarty", polys::crc16_chakravarty),
+		model::make<32>("crc32",             polys::crc32),
+		model::make<32>("crc32_ieee",        polys::crc32_ieee),
+		model::make<32>("crc32_ansi",        polys::crc32_ansi),
+		model::make<32>("crc32c",            polys::crc32c),
+		model::make<32>("crc32k",            polys::crc32k),
+		model::make<32>("crc32q",            polys::crc32q),
+		model::make<64>("crc64_iso",         polys::crc64_iso),
+		model::make<64>("crc64_ecma",        polys::crc64_ecma),
+	};
+	
+	return all;
+}
+
+auto find_model(std::string const& name) -> model const*
+{
+	for (auto const& m : models())
+	{
+		if (name == m.name())
+			return &m;
+	}
+	
+	return nullptr;
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
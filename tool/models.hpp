@@ -0,0 +1,110 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_MODELS_
+#define INDI_INC_CRC_TOOL_MODELS_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! A CRC model that the tool can calculate.
+//! 
+//! A model is just a named polynomial and bit-size from
+//! `indi::crc::polynomials`, calculated the way `indi::crc::calculate`
+//! does it, with a `clmul_engine` (so with carry-less multiplication
+//! where the CPU has it). Because the bit-size is only known at run
+//! time, all CRC values are handled as `std::uint_fast64_t`.
+class model
+{
+public:
+	using crc_t = std::uint_fast64_t;
+	
+	//! Creates a model for a given bit-size and polynomial.
+	template <std::size_t Bits>
+	static auto make(char const* name, std::uint_fast64_t polynomial)
+		-> model;
+	
+	auto name() const noexcept { return name_; }
+	auto bits() const noexcept { return bits_; }
+	auto polynomial() const noexcept { return polynomial_; }
+	
+	//! Gets the number of hex digits needed to show a CRC.
+	auto hex_digits() const noexcept { return (bits_ + 3u) / 4u; }
+	
+	//! Calculates the CRC of part of an open file.
+	//! 
+	//! \throws std::system_error on read errors.
+	auto calculate(int fd, std::uint_least64_t offset,
+		std::uint_least64_t length,
+		std::uint_least64_t* bytes_read) const -> crc_t;
+	
+	//! Calculates the CRC of a stream, from its current position to
+	//! the end.
+	//! 
+	//! \throws std::system_error on read errors.
+	auto calculate(int fd, std::uint_least64_t* bytes_read) const
+		-> crc_t;
+	
+	//! Combines the CRCs of two consecutive pieces.
+	auto combine(crc_t crc1, crc_t crc2, std::uint_least64_t length2)
+		const noexcept -> crc_t;
+
+private:
+	struct operations;
+	
+	model(char const* name, std::size_t bits,
+		std::uint_fast64_t polynomial, operations const& ops,
+		std::shared_ptr<void const> engine);
+	
+	// The engine's type depends on the bit-size, so only the operations
+	// know what it is.
+	template <typename Engine>
+	auto engine() const noexcept -> Engine const&
+	{
+		return *static_cast<Engine const*>(engine_.get());
+	}
+	
+	char const* name_;
+	std::size_t bits_;
+	std::uint_fast64_t polynomial_;
+	operations const* ops_;
+	std::shared_ptr<void const> engine_;
+};
+
+//! Gets every model the tool knows about.
+//! 
+//! This is every polynomial in `indi::crc::polynomials`, under the same
+//! names (including the aliases, like `crc32` and `crc16`).
+auto models() -> std::vector<model> const&;
+
+//! Finds a model by name.
+//! 
+//! \returns A pointer to the model, or null if there is none with that
+//!     name.
+auto find_model(std::string const& name) -> model const*;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,269 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "options.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+auto parse_number(std::string const& s, std::uint_least64_t& value,
+	std::string& suffix) -> bool
+{
+	if (s.empty() || s[0] < '0' || s[0] > '9')
+		return false;
+	
+	auto end = static_cast<char*>(nullptr);
+	errno = 0;
+	auto const n = std::strtoull(s.c_str(), &end, 10);
+	if (errno == ERANGE ||
+			n > std::numeric_limits<std::uint_least64_t>::max())
+		return false;
+	
+	value = static_cast<std::uint_least64_t>(n);
+	suffix = end;
+	return true;
+}
+
+auto parse_size(std::string const& s, std::uint_least64_t& size) -> bool
+{
+	auto value = std::uint_least64_t{};
+	auto suffix = std::string{};
+	if (!parse_number(s, value, suffix))
+		return false;
+	
+	auto shift = 0;
+	if (suffix == "K" || suffix == "k")
+		shift = 10;
+	else if (suffix == "M" || suffix == "m")
+		shift = 20;
+	else if (suffix == "G" || suffix == "g")
+		shift = 30;
+	else if (!suffix.empty())
+		return false;
+	
+	if (value > (std::numeric_limits<std::uint_least64_t>::max() >> shift))
+		return false;
+	
+	size = value << shift;
+	return true;
+}
+
+auto parse_command_line(int argc, char const* const argv[])
+	-> command_line
+{
+	auto result = command_line{};
+	auto& options = result.options;
+	options.crc_model = find_model("crc32");
+	options.split_size = std::uint_least64_t{64u} << 20;
+	
+	auto check = false;
+	auto scrubbing = false;
+	
+	// Gets the argument for an option, either from the rest of the
+	// current argument ("-j4" or "--jobs=4") or from the next one.
+	auto n = 1;
+	auto option_argument = [&](std::string const& arg,
+		std::string const& name, std::size_t inline_pos)
+	{
+		if (inline_pos < arg.size())
+			return arg.substr(inline_pos);
+		if (n + 1 >= argc)
+			throw usage_error{"option '" + name + "' requires an argument"};
+		return std::string{argv[++n]};
+	};
+	
+	// Options without an argument must not have anything after them
+	// ("-cq" or "--check=yes").
+	auto no_argument = [](std::string const& arg, std::string const& name,
+		std::size_t inline_pos)
+	{
+		if (inline_pos < arg.size())
+			throw usage_error{"option '" + name +
+				"' doesn't allow an argument"};
+	};
+	
+	auto end_of_options = false;
+	for (; n < argc; ++n)
+	{
+		auto const arg = std::string{argv[n]};
+		
+		if (end_of_options || arg.size() < 2 || arg[0] != '-')
+		{
+			result.paths.push_back(arg);
+			continue;
+		}
+		
+		if (arg == "--")
+		{
+			end_of_options = true;
+			continue;
+		}
+		
+		// Split "--name=value" and "-xvalue" forms.
+		auto name = arg;
+		auto inline_pos = arg.size();
+		if (arg[1] == '-')
+		{
+			auto const eq = arg.find('=');
+			if (eq != std::string::npos)
+			{
+				name = arg.substr(0, eq);
+				inline_pos = eq + 1;
+			}
+		}
+		else
+		{
+			name = arg.substr(0, 2);
+			inline_pos = 2;
+		}
+		
+		if (name == "-h" || name == "--help")
+		{
+			no_argument(arg, name, inline_pos);
+			result.what = action::help;
+			return result;
+		}
+		else if (name == "--list-models")
+		{
+			no_argument(arg, name, inline_pos);
+			result.what = action::list_models;
+			return result;
+		}
+		else if (name == "-m" || name == "--model")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			options.crc_model = find_model(value);
+			if (!options.crc_model)
+				throw usage_error{"unknown model '" + value + "'"};
+		}
+		else if (name == "-f" || name == "--format")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			if (!parse_format(value, options.output_format))
+				throw usage_error{"unknown format '" + value + "'"};
+			result.check_options.detect_format = false;
+		}
+		else if (name == "-j" || name == "--jobs")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			auto jobs = std::uint_least64_t{};
+			auto suffix = std::string{};
+			if (!parse_number(value, jobs, suffix) || !suffix.empty() ||
+					jobs == 0u || jobs > 4096u)
+				throw usage_error{"invalid number of jobs '" + value + "'"};
+			options.jobs = static_cast<std::size_t>(jobs);
+		}
+		else if (name == "-s" || name == "--split-size")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			if (!parse_size(value, options.split_size))
+				throw usage_error{"invalid size '" + value + "'"};
+		}
+		else if (name == "--cache")
+		{
+			result.use_cache = true;
+			if (inline_pos < arg.size())
+				result.cache_database = arg.substr(inline_pos);
+		}
+		else if (name == "-c" || name == "--check")
+		{
+			no_argument(arg, name, inline_pos);
+			check = true;
+		}
+		else if (name == "--scrub")
+		{
+			no_argument(arg, name, inline_pos);
+			scrubbing = true;
+		}
+		else if (name == "--rate")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			if (!parse_size(value, result.scrub_opts.rate))
+				throw usage_error{"invalid rate '" + value + "'"};
+		}
+		else if (name == "--cpu")
+		{
+			auto const value = option_argument(arg, name, inline_pos);
+			auto percent = std::uint_least64_t{};
+			auto suffix = std::string{};
+			if (!parse_number(value, percent, suffix) ||
+					(!suffix.empty() && suffix != "%") || percent == 0u ||
+					percent > 100u)
+				throw usage_error{"invalid CPU percentage '" + value + "'"};
+			result.scrub_opts.cpu_share = static_cast<double>(percent) /
+				100.0;
+		}
+		else if (name == "--state")
+		{
+			result.scrub_opts.state = option_argument(arg, name,
+				inline_pos);
+		}
+		else if (name == "--repeat")
+		{
+			no_argument(arg, name, inline_pos);
+			result.scrub_opts.repeat = true;
+		}
+		else if (name == "--fail-fast")
+		{
+			no_argument(arg, name, inline_pos);
+			result.check_options.fail_fast = true;
+		}
+		else if (name == "--checkpoint")
+		{
+			result.check_options.checkpoint = option_argument(arg, name,
+				inline_pos);
+		}
+		else if (name == "-q" || name == "--quiet")
+		{
+			no_argument(arg, name, inline_pos);
+			result.check_options.quiet = true;
+		}
+		else
+		{
+			throw usage_error{"unrecognized option '" + arg + "'"};
+		}
+	}
+	
+	if (check && scrubbing)
+		throw usage_error{"--check and --scrub can't be used together"};
+	if (check && result.paths.empty())
+		throw usage_error{"no manifest given"};
+	if (scrubbing && result.paths.empty())
+		throw usage_error{"nothing to scrub"};
+	if (result.paths.empty())
+		result.paths.push_back("-");
+	
+	auto& check_options = result.check_options;
+	check_options.crc_model = options.crc_model;
+	check_options.manifest_format = options.output_format;
+	check_options.jobs = options.jobs;
+	check_options.split_size = options.split_size;
+	result.scrub_opts.crc_model = options.crc_model;
+	
+	result.what = check ? action::check :
+		scrubbing ? action::scrub :
+		action::checksum;
+	return result;
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,92 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_OPTIONS_
+#define INDI_INC_CRC_TOOL_OPTIONS_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "checksum.hpp"
+#include "models.hpp"
+#include "output.hpp"
+#include "scrub.hpp"
+#include "verify.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Thrown for invalid command lines.
+class usage_error : public std::runtime_error
+{
+public:
+	using std::runtime_error::runtime_error;
+};
+
+//! What the command line asks for.
+enum class action
+{
+	checksum,
+	check,
+	scrub,
+	help,
+	list_models
+};
+
+//! A parsed command line.
+struct command_line
+{
+	action what = action::checksum;
+	
+	//! The options for each action. The model, format, jobs, and split
+	//! size given are copied into all three.
+	checksum_options options;
+	verify_options check_options;
+	scrub_options scrub_opts;
+	
+	//! Use the checksum cache, with the given database file (if any).
+	bool use_cache = false;
+	std::string cache_database;
+	
+	std::vector<std::string> paths;
+};
+
+//! Parses a decimal number, returning the unparsed suffix.
+//! 
+//! \returns False if `s` does not start with a digit, or the number
+//!     does not fit.
+auto parse_number(std::string const& s, std::uint_least64_t& value,
+	std::string& suffix) -> bool;
+
+//! Parses a size, with an optional K, M, or G suffix (powers of 1024).
+//! 
+//! \returns False if `s` is not a valid size, or the size does not fit.
+auto parse_size(std::string const& s, std::uint_least64_t& size) -> bool;
+
+//! Parses the command line.
+//! 
+//! \throws usage_error if it is invalid.
+auto parse_command_line(int argc, char const* const argv[])
+	-> command_line;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,127 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+auto parse_format(std::string const& name, format& f) -> bool
+{
+	if (name == "cksum")
+		f = format::cksum;
+	else if (name == "sfv")
+		f = format::sfv;
+	else if (name == "json")
+		f = format::json;
+	else
+		return false;
+	
+	return true;
+}
+
+writer::writer(std::FILE* out, format f, model const& m) :
+	out_{out},
+	format_{f},
+	model_{&m}
+{}
+
+auto writer::begin() -> void
+{
+	if (format_ == format::json)
+		std::fputs("[", out_);
+}
+
+auto writer::write(std::string const& path, std::uint_least64_t size,
+	model::crc_t crc) -> void
+{
+	auto const digits = static_cast<int>(model_->hex_digits());
+	auto const crc_ull = static_cast<unsigned long long>(crc);
+	auto const size_ull = static_cast<unsigned long long>(size);
+	
+	switch (format_)
+	{
+	case format::cksum:
+		// Like cksum, leave out the name when reading standard input.
+		if (path == "-")
+			std::fprintf(out_, "%llu %llu\n", crc_ull, size_ull);
+		else
+			std::fprintf(out_, "%llu %llu %s\n", crc_ull, size_ull,
+				path.c_str());
+		break;
+	case format::sfv:
+		std::fprintf(out_, "%s %0*llX\n", path.c_str(), digits, crc_ull);
+		break;
+	case format::json:
+		std::fprintf(out_, "%s\n  {\"path\": \"%s\", \"size\": %llu, "
+				"\"model\": \"%s\", \"crc\": \"%0*llx\"}",
+			first_ ? "" : ",", json_escape(path).c_str(), size_ull,
+			model_->name(), digits, crc_ull);
+		break;
+	}
+	
+	first_ = false;
+}
+
+auto writer::end() -> void
+{
+	if (format_ == format::json)
+		std::fputs(first_ ? "]\n" : "\n]\n", out_);
+	
+	std::fflush(out_);
+}
+
+auto json_escape(std::string const& s) -> std::string
+{
+	auto result = std::string{};
+	result.reserve(s.size());
+	
+	for (auto const c : s)
+	{
+		switch (c)
+		{
+		case '"': result += "\\\""; break;
+		case '\\': result += "\\\\"; break;
+		case '\b': result += "\\b"; break;
+		case '\f': result += "\\f"; break;
+		case '\n': result += "\\n"; break;
+		case '\r': result += "\\r"; break;
+		case '\t': result += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20u)
+			{
+				char buffer[8];
+				std::snprintf(buffer, sizeof(buffer), "\\u%04x",
+					static_cast<unsigned>(c));
+				result += buffer;
+			}
+			else
+			{
+				// Everything else (including non-ASCII bytes) is passed
+				// through as-is: file names are just bytes.
+				result += c;
+			}
+			break;
+		}
+	}
+	
+	return result;
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,84 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_OUTPUT_
+#define INDI_INC_CRC_TOOL_OUTPUT_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "models.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Checksum list formats.
+//! 
+//! * `cksum`: `CRC SIZE PATH`, with the CRC in decimal, as written by
+//!   the POSIX `cksum` utility.
+//! * `sfv`: `PATH CRC`, with the CRC in upper-case hex, as in Simple
+//!   File Verification files.
+//! * `json`: an array of objects with `path`, `size`, `model`, and
+//!   `crc` members, with the CRC as a lower-case hex string.
+//! 
+//! Note that `cksum` format only describes the layout of the lines;
+//! the CRC itself is always the one for the selected model, which is
+//! not the same as the CRC the POSIX utility calculates.
+enum class format
+{
+	cksum,
+	sfv,
+	json
+};
+
+//! Parses a format name.
+//! 
+//! \returns True if `name` was a valid format name.
+auto parse_format(std::string const& name, format& f) -> bool;
+
+//! Writes a checksum list.
+class writer
+{
+public:
+	writer(std::FILE* out, format f, model const& m);
+	
+	//! Writes any header the format needs.
+	auto begin() -> void;
+	
+	//! Writes a single entry.
+	auto write(std::string const& path, std::uint_least64_t size,
+		model::crc_t crc) -> void;
+	
+	//! Writes any footer the format needs, and flushes the output.
+	auto end() -> void;
+
+private:
+	std::FILE* out_;
+	format format_;
+	model const* model_;
+	bool first_ = true;
+};
+
+//! Escapes a string for use inside a JSON string literal.
+auto json_escape(std::string const& s) -> std::string;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
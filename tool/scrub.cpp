@@ -0,0 +1,466 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scrub.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "indi/crc-file.hpp"
+
+#include "file-task.hpp"
+#include "walk.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// How much to read at a time.
+constexpr auto chunk_size = std::uint_least64_t{1u} << 20;
+
+// How often to save the position.
+constexpr auto state_interval = std::chrono::seconds{5};
+
+// Lowers the calling thread's I/O priority to idle, so its reads only
+// go to disk when nothing else wants it. Failure (other than on Linux,
+// this is not supported) is ignored: pacing still applies.
+auto set_idle_io_priority() -> void
+{
+#if defined(__linux__) && defined(SYS_ioprio_set)
+	constexpr auto ioprio_who_process = 1;
+	constexpr auto ioprio_class_idle = 3;
+	constexpr auto ioprio_class_shift = 13;
+	
+	::syscall(SYS_ioprio_set, ioprio_who_process, 0,
+		ioprio_class_idle << ioprio_class_shift);
+#endif
+}
+
+// Limits the average rate of reads.
+//
+// Tokens (bytes) accumulate at `rate` per second, up to one second's
+// worth, and every read must take as many tokens as it reads, waiting
+// for them if need be. The bucket starts empty, so starting up doesn't
+// cause a burst.
+class token_bucket
+{
+public:
+	explicit token_bucket(std::uint_least64_t rate) :
+		rate_(static_cast<double>(rate)),
+		capacity_(std::max(rate_, static_cast<double>(chunk_size))),
+		tokens_(0.0),
+		last_(clock::now())
+	{}
+	
+	auto take(std::uint_least64_t bytes) -> void
+	{
+		if (rate_ <= 0.0)
+			return;
+		
+		auto const now = clock::now();
+		tokens_ = std::min(capacity_, tokens_ + rate_ *
+			std::chrono::duration<double>(now - last_).count());
+		last_ = now;
+		
+		tokens_ -= static_cast<double>(bytes);
+		if (tokens_ < 0.0)
+		{
+			// Sleep until the debt is paid off.
+			std::this_thread::sleep_for(std::chrono::duration<double>(
+				-tokens_ / rate_));
+		}
+	}
+
+private:
+	double const rate_;
+	double const capacity_;
+	double tokens_;
+	clock::time_point last_;
+};
+
+// Limits the share of a CPU the calling thread uses, by sleeping
+// whenever it has used more than its share of the time since the last
+// window started.
+class cpu_pacer
+{
+public:
+	explicit cpu_pacer(double share) :
+		share_(share)
+	{
+		restart();
+	}
+	
+	auto pace() -> void
+	{
+		if (share_ >= 1.0)
+			return;
+		
+		auto const cpu = cpu_time() - cpu_start_;
+		auto const wall = std::chrono::duration<double>(
+			clock::now() - wall_start_).count();
+		
+		auto const wanted = cpu / share_;
+		if (wanted > wall)
+			std::this_thread::sleep_for(std::chrono::duration<double>(
+				wanted - wall));
+		
+		// Keep the window short, so time spent blocked on I/O long ago
+		// doesn't allow a burst now.
+		if (wall > 10.0)
+			restart();
+	}
+
+private:
+	static auto cpu_time() -> double
+	{
+		struct ::timespec t;
+		::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+		return static_cast<double>(t.tv_sec) +
+			static_cast<double>(t.tv_nsec) / 1e9;
+	}
+	
+	auto restart() -> void
+	{
+		wall_start_ = clock::now();
+		cpu_start_ = cpu_time();
+	}
+	
+	double const share_;
+	clock::time_point wall_start_;
+	double cpu_start_;
+};
+
+// Compares paths in the order `walk` reports them: component by
+// component, with each component compared byte-wise.
+auto walk_order_less(std::string const& a, std::string const& b) -> bool
+{
+	auto i = std::size_t{0};
+	auto j = std::size_t{0};
+	
+	for (;;)
+	{
+		while (i < a.size() && a[i] == '/')
+			++i;
+		while (j < b.size() && b[j] == '/')
+			++j;
+		
+		if (i == a.size() || j == b.size())
+			return i == a.size() && j != b.size();
+		
+		auto const ai = std::min(a.find('/', i), a.size());
+		auto const bj = std::min(b.find('/', j), b.size());
+		
+		auto const c = a.compare(i, ai - i, b, j, bj - j);
+		if (c != 0)
+			return c < 0;
+		
+		i = ai;
+		j = bj;
+	}
+}
+
+// Where a pass has got to: the index of the path being walked, and the
+// last file finished in it.
+struct cursor
+{
+	std::size_t root = 0;
+	std::string path;
+};
+
+auto load_cursor(std::string const& state) -> cursor
+{
+	auto c = cursor{};
+	
+	auto const f = std::fopen(state.c_str(), "r");
+	if (!f)
+	{
+		if (errno != ENOENT)
+			throw std::system_error{errno, std::generic_category(), state};
+		return c;
+	}
+	
+	// "indi-crc-scrub 1 ROOT\nPATH"; anything else starts from scratch.
+	auto version = 0u;
+	auto root = 0uLL;
+	if (std::fscanf(f, "indi-crc-scrub %u %llu", &version, &root) == 2 &&
+			version == 1u && std::fgetc(f) == '\n')
+	{
+		c.root = static_cast<std::size_t>(root);
+		for (auto ch = std::fgetc(f); ch != EOF; ch = std::fgetc(f))
+			c.path += static_cast<char>(ch);
+	}
+	
+	std::fclose(f);
+	return c;
+}
+
+auto save_cursor(std::string const& state, cursor const& c) -> void
+{
+	auto const temp = state + ".tmp";
+	auto const f = std::fopen(temp.c_str(), "w");
+	if (!f)
+		throw std::system_error{errno, std::generic_category(), temp};
+	
+	std::fprintf(f, "indi-crc-scrub 1 %llu\n%s",
+		static_cast<unsigned long long>(c.root), c.path.c_str());
+	
+	auto const failed = std::ferror(f) != 0;
+	if (std::fclose(f) != 0 || failed ||
+			std::rename(temp.c_str(), state.c_str()) != 0)
+		throw std::system_error{errno, std::generic_category(), state};
+}
+
+// Thrown when a checksum can't be stored although the file hasn't
+// changed, which means the cache can't keep checksums for it at all.
+class cannot_record : public std::runtime_error
+{
+public:
+	using std::runtime_error::runtime_error;
+};
+
+class scrubber
+{
+public:
+	scrubber(scrub_options const& options, std::FILE* out) :
+		options_(options),
+		model_(*options.crc_model),
+		out_(out),
+		bucket_(options.rate),
+		pacer_(options.cpu_share)
+	{}
+	
+	auto run(std::vector<std::string> const& paths) -> bool
+	{
+		set_idle_io_priority();
+		
+		if (!options_.state.empty())
+			cursor_ = load_cursor(options_.state);
+		
+		do
+		{
+			pass(paths);
+		} while (options_.repeat);
+		
+		return ok_;
+	}
+
+private:
+	auto pass(std::vector<std::string> const& paths) -> void
+	{
+		verified_ = recorded_ = failed_ = 0;
+		
+		for (auto root = cursor_.root; root < paths.size(); ++root)
+		{
+			// Only the path the last run stopped in is part done.
+			if (root != cursor_.root)
+				cursor_ = cursor{root, {}};
+			
+			walk(paths[root],
+				[this](std::string const& p)
+				{
+					if (cursor_.path.empty() ||
+							walk_order_less(cursor_.path, p))
+						file(p);
+				},
+				[this](std::string const& p, int e)
+				{
+					error(p, std::system_error{e, std::generic_category()});
+				});
+		}
+		
+		std::fprintf(stderr, "indi-crc: scrub pass complete: %llu "
+				"verified, %llu recorded, %llu FAILED\n",
+			static_cast<unsigned long long>(verified_),
+			static_cast<unsigned long long>(recorded_),
+			static_cast<unsigned long long>(failed_));
+		
+		cursor_ = cursor{};
+		save_state(true);
+	}
+	
+	auto file(std::string const& path) -> void
+	{
+		try
+		{
+			check(path);
+		}
+		catch (cannot_record const&)
+		{
+			throw;
+		}
+		catch (std::exception const& e)
+		{
+			error(path, e);
+		}
+		
+		cursor_.path = path;
+		save_state(false);
+	}
+	
+	auto check(std::string const& path) -> void
+	{
+		auto const fd = open_file(path);
+		
+		struct ::stat st;
+		if (::fstat(fd.get(), &st) != 0)
+			detail_::throw_errno(path);
+		if (!S_ISREG(st.st_mode))
+			return;
+		
+#if defined(POSIX_FADV_NOREUSE)
+		::posix_fadvise(fd.get(), 0, 0, POSIX_FADV_NOREUSE);
+#endif
+		
+		auto stored = std::uintmax_t{};
+		auto const have_stored = options_.cache->find(path, st, model_.name(),
+			stored);
+		
+		auto const size = static_cast<std::uint_least64_t>(st.st_size);
+		auto crc = model::crc_t{0};
+		
+		for (auto offset = std::uint_least64_t{0}; offset < size;)
+		{
+			auto const length = std::min(chunk_size, size - offset);
+			bucket_.take(length);
+			
+			auto bytes_read = std::uint_least64_t{0};
+			auto const c = model_.calculate(fd.get(), offset, length,
+				&bytes_read);
+			
+			// Starting from 0, the CRC of no data, combining gives the
+			// CRC of the first chunk.
+			crc = model_.combine(crc, c, bytes_read);
+			offset += bytes_read;
+			
+			pacer_.pace();
+			
+			if (bytes_read != length)
+				break;
+		}
+		
+		// If the file was written while it was read, neither the stored
+		// checksum nor the new one can be trusted; the next pass will
+		// see the new modification time.
+		struct ::stat now;
+		if (::fstat(fd.get(), &now) != 0)
+			detail_::throw_errno(path);
+		if (now.st_size != st.st_size || now.st_mtim.tv_sec !=
+				st.st_mtim.tv_sec || now.st_mtim.tv_nsec != st.st_mtim.tv_nsec)
+			return;
+		
+		if (!have_stored)
+		{
+			if (options_.cache->store(path, st, model_.name(), crc))
+				++recorded_;
+			else
+				not_recorded(path, st);
+		}
+		else if (crc == static_cast<model::crc_t>(stored))
+		{
+			++verified_;
+		}
+		else
+		{
+			std::fprintf(out_, "%s: FAILED\n", path.c_str());
+			std::fflush(out_);
+			std::fprintf(stderr, "indi-crc: %s: contents changed without "
+				"the modification time changing\n", path.c_str());
+			++failed_;
+			ok_ = false;
+		}
+	}
+	
+	// A checksum couldn't be stored. If the file changed meanwhile, the
+	// next pass will record it; otherwise, nothing can be recorded, and
+	// scrubbing would never check anything, so give up.
+	auto not_recorded(std::string const& path, struct ::stat const& st)
+		-> void
+	{
+		struct ::stat now;
+		if (::stat(path.c_str(), &now) != 0 ||
+				!cache_record::from_stat(st, 0u).matches(now))
+			return;
+		
+		throw cannot_record{path + ": can't store checksums (extended "
+			"attributes not supported?); use --cache=FILE to keep them in "
+			"a database"};
+	}
+	
+	auto error(std::string const& path, std::exception const& e) -> void
+	{
+		std::fprintf(stderr, "indi-crc: %s\n", error_message(path, e).c_str());
+		ok_ = false;
+	}
+	
+	auto save_state(bool now) -> void
+	{
+		if (options_.state.empty())
+			return;
+		
+		auto const t = clock::now();
+		if (!now && t - last_save_ < state_interval)
+			return;
+		
+		save_cursor(options_.state, cursor_);
+		options_.cache->save();
+		last_save_ = t;
+	}
+	
+	scrub_options const& options_;
+	model const& model_;
+	std::FILE* out_;
+	token_bucket bucket_;
+	cpu_pacer pacer_;
+	
+	cursor cursor_;
+	clock::time_point last_save_ = clock::now();
+	
+	std::uint_least64_t verified_ = 0;
+	std::uint_least64_t recorded_ = 0;
+	std::uint_least64_t failed_ = 0;
+	bool ok_ = true;
+};
+
+} // anonymous namespace
+
+auto scrub(std::vector<std::string> const& paths,
+	scrub_options const& options, std::FILE* out) -> bool
+{
+	scrubber s{options, out};
+	return s.run(paths);
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
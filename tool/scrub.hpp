@@ -0,0 +1,85 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_SCRUB_
+#define INDI_INC_CRC_TOOL_SCRUB_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "indi/crc-cache.hpp"
+
+#include "models.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+struct scrub_options
+{
+	//! The CRC model to calculate.
+	model const* crc_model = nullptr;
+	
+	//! Where the stored checksums are kept.
+	checksum_cache* cache = nullptr;
+	
+	//! The most bytes to read per second, or 0 for no limit.
+	std::uint_least64_t rate = 0;
+	
+	//! The most CPU time to use, as a fraction of one CPU.
+	double cpu_share = 1.0;
+	
+	//! A file to keep the scrubber's position in, so it can carry on
+	//! where it left off after a restart. Empty means none.
+	std::string state;
+	
+	//! Start again from the beginning after every pass, forever.
+	bool repeat = false;
+};
+
+//! Scrubs files for silent corruption.
+//! 
+//! Every path is walked (see `walk`), and every file found is read
+//! and checked against the checksum stored for it in the cache. Files
+//! without a valid stored checksum (new files, and files that have
+//! been legitimately changed since) have one stored instead, so the
+//! next pass checks them. A file whose contents no longer match its
+//! stored checksum, even though its size and modification time haven't
+//! changed, has been corrupted, and is reported as `PATH: FAILED`.
+//! 
+//! The scrubber is meant to run in the background alongside other
+//! work, so it reads one file at a time with idle I/O priority, paces
+//! its reads with a token bucket to stay under `rate`, and sleeps as
+//! needed to stay under `cpu_share`.
+//! 
+//! \throws std::runtime_error if a checksum could not be stored for a
+//!     file that hadn't changed (so the cache can't keep checksums for
+//!     it, as when extended attributes aren't supported and there is no
+//!     database).
+//! \throws std::system_error if the state file could not be read or
+//!     written.
+//! 
+//! \returns True if no corruption or errors were found.
+auto scrub(std::vector<std::string> const& paths,
+	scrub_options const& options, std::FILE* out) -> bool;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
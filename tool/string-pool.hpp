@@ -0,0 +1,91 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_STRING_POOL_
+#define INDI_INC_CRC_TOOL_STRING_POOL_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Append-only storage for lots of small strings.
+//! 
+//! Strings are copied end-to-end into large blocks, so storing millions
+//! of paths costs one allocation per block instead of one (or more) per
+//! path, with no per-string overhead beyond the terminating null.
+//! Strings are never moved, so the pointers returned stay valid for the
+//! lifetime of the pool.
+class string_pool
+{
+public:
+	explicit string_pool(std::size_t block_size = std::size_t{1} << 20) :
+		block_size_{block_size}
+	{}
+	
+	//! Copies a string into the pool.
+	//! 
+	//! \returns A pointer to the null-terminated copy.
+	auto add(char const* s, std::size_t length) -> char const*
+	{
+		auto const needed = length + 1u;
+		
+		if (needed > left_)
+		{
+			// Oversized strings get a block of their own, so they don't
+			// waste the rest of the current block.
+			auto const size = std::max(needed, block_size_);
+			blocks_.push_back(std::make_unique<char[]>(size));
+			
+			if (size != block_size_)
+			{
+				auto const p = blocks_.back().get();
+				std::memcpy(p, s, length);
+				p[length] = '\0';
+				return p;
+			}
+			
+			next_ = blocks_.back().get();
+			left_ = size;
+		}
+		
+		auto const p = next_;
+		std::memcpy(p, s, length);
+		p[length] = '\0';
+		
+		next_ += needed;
+		left_ -= needed;
+		
+		return p;
+	}
+
+private:
+	std::size_t block_size_;
+	std::vector<std::unique_ptr<char[]>> blocks_;
+	char* next_ = nullptr;
+	std::size_t left_ = 0;
+};
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
@@ -0,0 +1,184 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread-pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+// The pool the current thread is a worker of (if any), and its index
+// in that pool.
+thread_local thread_pool const* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+} // anonymous namespace
+
+thread_pool::thread_pool(std::size_t threads)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+	
+	queues_.reserve(threads);
+	for (auto n = std::size_t{0}; n < threads; ++n)
+		queues_.push_back(std::make_unique<queue>());
+	
+	threads_.reserve(threads);
+	for (auto n = std::size_t{0}; n < threads; ++n)
+		threads_.emplace_back([this, n] { run(n); });
+}
+
+thread_pool::~thread_pool()
+{
+	wait();
+	
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		stop_ = true;
+	}
+	wake_.notify_all();
+	
+	for (auto& thread : threads_)
+		thread.join();
+}
+
+auto thread_pool::submit(task t) -> void
+{
+	auto const index = (current_pool == this) ?
+		current_index :
+		(next_++ % queues_.size());
+	
+	++pending_;
+	++queued_;
+	
+	{
+		auto& q = *queues_[index];
+		std::lock_guard<std::mutex> lock{q.mutex};
+		q.tasks.push_back(std::move(t));
+	}
+	
+	// Taking the lock (even briefly) before notifying ensures a worker
+	// that has just found nothing to do, but has not yet started
+	// waiting, cannot miss the wake-up.
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+	}
+	wake_.notify_one();
+}
+
+auto thread_pool::wait() -> void
+{
+	std::unique_lock<std::mutex> lock{mutex_};
+	idle_.wait(lock, [this] { return pending_ == 0; });
+}
+
+auto thread_pool::try_pop(std::size_t index, task& t) -> bool
+{
+	// First, try our own queue, newest first.
+	{
+		auto& q = *queues_[index];
+		std::lock_guard<std::mutex> lock{q.mutex};
+		if (!q.tasks.empty())
+		{
+			t = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+	}
+	
+	// Then try to steal from everyone else, oldest first.
+	for (auto n = std::size_t{1}; n < queues_.size(); ++n)
+	{
+		auto& q = *queues_[(index + n) % queues_.size()];
+		std::unique_lock<std::mutex> lock{q.mutex, std::try_to_lock};
+		if (lock && !q.tasks.empty())
+		{
+			t = std::move(q.tasks.front());
+			q.tasks.pop_front();
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+auto thread_pool::run(std::size_t index) -> void
+{
+	current_pool = this;
+	current_index = index;
+	
+	auto t = task{};
+	auto misses = 0u;
+	
+	for (;;)
+	{
+		if (queued_ != 0 && try_pop(index, t))
+		{
+			--queued_;
+			misses = 0;
+			
+			t();
+			t = nullptr;
+			
+			if (--pending_ == 0)
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				idle_.notify_all();
+			}
+			
+			continue;
+		}
+		
+		std::unique_lock<std::mutex> lock{mutex_};
+		
+		if (stop_)
+			return;
+		
+		// A failed steal (because of lock contention, or because the
+		// task is counted but not yet pushed) can leave queued tasks
+		// behind, so only sleep until woken if there really are none.
+		// Otherwise, back off before trying again rather than spinning:
+		// yield a few times, then sleep for longer and longer.
+		if (queued_ == 0)
+		{
+			wake_.wait(lock, [this] { return stop_ || queued_ != 0; });
+			misses = 0;
+		}
+		else if (++misses <= 8)
+		{
+			lock.unlock();
+			std::this_thread::yield();
+		}
+		else
+		{
+			auto const shift = std::min(misses - 9, 5u);
+			wake_.wait_for(lock, std::chrono::microseconds{32 << shift});
+		}
+	}
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
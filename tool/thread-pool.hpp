@@ -0,0 +1,105 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_THREAD_POOL_
+#define INDI_INC_CRC_TOOL_THREAD_POOL_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Work-stealing thread pool.
+//! 
+//! Every worker thread has its own task queue. A worker takes tasks
+//! from the back of its own queue (so the most recently split work,
+//! which is most likely to still be in cache, is done first), and when
+//! its own queue is empty, it steals from the front of the other
+//! workers' queues (so it takes the oldest, and generally largest,
+//! pieces of work).
+//! 
+//! Tasks submitted from a worker thread go into that worker's queue.
+//! Tasks submitted from any other thread are spread round-robin over
+//! all the queues.
+//! 
+//! Tasks must not throw. If one does, `std::terminate` is called.
+class thread_pool
+{
+public:
+	using task = std::function<void()>;
+	
+	//! Starts the worker threads.
+	//! 
+	//! \param threads  The number of worker threads. If 0, one thread
+	//!     per hardware thread is started.
+	explicit thread_pool(std::size_t threads = 0);
+	
+	//! Waits for all tasks to finish, then stops the worker threads.
+	~thread_pool();
+	
+	thread_pool(thread_pool const&) = delete;
+	auto operator=(thread_pool const&) -> thread_pool& = delete;
+	
+	//! Queues a task.
+	auto submit(task t) -> void;
+	
+	//! Blocks until every submitted task (including any tasks they
+	//! submit) has finished.
+	auto wait() -> void;
+	
+	//! Gets the number of worker threads.
+	auto size() const noexcept { return threads_.size(); }
+
+private:
+	struct queue
+	{
+		std::mutex mutex;
+		std::deque<task> tasks;
+	};
+	
+	auto run(std::size_t index) -> void;
+	auto try_pop(std::size_t index, task& t) -> bool;
+	
+	std::vector<std::unique_ptr<queue>> queues_;
+	std::vector<std::thread> threads_;
+	
+	// Number of tasks sitting in queues.
+	std::atomic<std::size_t> queued_{0};
+	// Number of tasks submitted but not yet finished.
+	std::atomic<std::size_t> pending_{0};
+	// Round-robin counter for tasks from outside the pool.
+	std::atomic<std::size_t> next_{0};
+	
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	bool stop_ = false;
+};
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
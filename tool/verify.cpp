@@ -0,0 +1,393 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "verify.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "indi/crc-file.hpp"
+#include "indi/crc-hash.hpp"
+
+#include "file-task.hpp"
+#include "manifest.hpp"
+#include "thread-pool.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+// The checkpoint starts with "indi-crc-checkpoint VERSION COUNT DIGEST",
+// and then lists the index of every verified entry, one per line.
+constexpr auto checkpoint_version = 2u;
+
+// How many entries to append to the checkpoint between flushes.
+constexpr auto checkpoint_flush_interval = 256u;
+
+// Hashes every entry of a manifest, in order, so a checkpoint (which
+// refers to entries by index) is only used with the manifest it was
+// made for.
+auto digest(manifest const& m) -> std::uint64_t
+{
+	auto h = std::uint64_t{0};
+	
+	for (auto const& e : m.entries)
+	{
+		auto const name = e.crc_model->name();
+		std::uint64_t const values[] = {e.size, e.crc};
+		
+		h = hash_bytes(e.path, std::char_traits<char>::length(e.path), h);
+		h = hash_bytes(name, std::char_traits<char>::length(name), h);
+		h = hash_bytes(values, sizeof(values), h);
+	}
+	
+	return h;
+}
+
+enum class status
+{
+	ok,
+	mismatch,
+	unreadable
+};
+
+class verifier
+{
+public:
+	verifier(verify_options const& options, std::FILE* out) :
+		options_(options),
+		out_(out),
+		pool_(options.jobs),
+		// Enough to keep every worker busy, and to leave some pieces of
+		// split files for idle workers to steal.
+		max_in_flight_(4u * pool_.size())
+	{}
+	
+	~verifier()
+	{
+		if (checkpoint_)
+			std::fclose(checkpoint_);
+	}
+	
+	verifier(verifier const&) = delete;
+	auto operator=(verifier const&) -> verifier& = delete;
+	
+	auto read(std::vector<std::string> const& manifests) -> void
+	{
+		for (auto const& path : manifests)
+		{
+			auto const f = options_.detect_format ?
+				detect_format(path) : options_.manifest_format;
+			read_manifest(path, f, *options_.crc_model, manifest_);
+		}
+		
+		done_.assign(manifest_.entries.size(), false);
+		
+		if (!options_.checkpoint.empty())
+			open_checkpoint();
+	}
+	
+	auto run() -> bool
+	{
+		auto const& entries = manifest_.entries;
+		
+		// Largest first; entries without a size keep their manifest
+		// order and go last.
+		auto order = std::vector<std::size_t>{};
+		order.reserve(entries.size());
+		for (auto i = std::size_t{0}; i < entries.size(); ++i)
+		{
+			if (!done_[i])
+				order.push_back(i);
+		}
+		
+		std::stable_sort(order.begin(), order.end(),
+			[&entries](std::size_t a, std::size_t b)
+			{
+				auto const sa = entries[a].size;
+				auto const sb = entries[b].size;
+				if (sa == unknown_size || sb == unknown_size)
+					return sb == unknown_size && sa != unknown_size;
+				return sa > sb;
+			});
+		
+		for (auto const i : order)
+		{
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				slot_free_.wait(lock,
+					[this] { return in_flight_ < max_in_flight_; });
+				++in_flight_;
+			}
+			
+			if (stop_)
+				break;
+			
+			pool_.submit([this, i] { check(i); });
+		}
+		
+		pool_.wait();
+		
+		return finish();
+	}
+
+private:
+	auto check(std::size_t i) -> void
+	{
+		auto const& e = manifest_.entries[i];
+		auto const path = std::string{e.path};
+		
+		if (stop_)
+		{
+			release();
+			return;
+		}
+		
+		auto fd = file_descriptor{};
+		try
+		{
+			fd = open_file(path);
+			
+			// Catch truncated and extended files without reading them.
+			struct ::stat st;
+			if (::fstat(fd.get(), &st) != 0)
+				detail_::throw_errno(path);
+			
+			auto const size = static_cast<std::uint_least64_t>(st.st_size);
+			if (e.size != unknown_size && S_ISREG(st.st_mode) &&
+					size != e.size)
+			{
+				report(i, status::mismatch, path + ": size is " +
+					std::to_string(size) + ", expected " +
+					std::to_string(e.size));
+				return;
+			}
+		}
+		catch (std::exception const& ex)
+		{
+			report(i, status::unreadable, error_message(path, ex));
+			return;
+		}
+		
+		checksum_file(pool_, *e.crc_model, path, std::move(fd),
+			options_.split_size,
+			[this, i, &e, path](file_result&& result)
+			{
+				if (!result.error.empty())
+					report(i, status::unreadable, result.error);
+				else if (e.size != unknown_size && result.size != e.size)
+					report(i, status::mismatch, path + ": size is " +
+						std::to_string(result.size) + ", expected " +
+						std::to_string(e.size));
+				else if (result.crc != e.crc)
+					report(i, status::mismatch, path + ": CRC mismatch");
+				else
+					report(i, status::ok, {});
+			});
+	}
+	
+	auto report(std::size_t i, status s, std::string const& detail) -> void
+	{
+		auto const path = manifest_.entries[i].path;
+		
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			
+			switch (s)
+			{
+			case status::ok:
+				if (!options_.quiet)
+					std::fprintf(out_, "%s: OK\n", path);
+				record(i);
+				break;
+			case status::mismatch:
+				std::fprintf(out_, "%s: FAILED\n", path);
+				++mismatched_;
+				break;
+			case status::unreadable:
+				std::fprintf(out_, "%s: FAILED open or read\n", path);
+				++unreadable_;
+				break;
+			}
+			
+			// Failures are reported the moment they're found.
+			if (s != status::ok)
+			{
+				std::fflush(out_);
+				std::fprintf(stderr, "indi-crc: %s\n", detail.c_str());
+				if (options_.fail_fast)
+					stop_ = true;
+			}
+			
+			--in_flight_;
+		}
+		
+		slot_free_.notify_one();
+	}
+	
+	auto release() -> void
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			--in_flight_;
+		}
+		slot_free_.notify_one();
+	}
+	
+	auto finish() -> bool
+	{
+		std::fflush(out_);
+		
+		if (mismatched_ != 0)
+			std::fprintf(stderr, "indi-crc: WARNING: %zu computed %s did "
+				"NOT match\n", mismatched_,
+				mismatched_ == 1 ? "checksum" : "checksums");
+		if (unreadable_ != 0)
+			std::fprintf(stderr, "indi-crc: WARNING: %zu listed %s could "
+				"not be read\n", unreadable_,
+				unreadable_ == 1 ? "file" : "files");
+		
+		auto const ok = mismatched_ == 0 && unreadable_ == 0 && !stop_;
+		
+		if (checkpoint_)
+		{
+			auto const failed = std::fclose(checkpoint_) != 0;
+			checkpoint_ = nullptr;
+			
+			if (failed)
+				throw std::system_error{errno, std::generic_category(),
+					options_.checkpoint};
+			
+			// Everything verified, so there's nothing left to resume.
+			if (ok)
+				std::remove(options_.checkpoint.c_str());
+		}
+		
+		return ok;
+	}
+	
+	// Loads the entries a previous run verified, and opens the
+	// checkpoint for appending. A checkpoint for a different manifest
+	// (one with a different digest) is ignored and started again.
+	auto open_checkpoint() -> void
+	{
+		auto const& path = options_.checkpoint;
+		auto const count = manifest_.entries.size();
+		auto const hash = digest(manifest_);
+		auto valid = false;
+		
+		if (auto const f = std::fopen(path.c_str(), "r"))
+		{
+			auto version = 0u;
+			auto n = 0uLL;
+			auto h = 0uLL;
+			if (std::fscanf(f, "indi-crc-checkpoint %u %llu %llx", &version,
+					&n, &h) == 3 && version == checkpoint_version &&
+					n == count && h == hash)
+			{
+				valid = true;
+				
+				// A partly written last line is just ignored.
+				auto i = 0uLL;
+				while (std::fscanf(f, "%llu", &i) == 1)
+				{
+					if (i < count)
+						done_[static_cast<std::size_t>(i)] = true;
+				}
+			}
+			else
+			{
+				std::fprintf(stderr, "indi-crc: %s is not a checkpoint for "
+					"this manifest; starting again\n", path.c_str());
+			}
+			std::fclose(f);
+		}
+		
+		checkpoint_ = std::fopen(path.c_str(), valid ? "a" : "w");
+		if (!checkpoint_)
+			throw std::system_error{errno, std::generic_category(), path};
+		
+		if (valid)
+		{
+			// Start on a fresh line, in case the last one was cut off.
+			std::fputc('\n', checkpoint_);
+		}
+		else
+		{
+			std::fprintf(checkpoint_, "indi-crc-checkpoint %u %llu %016llx\n",
+				checkpoint_version, static_cast<unsigned long long>(count),
+				static_cast<unsigned long long>(hash));
+		}
+		std::fflush(checkpoint_);
+	}
+	
+	// Called with the mutex held.
+	auto record(std::size_t i) -> void
+	{
+		if (!checkpoint_)
+			return;
+		
+		std::fprintf(checkpoint_, "%llu\n", static_cast<unsigned long long>(i));
+		if (++unflushed_ == checkpoint_flush_interval)
+		{
+			std::fflush(checkpoint_);
+			unflushed_ = 0;
+		}
+	}
+	
+	verify_options const& options_;
+	std::FILE* out_;
+	manifest manifest_;
+	std::vector<bool> done_;
+	
+	std::mutex mutex_;
+	std::condition_variable slot_free_;
+	std::size_t in_flight_ = 0;
+	std::size_t mismatched_ = 0;
+	std::size_t unreadable_ = 0;
+	std::atomic<bool> stop_{false};
+	
+	std::FILE* checkpoint_ = nullptr;
+	unsigned unflushed_ = 0;
+	
+	thread_pool pool_;
+	std::size_t const max_in_flight_;
+};
+
+} // anonymous namespace
+
+auto verify(std::vector<std::string> const& manifests,
+	verify_options const& options, std::FILE* out) -> bool
+{
+	verifier v{options, out};
+	v.read(manifests);
+	return v.run();
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
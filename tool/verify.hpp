@@ -0,0 +1,88 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_VERIFY_
+#define INDI_INC_CRC_TOOL_VERIFY_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "models.hpp"
+#include "output.hpp"
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+struct verify_options
+{
+	//! The CRC model for manifests that don't name one.
+	model const* crc_model = nullptr;
+	
+	//! The manifest format. If `detect_format` is set, this is ignored
+	//! and the format of each manifest is guessed.
+	format manifest_format = format::cksum;
+	bool detect_format = true;
+	
+	//! The number of worker threads (0 means one per hardware thread).
+	std::size_t jobs = 0;
+	
+	//! The size files are split at (see `checksum_options`).
+	std::uint_least64_t split_size = 0;
+	
+	//! Stop at the first file that fails.
+	bool fail_fast = false;
+	
+	//! Don't print a line for every file that is OK.
+	bool quiet = false;
+	
+	//! A file recording which entries have already been verified, so an
+	//! interrupted run can be resumed. Empty means none.
+	std::string checkpoint;
+};
+
+//! Verifies files against one or more manifests.
+//! 
+//! The files are checked roughly largest first, so the longest jobs start
+//! early and the work finishes evenly across the threads, and each
+//! result is written to `out` as soon as it is known, rather than in
+//! manifest order. A file whose size doesn't match the manifest fails
+//! straight away, without being read.
+//! 
+//! Only a bounded number of files are in flight at once, so memory use
+//! doesn't grow with the size of the manifest.
+//! 
+//! If a checkpoint file is given, every entry that verifies is
+//! appended to it, entries already in it are skipped, and it is
+//! removed once every entry has verified. The checkpoint records a
+//! digest of the manifest entries, and one made for different manifests
+//! is ignored and started again.
+//! 
+//! \throws std::system_error or std::runtime_error if a manifest or the
+//!     checkpoint could not be read.
+//! 
+//! \returns True if every file matched.
+auto verify(std::vector<std::string> const& manifests,
+	verify_options const& options, std::FILE* out) -> bool;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard
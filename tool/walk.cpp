@@ -0,0 +1,148 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "walk.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+namespace {
+
+enum class kind { file, directory, other };
+
+auto classify(mode_t mode)
+{
+	if (S_ISREG(mode))
+		return kind::file;
+	if (S_ISDIR(mode))
+		return kind::directory;
+	return kind::other;
+}
+
+auto join(std::string const& dir, char const* name)
+{
+	auto path = dir;
+	if (path.empty() || path.back() != '/')
+		path += '/';
+	path += name;
+	return path;
+}
+
+auto walk_directory(std::string const& path,
+	std::function<void(std::string const&)> const& on_file,
+	std::function<void(std::string const&, int)> const& on_error) -> void
+{
+	auto const dir = ::opendir(path.c_str());
+	if (!dir)
+	{
+		on_error(path, errno);
+		return;
+	}
+	
+	struct entry
+	{
+		std::string name;
+		kind type;
+	};
+	
+	auto entries = std::vector<entry>{};
+	
+	// A null from `readdir` is an error only if it set errno, and the
+	// `lstat` below can set errno too, so it is cleared before each call.
+	for (;;)
+	{
+		errno = 0;
+		auto const e = ::readdir(dir);
+		if (!e)
+			break;
+		
+		if (std::strcmp(e->d_name, ".") == 0 ||
+				std::strcmp(e->d_name, "..") == 0)
+			continue;
+		
+		auto type = kind::other;
+		
+		switch (e->d_type)
+		{
+		case DT_REG: type = kind::file; break;
+		case DT_DIR: type = kind::directory; break;
+		case DT_UNKNOWN:
+		{
+			// Not all file systems fill in d_type.
+			struct ::stat st;
+			if (::lstat(join(path, e->d_name).c_str(), &st) == 0)
+				type = classify(st.st_mode);
+			break;
+		}
+		default: break;
+		}
+		
+		if (type != kind::other)
+			entries.push_back(entry{e->d_name, type});
+	}
+	
+	auto const error = errno;
+	::closedir(dir);
+	
+	if (error != 0)
+		on_error(path, error);
+	
+	std::sort(entries.begin(), entries.end(),
+		[](auto const& a, auto const& b) { return a.name < b.name; });
+	
+	for (auto const& e : entries)
+	{
+		auto const child = join(path, e.name.c_str());
+		if (e.type == kind::file)
+			on_file(child);
+		else
+			walk_directory(child, on_file, on_error);
+	}
+}
+
+} // anonymous namespace
+
+auto walk(std::string const& path,
+	std::function<void(std::string const&)> const& on_file,
+	std::function<void(std::string const&, int)> const& on_error) -> void
+{
+	struct ::stat st;
+	if (::stat(path.c_str(), &st) != 0)
+	{
+		on_error(path, errno);
+		return;
+	}
+	
+	// Anything named explicitly that is not a directory is treated as a
+	// file, so things like named pipes can be checksummed too.
+	if (classify(st.st_mode) == kind::directory)
+		walk_directory(path, on_file, on_error);
+	else
+		on_file(path);
+}
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
@@ -0,0 +1,50 @@
+/* This file is part of indi-crc.
+ * 
+ * indi-crc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * indi-crc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with indi-crc.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDI_INC_CRC_TOOL_WALK_
+#define INDI_INC_CRC_TOOL_WALK_
+
+#include <functional>
+#include <string>
+
+namespace indi {
+namespace crc {
+namespace tool {
+
+//! Walks a path, reporting every regular file found.
+//! 
+//! If `path` is a directory, it is walked recursively, and the entries
+//! of every directory are visited in byte-wise name order, so the
+//! order files are reported in is deterministic. Symbolic links inside
+//! directories are not followed, and only regular files inside
+//! directories are reported. `path` itself is always followed, and is
+//! reported if it is anything other than a directory.
+//! 
+//! Anything that cannot be read is reported to `on_error` with the
+//! path and the `errno` value, and the walk carries on.
+//! 
+//! \param path  The path to walk.
+//! \param on_file  Called with the path of every regular file found.
+//! \param on_error  Called with the path and `errno` of every error.
+auto walk(std::string const& path,
+	std::function<void(std::string const&)> const& on_file,
+	std::function<void(std::string const&, int)> const& on_error) -> void;
+
+} // namespace tool
+} // namespace crc
+} // namespace indi
+
+#endif // include guard